@@ -0,0 +1,154 @@
+
+#pragma once
+
+#include "Data/Latency.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <ctime>
+#include <mutex>
+
+namespace bench
+{
+    /**
+     * @brief Clock of the latency samples, shared by every Manager of the process
+     */
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Get the current time of the sample clock in nanoseconds, to be written in a packet
+     *
+     * @return std::int64_t The time since the epoch of the clock
+     */
+    inline std::int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    class Samples
+    {
+        public:
+            /**
+             * @brief Record a latency (safe to call from any thread)
+             *
+             * @param nanoseconds The latency
+             */
+            void record(std::int64_t nanoseconds)
+            {
+                std::scoped_lock lock(mutex_);
+
+                values_.push_back(std::max<std::int64_t>(nanoseconds, 0));
+            }
+
+            /**
+             * @brief Compute the exact distribution of the samples
+             *
+             * @return glnet::LatencyStats The count, extremes, mean and percentiles
+             */
+            glnet::LatencyStats getStats()
+            {
+                std::scoped_lock lock(mutex_);
+                glnet::LatencyStats stats;
+
+                if (values_.empty()) {
+                    return stats;
+                }
+                std::sort(values_.begin(), values_.end());
+                auto at = [this](double quantile) {
+                    return std::chrono::nanoseconds(values_[std::min(values_.size() - 1, static_cast<std::size_t>(quantile * static_cast<double>(values_.size())))]);
+                };
+                std::int64_t sum = 0;
+
+                for (std::int64_t value : values_) {
+                    sum += value;
+                }
+                stats.count = values_.size();
+                stats.min = std::chrono::nanoseconds(values_.front());
+                stats.max = std::chrono::nanoseconds(values_.back());
+                stats.mean = std::chrono::nanoseconds(sum / static_cast<std::int64_t>(values_.size()));
+                stats.p50 = at(0.5);
+                stats.p90 = at(0.9);
+                stats.p99 = at(0.99);
+                stats.p999 = at(0.999);
+                return stats;
+            }
+
+        private:
+            std::vector<std::int64_t> values_; /*!> The latencies, in nanoseconds */
+            std::mutex mutex_;                 /*!> Guard of the latencies */
+    };
+
+    /**
+     * @struct Result
+     * @brief Represent the outcome of a scenario
+     */
+    struct Result {
+            std::string scenario;        /*!> The name of the scenario */
+            std::uint64_t messages = 0;  /*!> The number of messages (or connections) completed */
+            std::uint64_t lost = 0;      /*!> The number of messages sent and never received */
+            double seconds = 0;          /*!> The wall time of the measured part */
+            double cpuSeconds = 0;       /*!> The processor time of every thread over the measured part */
+            glnet::LatencyStats latency; /*!> The latency of the messages (or connections) */
+            bool completed = false;      /*!> If the scenario finished before its timeout */
+    };
+
+    class Stopwatch
+    {
+        public:
+            /**
+             * @brief Construct a new Stopwatch object, started
+             */
+            Stopwatch() : wall_(Clock::now()), cpu_(std::clock())
+            {
+            }
+
+            /**
+             * @brief Fill the wall and processor times elapsed since the construction
+             *
+             * @param result The result to fill
+             */
+            void stop(Result& result) const
+            {
+                result.seconds = std::chrono::duration<double>(Clock::now() - wall_).count();
+                result.cpuSeconds = static_cast<double>(std::clock() - cpu_) / CLOCKS_PER_SEC;
+            }
+
+        private:
+            Clock::time_point wall_; /*!> The wall time at the start */
+            std::clock_t cpu_;       /*!> The processor time at the start */
+    };
+
+    /**
+     * @brief Write a result as a line of JSON
+     *
+     * @param out The stream to write to
+     * @param result The result to write
+     */
+    inline void report(std::ostream& out, const Result& result)
+    {
+        std::ostringstream line;
+        double messages = static_cast<double>(std::max<std::uint64_t>(result.messages, 1));
+
+        line << std::fixed << std::setprecision(1);
+        line << "{\"scenario\":\"" << result.scenario << "\"";
+        line << ",\"completed\":" << (result.completed ? "true" : "false");
+        line << ",\"messages\":" << result.messages;
+        line << ",\"lost\":" << result.lost;
+        line << ",\"seconds\":" << std::setprecision(4) << result.seconds << std::setprecision(1);
+        line << ",\"msgs_per_sec\":" << (result.seconds > 0 ? static_cast<double>(result.messages) / result.seconds : 0);
+        line << ",\"cpu_ns_per_msg\":" << result.cpuSeconds * 1e9 / messages;
+        line << ",\"p50_ns\":" << result.latency.p50.count();
+        line << ",\"p99_ns\":" << result.latency.p99.count();
+        line << ",\"p999_ns\":" << result.latency.p999.count();
+        line << ",\"max_ns\":" << result.latency.max.count();
+        line << ",\"mean_ns\":" << result.latency.mean.count();
+        line << "}";
+        out << line.str() << std::endl;
+    }
+}
@@ -0,0 +1,397 @@
+
+#include "Data/Packet.hpp"
+#include "Manager.hpp"
+#include "Report.hpp"
+
+#include <functional>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+#include <mutex>
+
+using glnet::connection::SendResult;
+using glnet::connection::Side;
+using glnet::connection::Type;
+
+struct Options {
+    std::vector<std::string> scenarios;     // The scenarios to run, all of them when empty
+    std::uint64_t messages = 20000;         // The number of messages sent by each scenario
+    std::size_t size = 64;                  // The payload size of a message
+    std::uint32_t clients = 16;             // The number of clients of the broadcast scenario
+    std::uint64_t cycles = 200;             // The number of connections of the churn scenario
+    std::uint16_t port = 9600;              // The first port, each scenario listens on its own
+    std::chrono::seconds timeout{30};       // The time after which an unfinished scenario is reported as incomplete
+};
+
+// Wait for a condition set by the I/O threads, false on timeout
+static bool waitFor(const std::function<bool()>& done, std::chrono::steady_clock::duration timeout)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    while (!done()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    return true;
+}
+
+static glnet::Packet makeMessage(const std::string& payload)
+{
+    glnet::Packet packet;
+
+    packet << bench::now() << payload;
+    return packet;
+}
+
+static std::int64_t readTimestamp(glnet::Packet& packet)
+{
+    std::int64_t sent = 0;
+
+    packet >> sent;
+    return sent;
+}
+
+// Send over a congestion-aware connection, waiting for room instead of dropping the message
+static bool sendPaced(glnet::Manager& client, Type type, const std::string& payload, std::atomic<bool>& congested, std::chrono::seconds timeout)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    while (std::chrono::steady_clock::now() < deadline) {
+        glnet::Packet packet = makeMessage(payload);
+        SendResult result = client.sendToServer(type, packet);
+
+        if (result == SendResult::QUEUED) {
+            return true;
+        }
+        if (result == SendResult::CONGESTED) {
+            waitFor([&] { return !congested.load(); }, timeout);
+            return true;
+        }
+        std::this_thread::yield();
+    }
+    return false;
+}
+
+// Connect a threaded client to the local server, false on timeout
+static bool connectClient(glnet::Manager& client, std::uint16_t port, bool udp, std::atomic<std::uint64_t>& connections, std::chrono::seconds timeout)
+{
+    std::uint64_t before = connections;
+
+    client.callbacks().setOnConnection([&connections](std::uint32_t) { ++connections; });
+    client.initialize(Side::CLIENT);
+    client.setServerEndpoint({LOCALHOST, port});
+    client.createConnection(Type::TCP);
+    if (udp) {
+        client.createConnection(Type::UDP);
+    }
+    client.connectToServer();
+    return waitFor([&] { return connections.load() > before; }, timeout);
+}
+
+// Round trip of one message at a time: the client sends the next message when the echo comes back
+static bench::Result tcpPingPong(const Options& options, std::uint16_t port)
+{
+    bench::Result result{.scenario = "tcp_pingpong"};
+    bench::Samples samples;
+    std::atomic<std::uint64_t> connections = 0;
+    std::atomic<std::uint64_t> received = 0;
+    std::string payload(options.size, 'x');
+    glnet::Manager server;
+    glnet::Manager client;
+
+    server.callbacks().setOnMessageReception([&server](Type, std::uint32_t id, glnet::Packet& packet) {
+        std::int64_t sent = readTimestamp(packet);
+        std::string payload;
+        glnet::Packet echo;
+
+        packet >> payload;
+        echo << sent << payload;
+        server.sendToClients(Type::TCP, {id}, echo);
+    });
+    server.initialize(Side::SERVER);
+    server.createConnection(Type::TCP, {LOCALHOST, port});
+    client.callbacks().setOnMessageReception([&](Type, std::uint32_t, glnet::Packet& packet) {
+        samples.record(bench::now() - readTimestamp(packet));
+        if (++received < options.messages) {
+            glnet::Packet next = makeMessage(payload);
+
+            client.sendToServer(Type::TCP, next);
+        }
+    });
+    if (!connectClient(client, port, false, connections, options.timeout)) {
+        return result;
+    }
+    bench::Stopwatch stopwatch;
+    glnet::Packet first = makeMessage(payload);
+
+    client.sendToServer(Type::TCP, first);
+    result.completed = waitFor([&] { return received.load() >= options.messages; }, options.timeout);
+    stopwatch.stop(result);
+    result.messages = received;
+    result.lost = options.messages - std::min(options.messages, result.messages);
+    result.latency = samples.getStats();
+    return result;
+}
+
+// One-way latency and throughput of a client streaming as fast as the backpressure allows
+static bench::Result tcpStream(const Options& options, std::uint16_t port)
+{
+    bench::Result result{.scenario = "tcp_stream"};
+    bench::Samples samples;
+    std::atomic<std::uint64_t> connections = 0;
+    std::atomic<bool> congested = false;
+    std::atomic<std::uint64_t> received = 0;
+    std::string payload(options.size, 'x');
+    glnet::Manager server;
+    glnet::Manager client;
+
+    server.callbacks().setOnMessageReception([&](Type, std::uint32_t, glnet::Packet& packet) {
+        samples.record(bench::now() - readTimestamp(packet));
+        ++received;
+    });
+    server.initialize(Side::SERVER);
+    server.createConnection(Type::TCP, {LOCALHOST, port});
+    client.callbacks().setOnBackpressure([&congested](std::uint32_t) { congested = true; });
+    client.callbacks().setOnWritable([&congested](std::uint32_t) { congested = false; });
+    if (!connectClient(client, port, false, connections, options.timeout)) {
+        return result;
+    }
+    bench::Stopwatch stopwatch;
+
+    for (std::uint64_t i = 0; i < options.messages; i++) {
+        if (!sendPaced(client, Type::TCP, payload, congested, options.timeout)) {
+            break;
+        }
+    }
+    result.completed = waitFor([&] { return received.load() >= options.messages; }, options.timeout);
+    stopwatch.stop(result);
+    result.messages = received;
+    result.lost = options.messages - std::min(options.messages, result.messages);
+    result.latency = samples.getStats();
+    return result;
+}
+
+// Unreliable datagrams sent as fast as the send ring accepts them, losses included in the report
+static bench::Result udpPps(const Options& options, std::uint16_t port)
+{
+    bench::Result result{.scenario = "udp_pps"};
+    bench::Samples samples;
+    std::atomic<std::uint64_t> connections = 0;
+    std::atomic<bool> congested = false;
+    std::atomic<std::uint64_t> received = 0;
+    std::atomic<std::int64_t> lastReceived = 0;
+    std::string payload(options.size, 'x');
+    glnet::Manager server;
+    glnet::Manager client;
+
+    server.callbacks().setOnMessageReception([&](Type, std::uint32_t, glnet::Packet& packet) {
+        std::int64_t now = bench::now();
+
+        samples.record(now - readTimestamp(packet));
+        lastReceived = now;
+        ++received;
+    });
+    server.initialize(Side::SERVER);
+    server.createConnection(Type::TCP, {LOCALHOST, port});
+    server.createConnection(Type::UDP, {LOCALHOST, port});
+    if (!connectClient(client, port, true, connections, options.timeout)) {
+        return result;
+    }
+    bench::Stopwatch stopwatch;
+    std::int64_t start = bench::now();
+
+    for (std::uint64_t i = 0; i < options.messages; i++) {
+        if (!sendPaced(client, Type::UDP, payload, congested, options.timeout)) {
+            break;
+        }
+    }
+    // Datagrams are never retransmitted: stop once the counter settles
+    std::uint64_t last = 0;
+
+    result.completed = true;
+    while (received.load() < options.messages) {
+        last = received;
+        if (waitFor([&] { return received.load() != last; }, std::chrono::milliseconds(200))) {
+            continue;
+        }
+        break;
+    }
+    stopwatch.stop(result);
+    // The settling wait is not part of the throughput
+    result.seconds = std::max<std::int64_t>(lastReceived - start, 0) / 1e9;
+    result.messages = received;
+    result.lost = options.messages - std::min(options.messages, result.messages);
+    result.latency = samples.getStats();
+    return result;
+}
+
+// The server sends every message to every client, pacing on the bytes still queued
+static bench::Result broadcast(const Options& options, std::uint16_t port)
+{
+    bench::Result result{.scenario = "broadcast"};
+    bench::Samples samples;
+    std::vector<std::uint32_t> ids;
+    std::mutex idsMutex;
+    std::atomic<std::uint64_t> connections = 0;
+    std::atomic<std::uint64_t> received = 0;
+    std::uint64_t expected = options.messages * options.clients;
+    std::string payload(options.size, 'x');
+    glnet::Manager server;
+    std::vector<std::unique_ptr<glnet::Manager>> clients;
+
+    server.callbacks().setOnConnection([&](std::uint32_t id) {
+        std::scoped_lock lock(idsMutex);
+
+        ids.push_back(id);
+    });
+    server.initialize(Side::SERVER);
+    server.createConnection(Type::TCP, {LOCALHOST, port});
+    for (std::uint32_t i = 0; i < options.clients; i++) {
+        auto client = std::make_unique<glnet::Manager>();
+
+        client->callbacks().setOnMessageReception([&](Type, std::uint32_t, glnet::Packet& packet) {
+            samples.record(bench::now() - readTimestamp(packet));
+            ++received;
+        });
+        if (!connectClient(*client, port, false, connections, options.timeout)) {
+            return result;
+        }
+        clients.push_back(std::move(client));
+    }
+    if (!waitFor([&] { std::scoped_lock lock(idsMutex); return ids.size() == options.clients; }, options.timeout)) {
+        return result;
+    }
+    bench::Stopwatch stopwatch;
+    std::size_t limit = glnet::Watermarks{}.low * options.clients;
+
+    // A failed fan-out does not tell which clients were skipped, so each client is sent to and retried on its own
+    for (std::uint64_t i = 0; i < options.messages; i++) {
+        glnet::Packet packet = makeMessage(payload);
+        bool congested = false;
+
+        for (std::uint32_t id : ids) {
+            SendResult sent = server.sendToClients(Type::TCP, {id}, packet);
+
+            while (sent == SendResult::FAILED) {
+                std::this_thread::yield();
+                sent = server.sendToClients(Type::TCP, {id}, packet);
+            }
+            congested |= sent == SendResult::CONGESTED;
+        }
+        if (congested) {
+            waitFor([&] { return server.getMetrics().tcp.total.queuedBytes < limit; }, options.timeout);
+        }
+    }
+    result.completed = waitFor([&] { return received.load() >= expected; }, options.timeout);
+    stopwatch.stop(result);
+    result.messages = received;
+    result.lost = expected - std::min(expected, result.messages);
+    result.latency = samples.getStats();
+    return result;
+}
+
+// Connect and tear down a client per cycle, the latency being the time to the connection callback
+static bench::Result churn(const Options& options, std::uint16_t port)
+{
+    bench::Result result{.scenario = "churn"};
+    bench::Samples samples;
+    std::atomic<std::uint64_t> connections = 0;
+    std::atomic<std::uint64_t> disconnected = 0;
+    glnet::Manager server;
+
+    server.callbacks().setOnDisconnection([&disconnected](std::uint32_t) { ++disconnected; });
+    server.initialize(Side::SERVER);
+    server.createConnection(Type::TCP, {LOCALHOST, port});
+    bench::Stopwatch stopwatch;
+
+    for (std::uint64_t i = 0; i < options.cycles; i++) {
+        auto client = std::make_unique<glnet::Manager>();
+        std::int64_t start = bench::now();
+
+        if (!connectClient(*client, port, false, connections, options.timeout)) {
+            break;
+        }
+        samples.record(bench::now() - start);
+        result.messages++;
+    }
+    result.completed = waitFor([&] { return disconnected.load() >= result.messages; }, options.timeout) && result.messages == options.cycles;
+    stopwatch.stop(result);
+    result.lost = options.cycles - result.messages;
+    result.latency = samples.getStats();
+    return result;
+}
+
+static void usage(const char *name)
+{
+    std::cerr << "Usage: " << name << " [--scenario NAME]... [--messages N] [--size BYTES] [--clients N] [--cycles N] [--port PORT] [--timeout SECONDS]" << std::endl;
+    std::cerr << "Scenarios: tcp_pingpong, tcp_stream, udp_pps, broadcast, churn (all by default)" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    using Scenario = bench::Result (*)(const Options&, std::uint16_t);
+    const std::vector<std::pair<std::string, Scenario>> scenarios = {
+        {"tcp_pingpong", tcpPingPong},
+        {"tcp_stream", tcpStream},
+        {"udp_pps", udpPps},
+        {"broadcast", broadcast},
+        {"churn", churn},
+    };
+    Options options;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+
+            if (arg == "--help" || i + 1 >= argc) {
+                usage(argv[0]);
+                return arg == "--help" ? 0 : 1;
+            }
+            std::string value = argv[++i];
+
+            if (arg == "--scenario") {
+                options.scenarios.push_back(value);
+            } else if (arg == "--messages") {
+                options.messages = std::stoull(value);
+            } else if (arg == "--size") {
+                options.size = std::stoul(value);
+            } else if (arg == "--clients") {
+                options.clients = std::stoul(value);
+            } else if (arg == "--cycles") {
+                options.cycles = std::stoull(value);
+            } else if (arg == "--port") {
+                options.port = static_cast<std::uint16_t>(std::stoul(value));
+            } else if (arg == "--timeout") {
+                options.timeout = std::chrono::seconds(std::stoul(value));
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        usage(argv[0]);
+        return 1;
+    }
+
+    bool failed = false;
+
+    for (std::size_t i = 0; i < scenarios.size(); i++) {
+        const auto& [name, scenario] = scenarios[i];
+
+        if (!options.scenarios.empty() && std::find(options.scenarios.begin(), options.scenarios.end(), name) == options.scenarios.end()) {
+            continue;
+        }
+        bench::Result result = scenario(options, static_cast<std::uint16_t>(options.port + i));
+
+        bench::report(std::cout, result);
+        failed |= !result.completed;
+    }
+    return failed ? 1 : 0;
+}
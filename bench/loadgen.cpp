@@ -0,0 +1,329 @@
+
+#include "../example/shared/Message.hpp"
+#include "../example/shared/Player.hpp"
+#include "Data/Packet.hpp"
+#include "ClientPool.hpp"
+#include "Manager.hpp"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include <functional>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <csignal>
+#include <random>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <string>
+#include <queue>
+
+using glnet::connection::Delivery;
+using glnet::connection::Priority;
+using glnet::connection::SendResult;
+using glnet::connection::Side;
+using glnet::connection::Type;
+using Clock = std::chrono::steady_clock;
+
+// The traffic of every simulated client during a phase
+struct Profile {
+    std::string name;                    // The name given to --phase
+    double updateRate;                   // Position updates per second, over udp (0 for none)
+    std::chrono::milliseconds chatEvery; // Mean time between two chat messages, over tcp (0 for none)
+};
+
+static const std::vector<Profile> PROFILES = {
+    {"idle", 0, std::chrono::milliseconds(0)},
+    {"lobby", 1, std::chrono::milliseconds(10000)},
+    {"game", 20, std::chrono::milliseconds(30000)},
+    {"action", 60, std::chrono::milliseconds(5000)},
+};
+
+struct Phase {
+    Profile profile;
+    std::chrono::seconds duration;
+};
+
+struct Options {
+    glnet::Endpoint server{LOCALHOST, 8080};    // The server to load
+    std::size_t clients = 1000;                 // The number of simulated clients
+    double rampRate = 500;                      // The clients opened per second until all of them are
+    std::vector<Phase> phases;                  // The profiles played one after the other once every client is opened
+    std::chrono::milliseconds statsEvery{1000}; // The interval of the live stats
+    bool serve = false;                         // Run a glnet server in the process instead of loading an external one
+};
+
+// A send due at a given time
+struct Event {
+    Clock::time_point at;
+    glnet::ClientPool::Id id;
+    bool chat;
+
+    bool operator>(const Event& other) const
+    {
+        return at > other.at;
+    }
+};
+
+using EventQueue = std::priority_queue<Event, std::vector<Event>, std::greater<Event>>;
+
+// The counters of the live stats, reset at each report
+struct Stats {
+    std::uint64_t updates = 0;
+    std::uint64_t chats = 0;
+    std::uint64_t failedSends = 0;
+    std::uint64_t connected = 0;
+    std::uint64_t connectFailures = 0;
+    std::uint64_t disconnections = 0;
+    std::uint64_t received = 0;
+};
+
+static volatile std::sig_atomic_t interrupted = 0;
+
+static void usage(const char *name)
+{
+    std::cerr << "Usage: " << name << " [--host HOST] [--port PORT] [--clients N] [--ramp CLIENTS_PER_SECOND] [--phase PROFILE:SECONDS]... [--stats MILLISECONDS] [--serve]" << std::endl;
+    std::cerr << "Profiles: idle, lobby (1 Hz), game (20 Hz), action (60 Hz); default phase game:30" << std::endl;
+}
+
+static Phase parsePhase(const std::string& value)
+{
+    std::size_t colon = value.find(':');
+    std::string name = value.substr(0, colon);
+    auto profile = std::find_if(PROFILES.begin(), PROFILES.end(), [&name](const Profile& p) { return p.name == name; });
+
+    if (profile == PROFILES.end() || colon == std::string::npos) {
+        throw std::runtime_error("Unknown phase " + value);
+    }
+    return {*profile, std::chrono::seconds(std::stoul(value.substr(colon + 1)))};
+}
+
+static void raiseFileLimit()
+{
+#ifndef _WIN32
+    struct rlimit limit = {0, 0};
+
+    // Each client holds a tcp and an udp socket
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+#endif
+}
+
+// Spread the first send of a client over one interval, so that the clients do not all send at once
+static Clock::time_point firstSend(Clock::time_point now, std::chrono::nanoseconds interval, std::mt19937& random)
+{
+    return now + std::chrono::nanoseconds(std::uniform_int_distribution<std::int64_t>(0, interval.count())(random));
+}
+
+static std::chrono::nanoseconds updateInterval(const Profile& profile)
+{
+    return std::chrono::nanoseconds(static_cast<std::int64_t>(1e9 / profile.updateRate));
+}
+
+// Chats follow an exponential law around their mean interval
+static std::chrono::nanoseconds chatInterval(const Profile& profile, std::mt19937& random)
+{
+    double mean = std::chrono::duration<double>(profile.chatEvery).count();
+
+    return std::chrono::nanoseconds(static_cast<std::int64_t>(std::exponential_distribution<double>(1 / mean)(random) * 1e9));
+}
+
+static void schedule(EventQueue& events, const Profile& profile, glnet::ClientPool::Id id, Clock::time_point now, std::mt19937& random)
+{
+    if (profile.updateRate > 0) {
+        events.push({firstSend(now, updateInterval(profile), random), id, false});
+    }
+    if (profile.chatEvery.count() > 0) {
+        events.push({now + chatInterval(profile, random), id, true});
+    }
+}
+
+static void report(double elapsed, const std::string& phase, const glnet::ClientPool& pool, const Stats& stats, const glnet::TrafficMetrics& traffic, double seconds)
+{
+    std::ostringstream line;
+
+    line << std::fixed << std::setprecision(1);
+    line << "[" << elapsed << "s] " << phase;
+    line << " clients=" << pool.getConnectedCount() << "/" << pool.size();
+    line << " connects=" << stats.connected << " failures=" << stats.connectFailures << " drops=" << stats.disconnections;
+    line << " updates/s=" << stats.updates / seconds << " chats/s=" << stats.chats / seconds << " failed/s=" << stats.failedSends / seconds;
+    line << " out=" << traffic.bytesOut / seconds / 1024 << "KiB/s in=" << traffic.bytesIn / seconds / 1024 << "KiB/s queued=" << traffic.queuedBytes;
+    if (stats.received != 0) {
+        line << " server=" << stats.received / seconds << "msg/s";
+    }
+    std::cout << line.str() << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+
+            if (arg == "--serve") {
+                options.serve = true;
+                continue;
+            }
+            if (arg == "--help" || i + 1 >= argc) {
+                usage(argv[0]);
+                return arg == "--help" ? 0 : 1;
+            }
+            std::string value = argv[++i];
+
+            if (arg == "--host") {
+                options.server.address = value;
+            } else if (arg == "--port") {
+                options.server.port = static_cast<std::uint16_t>(std::stoul(value));
+            } else if (arg == "--clients") {
+                options.clients = std::stoul(value);
+            } else if (arg == "--ramp") {
+                options.rampRate = std::stod(value);
+            } else if (arg == "--phase") {
+                options.phases.push_back(parsePhase(value));
+            } else if (arg == "--stats") {
+                options.statsEvery = std::chrono::milliseconds(std::stoul(value));
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        usage(argv[0]);
+        return 1;
+    }
+    if (options.phases.empty()) {
+        options.phases.push_back(parsePhase("game:30"));
+    }
+    raiseFileLimit();
+    std::signal(SIGINT, [](int) { interrupted = 1; });
+
+    // The optional in-process server only counts what it receives
+    std::atomic<std::uint64_t> serverReceived = 0;
+    std::unique_ptr<glnet::Manager> server;
+
+    if (options.serve) {
+        server = std::make_unique<glnet::Manager>();
+        server->callbacks().setOnMessageReception([&serverReceived](Type, std::uint32_t, glnet::Packet&) { ++serverReceived; });
+        server->initialize(Side::SERVER);
+        server->createConnection(Type::TCP, options.server);
+        server->createConnection(Type::UDP, options.server);
+    }
+
+    glnet::ClientPool pool(options.server);
+    std::mt19937 random(std::random_device{}());
+    EventQueue events;
+    Stats stats;
+    std::size_t phase = 0;
+    bool ramping = true;
+    Clock::time_point start = Clock::now();
+    Clock::time_point phaseEnd = Clock::time_point::max();
+    Clock::time_point lastReport = start;
+    glnet::TrafficMetrics lastTraffic;
+    std::uint64_t lastServerReceived = 0;
+    std::size_t opened = 0;
+
+    pool.callbacks().setOnConnection([&](std::uint32_t id) {
+        stats.connected++;
+        schedule(events, options.phases[phase].profile, id, Clock::now(), random);
+    });
+    pool.callbacks().setOnConnectionFailure([&stats](std::uint32_t) { stats.connectFailures++; });
+    pool.callbacks().setOnDisconnection([&stats](std::uint32_t) { stats.disconnections++; });
+
+    while (!interrupted && phase < options.phases.size()) {
+        Clock::time_point now = Clock::now();
+
+        // Ramp-up: open the clients due by now, then start the first phase once every one is opened
+        if (ramping) {
+            std::size_t due = std::min(options.clients, static_cast<std::size_t>(std::chrono::duration<double>(now - start).count() * options.rampRate) + 1);
+
+            for (; opened < due; opened++) {
+                try {
+                    pool.add();
+                } catch (const std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    stats.connectFailures++;
+                }
+            }
+            if (opened == options.clients) {
+                ramping = false;
+                phaseEnd = now + options.phases[phase].duration;
+            }
+        } else if (now >= phaseEnd) {
+            if (++phase == options.phases.size()) {
+                break;
+            }
+            phaseEnd = now + options.phases[phase].duration;
+            events = EventQueue();
+            for (glnet::ClientPool::Id id = 0; id < opened; id++) {
+                if (pool.isConnected(id)) {
+                    schedule(events, options.phases[phase].profile, id, now, random);
+                }
+            }
+        }
+
+        // Play the sends due by now, each rescheduling the next one of its client
+        const Profile& profile = options.phases[phase].profile;
+
+        while (!events.empty() && events.top().at <= now) {
+            Event event = events.top();
+            glnet::Packet packet;
+            SendResult result = SendResult::FAILED;
+
+            events.pop();
+            if (event.chat) {
+                packet << glnet::message::Type::CHAT_MESSAGE << "Push the B site !";
+                result = pool.send(event.id, Type::TCP, packet);
+                event.at += chatInterval(profile, random);
+                stats.chats++;
+            } else {
+                Player::Position position{static_cast<float>(event.id), 20.02f, 5.0f};
+
+                packet << glnet::message::Type::PLAYER_POSITION << position;
+                result = pool.send(event.id, Type::UDP, packet, {.delivery = Delivery::UNRELIABLE_SEQUENCED, .priority = Priority::REALTIME});
+                event.at += updateInterval(profile);
+                stats.updates++;
+            }
+            if (result == SendResult::FAILED) {
+                stats.failedSends++;
+                if (!pool.isConnected(event.id)) {
+                    continue;
+                }
+            }
+            events.push(event);
+        }
+
+        // Sleep until the next send, the next report or one millisecond at most, so that ramp-up stays smooth
+        std::int32_t timeout = 1;
+
+        if (!events.empty() && events.top().at > now) {
+            timeout = static_cast<std::int32_t>(std::min<std::int64_t>(1, std::chrono::duration_cast<std::chrono::milliseconds>(events.top().at - now).count()));
+        }
+        pool.poll(timeout);
+
+        if (now - lastReport >= options.statsEvery) {
+            glnet::TrafficMetrics traffic = pool.getMetrics();
+            glnet::TrafficMetrics delta = traffic;
+            double seconds = std::chrono::duration<double>(now - lastReport).count();
+
+            delta.bytesIn -= lastTraffic.bytesIn;
+            delta.bytesOut -= lastTraffic.bytesOut;
+            stats.received = serverReceived - lastServerReceived;
+            report(std::chrono::duration<double>(now - start).count(), ramping ? "ramp-up" : options.phases[phase].profile.name, pool, stats, delta, seconds);
+            lastTraffic = traffic;
+            lastServerReceived = serverReceived;
+            lastReport = now;
+            stats = Stats();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,358 @@
+
+#include "Utils/Converter.hpp"
+#include "Data/Packet.hpp"
+#include "Callback.hpp"
+#include "Manager.hpp"
+
+#include <functional>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <new>
+
+// Every allocation of the process, the library included, goes through these counters
+static std::atomic<std::uint64_t> allocations = 0;
+static std::atomic<std::uint64_t> allocatedBytes = 0;
+
+void *operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+using glnet::connection::Side;
+using glnet::connection::Type;
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string filter;                 // Only run the benchmarks whose name contains it
+    std::uint64_t iterations = 1000000; // The number of operations of each run
+    std::uint32_t runs = 5;             // The number of runs, the fastest being reported
+    std::uint32_t clients = 1000;       // The number of clients registered for the lookup benchmarks
+    std::uint16_t port = 9650;          // The port of the Manager of the lookup benchmarks
+};
+
+struct Measure {
+    double nanoseconds = 0; // The time per operation
+    double allocations = 0; // The allocations per operation
+    double bytes = 0;       // The bytes allocated per operation
+};
+
+// Keep the compiler from optimizing away a result that is never read
+template <typename T>
+static void keep(T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+template <typename F>
+static Measure measure(const Options& options, std::uint64_t iterations, F&& operation)
+{
+    Measure best;
+
+    for (std::uint64_t i = 0; i < std::min<std::uint64_t>(iterations, 1000); i++) {
+        operation();
+    }
+    for (std::uint32_t run = 0; run < options.runs; run++) {
+        std::uint64_t allocationsBefore = allocations.load(std::memory_order_relaxed);
+        std::uint64_t bytesBefore = allocatedBytes.load(std::memory_order_relaxed);
+        Clock::time_point start = Clock::now();
+
+        for (std::uint64_t i = 0; i < iterations; i++) {
+            operation();
+        }
+        double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+        if (run == 0 || elapsed / iterations < best.nanoseconds) {
+            best.nanoseconds = elapsed / iterations;
+            best.allocations = static_cast<double>(allocations.load(std::memory_order_relaxed) - allocationsBefore) / iterations;
+            best.bytes = static_cast<double>(allocatedBytes.load(std::memory_order_relaxed) - bytesBefore) / iterations;
+        }
+    }
+    return best;
+}
+
+static void report(const std::string& name, std::uint64_t iterations, const Measure& result)
+{
+    std::ostringstream line;
+
+    line << std::fixed << std::setprecision(2);
+    line << "{\"benchmark\":\"" << name << "\"";
+    line << ",\"iterations\":" << iterations;
+    line << ",\"ns_per_op\":" << result.nanoseconds;
+    line << ",\"allocs_per_op\":" << result.allocations;
+    line << ",\"bytes_per_op\":" << result.bytes;
+    line << "}";
+    std::cout << line.str() << std::endl;
+}
+
+struct Benchmark {
+    std::string name;                                          // The name matched by --filter
+    double scale;                                              // The fraction of --iterations run, for the slower operations
+    std::function<Measure(const Options&, std::uint64_t)> run; // Set up the benchmark and measure it
+};
+
+static glnet::Packet makePodPacket()
+{
+    glnet::Packet packet;
+
+    for (std::int32_t i = 0; i < 8; i++) {
+        packet << i;
+    }
+    return packet;
+}
+
+static glnet::Packet makeStringPacket(std::size_t size)
+{
+    glnet::Packet packet;
+
+    packet << std::string(size, 'x');
+    return packet;
+}
+
+// A server Manager with registered clients, whose sockets are never polled
+static std::unique_ptr<glnet::Manager> makeServer(const Options& options)
+{
+    auto server = std::make_unique<glnet::Manager>();
+
+    server->initialize(Side::SERVER, glnet::Manager::Mode::POLLED);
+    server->createConnection(Type::TCP, {LOCALHOST, options.port});
+    for (std::uint32_t i = 0; i < options.clients; i++) {
+        glnet::Socket socket(static_cast<glnet::Socket::Fd>(100000 + i), false);
+
+        socket.setEndpoint({LOCALHOST, static_cast<std::uint16_t>(20000 + i)});
+        server->callbackHandler(glnet::Callback::Type::ON_CONNECTION, socket);
+    }
+    return server;
+}
+
+static std::vector<Benchmark> makeBenchmarks()
+{
+    std::vector<Benchmark> benchmarks;
+
+    benchmarks.push_back({"packet_write_pod_x8", 1, [](const Options& options, std::uint64_t iterations) {
+        return measure(options, iterations, [] {
+            glnet::Packet packet = makePodPacket();
+
+            keep(packet);
+        });
+    }});
+    benchmarks.push_back({"packet_copy_pod_x8", 1, [](const Options& options, std::uint64_t iterations) {
+        glnet::Packet source = makePodPacket();
+
+        return measure(options, iterations, [&source] {
+            glnet::Packet packet = source;
+
+            keep(packet);
+        });
+    }});
+    // A packet is read once, so each operation reads a fresh copy: subtract packet_copy_pod_x8
+    benchmarks.push_back({"packet_read_pod_x8", 1, [](const Options& options, std::uint64_t iterations) {
+        glnet::Packet source = makePodPacket();
+
+        return measure(options, iterations, [&source] {
+            glnet::Packet packet = source;
+            std::int32_t value = 0;
+
+            for (std::int32_t i = 0; i < 8; i++) {
+                packet >> value;
+            }
+            keep(value);
+        });
+    }});
+    for (std::size_t size : {16, 256}) {
+        benchmarks.push_back({"packet_write_string_" + std::to_string(size), 1, [size](const Options& options, std::uint64_t iterations) {
+            std::string text(size, 'x');
+
+            return measure(options, iterations, [&text] {
+                glnet::Packet packet;
+
+                packet << text;
+                keep(packet);
+            });
+        }});
+        benchmarks.push_back({"packet_read_string_" + std::to_string(size), 1, [size](const Options& options, std::uint64_t iterations) {
+            glnet::Packet source = makeStringPacket(size);
+
+            return measure(options, iterations, [&source] {
+                glnet::Packet packet = source;
+                std::string text;
+
+                packet >> text;
+                keep(text);
+            });
+        }});
+    }
+    benchmarks.push_back({"packet_serialize_pod_x8", 1, [](const Options& options, std::uint64_t iterations) {
+        glnet::Packet packet = makePodPacket();
+
+        return measure(options, iterations, [&packet] {
+            std::vector<std::uint8_t> frame = packet.serialize();
+
+            keep(frame);
+        });
+    }});
+    benchmarks.push_back({"converter_number_to_bytes", 1, [](const Options& options, std::uint64_t iterations) {
+        std::uint64_t number = 0x1234;
+
+        return measure(options, iterations, [&number] {
+            std::vector<std::uint8_t> bytes = glnet::utils::Converter::numberToBytes(number++, 2);
+
+            keep(bytes);
+        });
+    }});
+    benchmarks.push_back({"converter_bytes_to_number", 1, [](const Options& options, std::uint64_t iterations) {
+        std::vector<std::uint8_t> bytes = {0x12, 0x34};
+
+        return measure(options, iterations, [&bytes] {
+            std::uint64_t number = glnet::utils::Converter::bytesToNumber(bytes, 2);
+
+            keep(number);
+        });
+    }});
+    benchmarks.push_back({"callback_message_function", 1, [](const Options& options, std::uint64_t iterations) {
+        glnet::Callback callbacks;
+        glnet::Packet packet = makePodPacket();
+        std::uint64_t calls = 0;
+
+        callbacks.setOnMessageReception([&calls](Type, std::uint32_t, glnet::Packet&) { calls++; });
+        Measure result = measure(options, iterations, [&] { callbacks.onMessageReception(Type::TCP, 1, packet); });
+
+        keep(calls);
+        return result;
+    }});
+    benchmarks.push_back({"callback_message_table", 1, [](const Options& options, std::uint64_t iterations) {
+        glnet::Callback callbacks;
+        glnet::Packet packet = makePodPacket();
+        std::uint64_t calls = 0;
+
+        // The table skips the message id of the packet, so each operation dispatches a fresh copy: subtract packet_copy_pod_x8
+        callbacks.setOnMessage(std::int32_t(0), [&calls](Type, std::uint32_t, glnet::Packet&) { calls++; });
+        Measure result = measure(options, iterations, [&] {
+            glnet::Packet copy = packet;
+
+            callbacks.onMessageReception(Type::TCP, 1, copy);
+        });
+
+        keep(calls);
+        return result;
+    }});
+    // The lookups are measured for the first registered client, which the scan of the client map reaches last
+    benchmarks.push_back({"manager_find_client", 1, [](const Options& options, std::uint64_t iterations) {
+        std::unique_ptr<glnet::Manager> server = makeServer(options);
+        std::uint32_t id = 0;
+
+        return measure(options, iterations, [&] {
+            std::shared_ptr<glnet::Socket> socket = server->findClient(id);
+
+            keep(socket);
+        });
+    }});
+    benchmarks.push_back({"manager_client_id_by_socket", 0.01, [](const Options& options, std::uint64_t iterations) {
+        std::unique_ptr<glnet::Manager> server = makeServer(options);
+        glnet::Socket socket(static_cast<glnet::Socket::Fd>(100000), false);
+
+        return measure(options, iterations, [&] {
+            std::uint32_t id = server->getClientIdBy(socket);
+
+            keep(id);
+        });
+    }});
+    benchmarks.push_back({"manager_client_id_by_endpoint", 0.01, [](const Options& options, std::uint64_t iterations) {
+        std::unique_ptr<glnet::Manager> server = makeServer(options);
+        glnet::Endpoint endpoint{LOCALHOST, 20000};
+
+        return measure(options, iterations, [&] {
+            std::uint32_t id = server->getClientIdBy(endpoint);
+
+            keep(id);
+        });
+    }});
+    return benchmarks;
+}
+
+static void usage(const char *name)
+{
+    std::cerr << "Usage: " << name << " [--filter TEXT] [--iterations N] [--runs N] [--clients N] [--port PORT]" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+
+            if (arg == "--help" || i + 1 >= argc) {
+                usage(argv[0]);
+                return arg == "--help" ? 0 : 1;
+            }
+            std::string value = argv[++i];
+
+            if (arg == "--filter") {
+                options.filter = value;
+            } else if (arg == "--iterations") {
+                options.iterations = std::stoull(value);
+            } else if (arg == "--runs") {
+                options.runs = std::max<std::uint32_t>(1, std::stoul(value));
+            } else if (arg == "--clients") {
+                options.clients = std::max<std::uint32_t>(1, std::stoul(value));
+            } else if (arg == "--port") {
+                options.port = static_cast<std::uint16_t>(std::stoul(value));
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        usage(argv[0]);
+        return 1;
+    }
+    for (const Benchmark& benchmark : makeBenchmarks()) {
+        if (benchmark.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        std::uint64_t iterations = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(options.iterations * benchmark.scale));
+
+        report(benchmark.name, iterations, benchmark.run(options, iterations));
+    }
+    return 0;
+}
@@ -0,0 +1,229 @@
+
+#include "Utils/Capture.hpp"
+#include "Data/Packet.hpp"
+#include "ClientPool.hpp"
+#include "Manager.hpp"
+
+#include <unordered_map>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <csignal>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using glnet::connection::SendResult;
+using glnet::connection::Type;
+using glnet::utils::Capture;
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string path;                        // The capture file
+    glnet::Endpoint server{LOCALHOST, 8080}; // The server fed with the capture
+    double speed = 1;                        // The replay speed, 2 for twice as fast, 0 for as fast as possible
+    bool outgoing = false;                   // Replay the sent frames, for a capture taken on a client
+    bool info = false;                       // Only print the content of the capture
+    std::chrono::seconds connectTimeout{10}; // The time given to every client to connect
+};
+
+// A captured frame, its payload pointing into the mapping of the reader
+struct Frame {
+    std::int64_t timestamp;
+    std::uint32_t clientId;
+    Type transport;
+    const std::uint8_t *data;
+    std::uint32_t length;
+};
+
+static volatile std::sig_atomic_t interrupted = 0;
+
+static void usage(const char *name)
+{
+    std::cerr << "Usage: " << name << " CAPTURE [--host HOST] [--port PORT] [--speed FACTOR] [--connect-timeout SECONDS] [--outgoing] [--info]" << std::endl;
+}
+
+static void printInfo(glnet::utils::CaptureReader& reader)
+{
+    std::uint64_t counts[2][2] = {{0, 0}, {0, 0}};
+    std::uint64_t bytes[2][2] = {{0, 0}, {0, 0}};
+    std::int64_t first = 0;
+    std::int64_t last = 0;
+    std::unordered_map<std::uint32_t, bool> clients;
+    Capture::RecordHeader header;
+    const std::uint8_t *data = nullptr;
+
+    while (reader.next(header, data)) {
+        std::size_t direction = header.direction == static_cast<std::uint8_t>(Capture::Direction::OUT);
+        std::size_t transport = header.transport == static_cast<std::uint8_t>(Type::UDP);
+
+        counts[direction][transport]++;
+        bytes[direction][transport] += header.length;
+        first = first == 0 ? header.timestamp : std::min(first, header.timestamp);
+        last = std::max(last, header.timestamp);
+        clients[header.clientId] = true;
+    }
+    std::ostringstream line;
+
+    line << std::fixed << std::setprecision(3);
+    line << "{\"seconds\":" << (last - first) / 1e9 << ",\"clients\":" << clients.size();
+    line << ",\"in_tcp\":" << counts[0][0] << ",\"in_udp\":" << counts[0][1] << ",\"out_tcp\":" << counts[1][0] << ",\"out_udp\":" << counts[1][1];
+    line << ",\"in_tcp_bytes\":" << bytes[0][0] << ",\"in_udp_bytes\":" << bytes[0][1] << ",\"out_tcp_bytes\":" << bytes[1][0] << ",\"out_udp_bytes\":" << bytes[1][1] << "}";
+    std::cout << line.str() << std::endl;
+}
+
+static std::vector<Frame> loadFrames(glnet::utils::CaptureReader& reader, Capture::Direction direction)
+{
+    std::vector<Frame> frames;
+    Capture::RecordHeader header;
+    const std::uint8_t *data = nullptr;
+
+    while (reader.next(header, data)) {
+        Type transport = static_cast<Type>(header.transport);
+
+        // The pool only has tcp and udp, the frames of the stream transports are replayed over tcp
+        if (header.direction == static_cast<std::uint8_t>(direction)) {
+            frames.push_back({header.timestamp, header.clientId, transport == Type::UDP ? Type::UDP : Type::TCP, data, header.length});
+        }
+    }
+    // Concurrent writers reserve their records slightly out of timestamp order
+    std::stable_sort(frames.begin(), frames.end(), [](const Frame& a, const Frame& b) { return a.timestamp < b.timestamp; });
+    return frames;
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+
+            if (arg == "--outgoing" || arg == "--info") {
+                (arg == "--info" ? options.info : options.outgoing) = true;
+                continue;
+            }
+            if (arg.rfind("--", 0) != 0 && options.path.empty()) {
+                options.path = arg;
+                continue;
+            }
+            if (arg == "--help" || i + 1 >= argc) {
+                usage(argv[0]);
+                return arg == "--help" ? 0 : 1;
+            }
+            std::string value = argv[++i];
+
+            if (arg == "--host") {
+                options.server.address = value;
+            } else if (arg == "--port") {
+                options.server.port = static_cast<std::uint16_t>(std::stoul(value));
+            } else if (arg == "--speed") {
+                options.speed = std::max(0.0, std::stod(value));
+            } else if (arg == "--connect-timeout") {
+                options.connectTimeout = std::chrono::seconds(std::stoul(value));
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+        if (options.path.empty()) {
+            usage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        usage(argv[0]);
+        return 1;
+    }
+    std::signal(SIGINT, [](int) { interrupted = 1; });
+
+    try {
+        glnet::utils::CaptureReader reader(options.path);
+
+        if (options.info) {
+            printInfo(reader);
+            return 0;
+        }
+        std::vector<Frame> frames = loadFrames(reader, options.outgoing ? Capture::Direction::OUT : Capture::Direction::IN);
+
+        if (frames.empty()) {
+            std::cerr << "No frame to replay in " << options.path << std::endl;
+            return 1;
+        }
+
+        // One client of the pool for each captured client, all connected before the first frame
+        glnet::ClientPool pool(options.server);
+        std::unordered_map<std::uint32_t, glnet::ClientPool::Id> clients;
+        std::uint64_t failures = 0;
+
+        pool.callbacks().setOnConnectionFailure([&failures](std::uint32_t) { failures++; });
+        for (const Frame& frame : frames) {
+            if (!clients.contains(frame.clientId)) {
+                clients.emplace(frame.clientId, pool.add());
+            }
+        }
+        Clock::time_point deadline = Clock::now() + options.connectTimeout;
+
+        while (!interrupted && pool.getConnectedCount() + failures < clients.size() && Clock::now() < deadline) {
+            pool.poll(10);
+        }
+        if (pool.getConnectedCount() != clients.size()) {
+            std::cerr << "Only " << pool.getConnectedCount() << " of the " << clients.size() << " clients connected, their frames are skipped" << std::endl;
+        }
+
+        // Each frame is sent at its captured offset from the first one, divided by the speed
+        std::uint64_t sent = 0;
+        std::uint64_t failed = 0;
+        std::int64_t lateness = 0;
+        Clock::time_point start = Clock::now();
+
+        for (const Frame& frame : frames) {
+            if (interrupted) {
+                break;
+            }
+            if (options.speed > 0) {
+                Clock::time_point due = start + std::chrono::nanoseconds(static_cast<std::int64_t>((frame.timestamp - frames.front().timestamp) / options.speed));
+                Clock::time_point now = Clock::now();
+
+                while (now < due) {
+                    pool.poll(static_cast<std::int32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(due - now).count()));
+                    now = Clock::now();
+                }
+                lateness = std::max<std::int64_t>(lateness, std::chrono::duration_cast<std::chrono::nanoseconds>(now - due).count());
+            }
+            glnet::Packet packet;
+
+            packet.bytes.assign(frame.data, frame.data + frame.length);
+            packet.length = frame.length;
+            if (pool.send(clients[frame.clientId], frame.transport, packet) == SendResult::FAILED) {
+                failed++;
+            } else {
+                sent++;
+            }
+            // Without pacing, still let the sockets drain every so often
+            if (options.speed == 0 && sent % 256 == 0) {
+                pool.poll(0);
+            }
+        }
+        Clock::time_point end = Clock::now();
+
+        // Flush what the tcp connections still hold before closing them
+        deadline = end + std::chrono::seconds(5);
+        while (!interrupted && pool.getMetrics().queuedBytes != 0 && Clock::now() < deadline) {
+            pool.poll(10);
+        }
+        std::ostringstream line;
+        double seconds = std::chrono::duration<double>(end - start).count();
+
+        line << std::fixed << std::setprecision(3);
+        line << "{\"frames\":" << frames.size() << ",\"sent\":" << sent << ",\"failed\":" << failed << ",\"clients\":" << clients.size();
+        line << ",\"seconds\":" << seconds << ",\"frames_per_sec\":" << (seconds > 0 ? sent / seconds : 0);
+        line << ",\"max_late_ms\":" << lateness / 1e6 << "}";
+        std::cout << line.str() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
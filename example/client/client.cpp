@@ -11,7 +11,7 @@ volatile bool sigintCatch = false;
 
 int main(void)
 {
-    glnet::Manager& client = glnet::Manager::getInstance();
+    glnet::Manager client;
 
     // Initialize the manager as a client
     client.initialize(glnet::connection::Side::CLIENT);
@@ -39,14 +39,14 @@ int main(void)
 
         positionPacket << glnet::message::Type::PLAYER_POSITION << position;
         std::cout << "Sending player position to server: (" << position.x << ", " << position.y << ", " << position.z << ")" << std::endl;
-        client.sendToServer(glnet::connection::Type::UDP, positionPacket);
+        client.sendToServer(glnet::connection::Type::UDP, positionPacket, {.delivery = glnet::connection::Delivery::UNRELIABLE_SEQUENCED, .priority = glnet::connection::Priority::REALTIME});
 
         // Send a plain text message
         glnet::Packet messagePacket;
 
         messagePacket << glnet::message::Type::CHAT_MESSAGE << "Push the B site !";
         std::cout << "Sending chat message to server: " << "Push the B site !" << std::endl;
-        client.sendToServer(glnet::connection::Type::UDP, messagePacket);
+        client.sendToServer(glnet::connection::Type::UDP, messagePacket, {.priority = glnet::connection::Priority::CONTROL});
     });
 
     client.connectToServer();
@@ -13,7 +13,7 @@ volatile bool sigintCatch = false;
 
 int main(void)
 {
-    glnet::Manager& server = glnet::Manager::getInstance();
+    glnet::Manager server;
 
     // Initialize the manager as a server
     server.initialize(glnet::connection::Side::SERVER);
@@ -37,22 +37,13 @@ int main(void)
         std::cout << "Client disconnected with id " << clientId << std::endl;
     });
 
-    server.callbacks().setOnMessageReception([](glnet::connection::Type type, std::uint32_t clientId, glnet::Packet& packet) {
-        glnet::message::Type packetType;
-
-        packet >> packetType;
-        if (packetType == glnet::message::Type::PLAYER_POSITION) {
-            Player::Position position = {0};
-
-            packet >> position;
-            std::cout << "Received player position from client " << clientId << ": (" << position.x << ", " << position.y << ", " << position.z << ")" << std::endl;
-        }
-        if (packetType == glnet::message::Type::CHAT_MESSAGE) {
-            std::string message;
+    // Set up one handler per message type, the payload is decoded before the handler is called
+    server.callbacks().setOnMessageAs<Player::Position>(glnet::message::Type::PLAYER_POSITION, [](glnet::connection::Type type, std::uint32_t clientId, const Player::Position& position) {
+        std::cout << "Received player position from client " << clientId << ": (" << position.x << ", " << position.y << ", " << position.z << ")" << std::endl;
+    });
 
-            packet >> message;
-            std::cout << "Received chat message from client " << clientId << ": " << message << std::endl;
-        }
+    server.callbacks().setOnMessageAs<std::string>(glnet::message::Type::CHAT_MESSAGE, [](glnet::connection::Type type, std::uint32_t clientId, const std::string& message) {
+        std::cout << "Received chat message from client " << clientId << ": " << message << std::endl;
     });
 
     while (!sigintCatch) {
@@ -1,10 +1,14 @@
 
 #pragma once
 
+#include "Utils/InlineFunction.hpp"
 #include "Enum/Connection.hpp"
 #include "Data/Packet.hpp"
 
+#include <type_traits>
 #include <functional>
+#include <stdexcept>
+#include <array>
 
 namespace glnet
 {
@@ -17,10 +21,21 @@ namespace glnet
              */
             enum class Type {
                 ON_CONNECTION,
+                ON_CONNECTION_FAILURE,
                 ON_DISCONNECTION,
-                ON_MESSAGE_RECEPTION
+                ON_MESSAGE_RECEPTION,
+                ON_BACKPRESSURE,
+                ON_WRITABLE,
+                ON_DESCRIPTOR_RECEPTION
             };
 
+            static constexpr std::size_t MAX_MESSAGE_IDS = 256; /*!> The number of entries of the message dispatch table */
+
+            /**
+             * @brief Handler of a given message id, stored inline in the dispatch table
+             */
+            using MessageHandler = utils::InlineFunction<void(connection::Type, std::uint32_t, Packet&)>;
+
             /**
              * @brief Handler of the callbacks for a new connection
              *
@@ -35,6 +50,20 @@ namespace glnet
              */
             void setOnConnection(std::function<void(std::uint32_t)> func);
 
+            /**
+             * @brief Handler of the callbacks for a failed connection attempt
+             *
+             * @param clientId The id of the client whose connection failed
+             */
+            void onConnectionFailure(std::uint32_t clientId);
+
+            /**
+             * @brief Set the callback for a failed connection attempt
+             *
+             * @param func The function to set
+             */
+            void setOnConnectionFailure(std::function<void(std::uint32_t)> func);
+
             /**
              * @brief Handler of the callbacks for a disconnection
              *
@@ -49,6 +78,34 @@ namespace glnet
              */
             void setOnDisconnection(std::function<void(std::uint32_t)> func);
 
+            /**
+             * @brief Handler of the callbacks for a connection going above its high watermark
+             *
+             * @param clientId The id of the congested client
+             */
+            void onBackpressure(std::uint32_t clientId);
+
+            /**
+             * @brief Set the callback for a connection going above its high watermark
+             *
+             * @param func The function to set
+             */
+            void setOnBackpressure(std::function<void(std::uint32_t)> func);
+
+            /**
+             * @brief Handler of the callbacks for a congested connection going back below its low watermark
+             *
+             * @param clientId The id of the writable client
+             */
+            void onWritable(std::uint32_t clientId);
+
+            /**
+             * @brief Set the callback for a congested connection going back below its low watermark
+             *
+             * @param func The function to set
+             */
+            void setOnWritable(std::function<void(std::uint32_t)> func);
+
             /**
              * @brief Handler of the callbacks for a message reception
              *
@@ -65,9 +122,87 @@ namespace glnet
              */
             void setOnMessageReception(std::function<void(connection::Type, std::uint32_t, Packet&)> func);
 
+            /**
+             * @brief Handler of the callbacks for a file descriptor received on a local connection
+             *
+             * @param clientId The id of the client
+             * @param descriptor The received file descriptor, owned by the callback
+             * @param packet The packet sent along with the descriptor
+             * @return true if a callback took the descriptor, false if none is set
+             */
+            bool onDescriptorReception(std::uint32_t clientId, std::int32_t descriptor, Packet& packet);
+
+            /**
+             * @brief Set the callback for a file descriptor received on a local connection, which must close or adopt the descriptor
+             *
+             * @param func The function to set
+             */
+            void setOnDescriptorReception(std::function<void(std::uint32_t, std::int32_t, Packet&)> func);
+
+            /**
+             * @brief Set the handler of a given message id, the packet is given to the handler with its id already read
+             *
+             * @tparam Id The type of the message id written at the start of the packets (enum or integer)
+             * @param id The message id to handle
+             * @param handler The handler to set
+             */
+            template <typename Id>
+            void setOnMessage(Id id, MessageHandler handler)
+            {
+                static_assert(std::is_enum_v<Id> || std::is_integral_v<Id>, "Message id must be an enum or an integer");
+                static_assert(sizeof(Id) == 1 || sizeof(Id) == 2 || sizeof(Id) == 4 || sizeof(Id) == 8, "Message id has an unsupported size");
+                std::size_t index = static_cast<std::size_t>(id);
+
+                if (index >= MAX_MESSAGE_IDS) {
+                    throw std::runtime_error("Message id is out of the dispatch table range");
+                }
+                if (messageIdSize_ != 0 && messageIdSize_ != sizeof(Id)) {
+                    throw std::runtime_error("Every message id of the dispatch table must have the same type");
+                }
+                messageIdSize_ = sizeof(Id);
+                messageHandlers_[index] = std::move(handler);
+            }
+
+            /**
+             * @brief Set the handler of a given message id, the payload following the id is decoded into the given type
+             *
+             * @tparam T The type of the payload (trivially copyable or std::string)
+             * @tparam Id The type of the message id written at the start of the packets (enum or integer)
+             * @tparam F The type of the handler, callable with (connection::Type, std::uint32_t, const T&)
+             * @param id The message id to handle
+             * @param func The handler to set
+             */
+            template <typename T, typename Id, typename F>
+            void setOnMessageAs(Id id, F func)
+            {
+                setOnMessage(id, [func](connection::Type type, std::uint32_t clientId, Packet& packet) {
+                    T message{};
+
+                    packet >> message;
+                    func(type, clientId, message);
+                });
+            }
+
         private:
+            /**
+             * @brief Dispatch a packet to the handler of its message id
+             *
+             * @param type The type of the connection
+             * @param clientId The id of the client
+             * @param packet The received packet
+             * @return true if a handler was called, false otherwise
+             */
+            bool dispatch(connection::Type type, std::uint32_t clientId, Packet& packet);
+
             std::function<void(std::uint32_t)> onConnection_;                                  /*!> The function to call when a clients connect (to be defined by the user) */
+            std::function<void(std::uint32_t)> onConnectionFailure_;                           /*!> The function to call when a connection attempt fails (to be defined by the user) */
             std::function<void(std::uint32_t)> onDisconnection_;                               /*!> The function to call when a clients disconnect (to be defined by the user) */
             std::function<void(connection::Type, std::uint32_t, Packet&)> onMessageReception_; /*!> The function to call when a message is received (to be defined by the user) */
+            std::function<void(std::uint32_t)> onBackpressure_;                                /*!> The function to call when a connection is congested (to be defined by the user) */
+            std::function<void(std::uint32_t)> onWritable_;                                    /*!> The function to call when a congested connection drains (to be defined by the user) */
+            std::function<void(std::uint32_t, std::int32_t, Packet&)> onDescriptorReception_;  /*!> The function to call when a file descriptor is received (to be defined by the user) */
+
+            std::array<MessageHandler, MAX_MESSAGE_IDS> messageHandlers_; /*!> The handlers of the messages, indexed by message id */
+            std::uint8_t messageIdSize_ = 0;                              /*!> The size of the message id in bytes (0 if no handler is registered) */
     };
 }
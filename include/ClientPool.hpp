@@ -0,0 +1,188 @@
+
+#pragma once
+
+#include "Enum/Connection.hpp"
+#include "Protocol/Udp.hpp"
+#include "Data/SendOptions.hpp"
+#include "Data/Watermarks.hpp"
+#include "Data/Endpoint.hpp"
+#include "Data/Metrics.hpp"
+#include "Data/Packet.hpp"
+#include "Callback.hpp"
+#include "Socket.hpp"
+
+#include <unordered_map>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace glnet
+{
+    class ClientPool
+    {
+        public:
+            /**
+             * @brief Id of a client of the pool
+             */
+            using Id = std::uint32_t;
+
+            /**
+             * @brief Construct a new ClientPool object, driving many clients of one server from the thread calling poll (not thread-safe)
+             *
+             * @param server The endpoint of the server the clients connect to
+             */
+            ClientPool(Endpoint server);
+
+            /**
+             * @brief Open a client: bind its tcp and udp sockets to the same local port and start connecting
+             *
+             * @return Id The id of the client, passed to the callbacks
+             */
+            Id add();
+
+            /**
+             * @brief Close a client without calling the disconnection callback
+             *
+             * @param id The id of the client
+             */
+            void remove(Id id);
+
+            /**
+             * @brief Check if a client finished connecting
+             *
+             * @param id The id of the client
+             * @return true if the client is connected, false otherwise
+             */
+            bool isConnected(Id id) const;
+
+            /**
+             * @brief Get the number of open clients, connecting ones included
+             *
+             * @return std::size_t The number of clients
+             */
+            std::size_t size() const;
+
+            /**
+             * @brief Get the number of connected clients
+             *
+             * @return std::size_t The number of clients
+             */
+            std::size_t getConnectedCount() const;
+
+            /**
+             * @brief Send a packet to the server from a client (tcp frames are written at once, the rest on the next poll)
+             *
+             * @param id The id of the client
+             * @param type The type of the connection
+             * @param packet The packet to send
+             * @param options The delivery and channel of the packet (udp only, reliable delivery is not supported)
+             * @return connection::SendResult QUEUED, CONGESTED above the high watermark, or FAILED
+             */
+            connection::SendResult send(Id id, connection::Type type, Packet& packet, SendOptions options = {});
+
+            /**
+             * @brief Wait for events on every socket of the pool and handle them, calling the callbacks
+             *
+             * @param timeout The maximum time to wait, in milliseconds (-1 to wait forever)
+             * @return std::int32_t The number of sockets that had events
+             */
+            std::int32_t poll(std::int32_t timeout);
+
+            /**
+             * @brief Set the outbound byte thresholds of every client
+             *
+             * @param watermarks The thresholds
+             */
+            void setWatermarks(Watermarks watermarks);
+
+            /**
+             * @brief Get the traffic of every client since the creation of the pool
+             *
+             * @return TrafficMetrics The counters, queuedBytes being the tcp bytes not written yet
+             */
+            TrafficMetrics getMetrics() const;
+
+            /**
+             * @brief Get the callbacks of the pool, called with the id of the client
+             *
+             * @return Callback& The callbacks
+             */
+            Callback& callbacks();
+
+        private:
+            /**
+             * @struct Client
+             * @brief The sockets and buffers of a client
+             */
+            struct Client {
+                    std::unique_ptr<Socket> tcp;                               /*!> The connection to the server */
+                    std::unique_ptr<Socket> udp;                               /*!> The datagram socket, bound to the local port of the connection */
+                    bool connected = false;                                    /*!> If the connection was established */
+                    bool congested = false;                                    /*!> If the outbound bytes went above the high watermark */
+                    std::vector<std::uint8_t> outbound;                        /*!> The frames not fully written yet */
+                    std::size_t written = 0;                                   /*!> The bytes of outbound already written */
+                    Packet inbound;                                            /*!> The frame being read */
+                    std::size_t received = 0;                                  /*!> The bytes of the frame read so far, length included */
+                    std::unordered_map<std::uint8_t, std::uint16_t> sequences; /*!> The next sequence of each unreliable-sequenced channel */
+            };
+
+            /**
+             * @brief Finish the connection of a client once its socket is writable
+             *
+             * @param id The id of the client
+             * @param client The client
+             * @return true if the client is connected, false if it was closed
+             */
+            bool finishConnect(Id id, Client& client);
+
+            /**
+             * @brief Read the frames available on the connection of a client
+             *
+             * @param id The id of the client
+             * @param client The client
+             * @return true if the connection is still open, false otherwise
+             */
+            bool readFrames(Id id, Client& client);
+
+            /**
+             * @brief Read a datagram from the udp socket of a client
+             *
+             * @param id The id of the client
+             * @param client The client
+             */
+            void readDatagram(Id id, Client& client);
+
+            /**
+             * @brief Write as much of the outbound bytes of a client as the socket takes
+             *
+             * @param id The id of the client
+             * @param client The client
+             * @return true if the connection is still open, false otherwise
+             */
+            bool flush(Id id, Client& client);
+
+            /**
+             * @brief Close a client whose connection was lost and call the disconnection callback
+             *
+             * @param id The id of the client
+             */
+            void disconnect(Id id);
+
+            static constexpr std::size_t MAX_READ_BATCH = 64;    /*!> The maximum number of frames read from a connection per poll */
+            static constexpr std::size_t MAX_BIND_ATTEMPTS = 16; /*!> The number of local ports tried before giving up on a client */
+
+            Endpoint server_;                        /*!> The endpoint of the server */
+            Socket::Address_in serverAddr_;          /*!> The resolved address of the server */
+            std::unordered_map<Id, Client> clients_; /*!> The open clients, by id */
+            Id nextId_ = 0;                          /*!> The id of the next client */
+            std::size_t connected_ = 0;              /*!> The number of connected clients */
+            Watermarks watermarks_;                  /*!> The outbound byte thresholds of every client */
+            Callback callbacks_;                     /*!> The callbacks, called with the id of the client */
+            TrafficMetrics traffic_;                 /*!> The traffic of every client */
+
+            std::vector<Socket::PollFd> pollFds_;                     /*!> The sockets polled, rebuilt on each poll */
+            std::vector<std::pair<Id, connection::Type>> pollOwners_; /*!> The client and transport of each polled socket */
+            std::vector<std::uint8_t> datagram_;                      /*!> The datagram being written */
+            std::vector<std::uint8_t> receiveBuffer_;                 /*!> The datagram being read */
+    };
+}
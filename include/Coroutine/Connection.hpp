@@ -0,0 +1,207 @@
+
+#pragma once
+
+#include "Enum/Connection.hpp"
+#include "Data/Endpoint.hpp"
+#include "Data/Packet.hpp"
+
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <deque>
+
+namespace glnet
+{
+    class Manager;
+
+    class Mailbox
+    {
+        public:
+            /**
+             * @brief Deliver a packet, resuming the waiting coroutine on the calling (I/O) thread
+             *
+             * @param packet The received packet
+             */
+            void push(Packet&& packet);
+
+            /**
+             * @brief Close the mailbox, resuming the waiting coroutine with an error
+             */
+            void close();
+
+            /**
+             * @brief Take a packet if one is already available
+             *
+             * @param packet The packet to fill
+             * @param closed Set to true if the mailbox is closed
+             * @return true if the caller doesn't need to wait, false otherwise
+             */
+            bool tryPop(Packet& packet, bool& closed);
+
+            /**
+             * @brief Register a coroutine waiting for the next packet
+             *
+             * @param waiter The coroutine to resume
+             * @param packet The packet to fill before resuming
+             * @param closed The flag to set if the mailbox is closed before resuming
+             * @return true if the coroutine must stay suspended, false if a packet arrived meanwhile
+             */
+            bool wait(std::coroutine_handle<> waiter, Packet *packet, bool *closed);
+
+        private:
+            std::mutex mutex_;               /*!> Guard of the mailbox, shared by the I/O threads and the coroutine */
+            std::deque<Packet> packets_;     /*!> The packets received while no coroutine was waiting */
+            std::coroutine_handle<> waiter_; /*!> The coroutine waiting for a packet */
+            Packet *slot_ = nullptr;         /*!> The packet to fill for the waiting coroutine */
+            bool *closedSlot_ = nullptr;     /*!> The closed flag of the waiting coroutine */
+            bool closed_ = false;            /*!> If the connection was closed */
+    };
+
+    class Connection
+    {
+        public:
+            /**
+             * @brief Awaitable resuming with the next packet of the connection
+             */
+            class ReceiveAwaiter
+            {
+                public:
+                    /**
+                     * @brief Construct a new ReceiveAwaiter object
+                     *
+                     * @param mailbox The mailbox of the connection
+                     */
+                    explicit ReceiveAwaiter(std::shared_ptr<Mailbox> mailbox);
+
+                    /**
+                     * @brief Check if a packet is already available
+                     */
+                    bool await_ready();
+
+                    /**
+                     * @brief Wait for the next packet, unless one arrived meanwhile
+                     */
+                    bool await_suspend(std::coroutine_handle<> waiter);
+
+                    /**
+                     * @brief Get the received packet, throws if the connection is closed
+                     */
+                    Packet await_resume();
+
+                private:
+                    std::shared_ptr<Mailbox> mailbox_; /*!> The mailbox of the connection */
+                    Packet packet_;                    /*!> The received packet */
+                    bool closed_ = false;              /*!> If the connection was closed */
+            };
+
+            /**
+             * @brief Awaitable completing as soon as the packet is queued on the I/O thread
+             */
+            class SendAwaiter
+            {
+                public:
+                    /**
+                     * @brief Construct a new SendAwaiter object
+                     *
+                     * @param result The result of the queueing
+                     */
+                    explicit SendAwaiter(connection::SendResult result);
+
+                    /**
+                     * @brief Never suspend, the packet is already queued
+                     */
+                    bool await_ready() const noexcept;
+
+                    /**
+                     * @brief Unused, the awaiter never suspends
+                     */
+                    void await_suspend(std::coroutine_handle<>) const noexcept;
+
+                    /**
+                     * @brief Get the result of the queueing
+                     */
+                    connection::SendResult await_resume() const noexcept;
+
+                private:
+                    connection::SendResult result_; /*!> The result of the queueing */
+            };
+
+            /**
+             * @brief Construct a new Connection object
+             *
+             * @param manager The manager owning the connection
+             * @param type The type of connection used to send
+             * @param clientId The id of the client (0 for the server on client side)
+             * @param mailbox The mailbox receiving the packets of the connection
+             */
+            Connection(Manager& manager, connection::Type type, std::uint32_t clientId, std::shared_ptr<Mailbox> mailbox);
+
+            /**
+             * @brief Wait for the next packet received on the connection (tcp or udp)
+             *
+             * @return ReceiveAwaiter The awaitable resuming with the packet, throws if the connection is closed
+             */
+            ReceiveAwaiter receive();
+
+            /**
+             * @brief Send a packet on the connection
+             *
+             * @param packet The packet to send
+             * @return SendAwaiter The awaitable resuming with the result of the queueing
+             */
+            SendAwaiter send(Packet& packet);
+
+            /**
+             * @brief Send a packet on the connection with a given type of connection
+             *
+             * @param type The type of connection to use
+             * @param packet The packet to send
+             * @return SendAwaiter The awaitable resuming with the result of the queueing
+             */
+            SendAwaiter send(connection::Type type, Packet& packet);
+
+            /**
+             * @brief Get the id of the client
+             *
+             * @return std::uint32_t The id of the client
+             */
+            std::uint32_t getId() const;
+
+        private:
+            Manager *manager_;                 /*!> The manager owning the connection */
+            connection::Type type_;            /*!> The type of connection used to send */
+            std::uint32_t clientId_;           /*!> The id of the client */
+            std::shared_ptr<Mailbox> mailbox_; /*!> The mailbox receiving the packets of the connection */
+    };
+
+    class ConnectAwaiter
+    {
+        public:
+            /**
+             * @brief Construct a new ConnectAwaiter object
+             *
+             * @param manager The manager connecting to the server
+             */
+            explicit ConnectAwaiter(Manager& manager);
+
+            /**
+             * @brief Always suspend while the connection is in progress
+             */
+            bool await_ready() const noexcept;
+
+            /**
+             * @brief Start the connection, the coroutine is resumed on the tcp thread once it completes
+             */
+            bool await_suspend(std::coroutine_handle<> waiter);
+
+            /**
+             * @brief Get the connection to the server, throws if the connection failed
+             */
+            Connection await_resume();
+
+        private:
+            Manager& manager_; /*!> The manager connecting to the server */
+            bool failed_;      /*!> If the connection failed */
+    };
+}
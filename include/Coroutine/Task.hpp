@@ -0,0 +1,254 @@
+
+#pragma once
+
+#include "Utils/FramePool.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <utility>
+
+namespace glnet
+{
+    /**
+     * @brief Storage of the result of a task
+     *
+     * @tparam T The type of the result
+     */
+    template <typename T>
+    class TaskResult
+    {
+        public:
+            /**
+             * @brief Store the value given to co_return
+             *
+             * @param value The returned value
+             */
+            void return_value(T value)
+            {
+                value_ = std::move(value);
+            }
+
+            /**
+             * @brief Take the stored value
+             *
+             * @return T The returned value
+             */
+            T take()
+            {
+                return std::move(*value_);
+            }
+
+        private:
+            std::optional<T> value_; /*!> The returned value */
+    };
+
+    /**
+     * @brief Storage of the result of a task returning nothing
+     */
+    template <>
+    class TaskResult<void>
+    {
+        public:
+            /**
+             * @brief Handle a co_return without value
+             */
+            void return_void()
+            {
+            }
+
+            /**
+             * @brief Take the (absent) stored value
+             */
+            void take()
+            {
+            }
+    };
+
+    template <typename T = void>
+    class Task
+    {
+        public:
+            class promise_type;
+
+            /**
+             * @brief Handle of the coroutine of the task
+             */
+            using Handle = std::coroutine_handle<promise_type>;
+
+            class promise_type : public TaskResult<T>
+            {
+                public:
+                    /**
+                     * @brief Create the task owning the coroutine
+                     */
+                    Task get_return_object()
+                    {
+                        return Task(Handle::from_promise(*this));
+                    }
+
+                    /**
+                     * @brief Tasks are lazy, they start when awaited or detached
+                     */
+                    std::suspend_always initial_suspend() noexcept
+                    {
+                        return {};
+                    }
+
+                    /**
+                     * @brief Resume the awaiting coroutine, or release a detached task
+                     */
+                    auto final_suspend() noexcept
+                    {
+                        struct FinalAwaiter {
+                                bool await_ready() noexcept
+                                {
+                                    return false;
+                                }
+
+                                std::coroutine_handle<> await_suspend(Handle handle) noexcept
+                                {
+                                    promise_type& promise = handle.promise();
+
+                                    if (promise.continuation_) {
+                                        return promise.continuation_;
+                                    }
+                                    if (promise.detached_) {
+                                        if (promise.exception_) {
+                                            try {
+                                                std::rethrow_exception(promise.exception_);
+                                            } catch (const std::exception& e) {
+                                                std::cerr << e.what() << std::endl;
+                                            } catch (...) {
+                                            }
+                                        }
+                                        handle.destroy();
+                                    }
+                                    return std::noop_coroutine();
+                                }
+
+                                void await_resume() noexcept
+                                {
+                                }
+                        };
+                        return FinalAwaiter{};
+                    }
+
+                    /**
+                     * @brief Store the exception escaping the coroutine, rethrown to the awaiter
+                     */
+                    void unhandled_exception()
+                    {
+                        exception_ = std::current_exception();
+                    }
+
+                    /**
+                     * @brief Allocate the coroutine frame from the frame pool
+                     */
+                    static void *operator new(std::size_t size)
+                    {
+                        return utils::FramePool::allocate(size);
+                    }
+
+                    /**
+                     * @brief Release the coroutine frame to the frame pool
+                     */
+                    static void operator delete(void *ptr, std::size_t size)
+                    {
+                        utils::FramePool::deallocate(ptr, size);
+                    }
+
+                private:
+                    friend class Task;
+
+                    std::coroutine_handle<> continuation_; /*!> The coroutine awaiting the task */
+                    std::exception_ptr exception_;         /*!> The exception escaping the coroutine */
+                    bool detached_ = false;                /*!> If the task releases itself when it completes */
+            };
+
+            /**
+             * @brief Move constructor of the Task class
+             */
+            Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {}))
+            {
+            }
+
+            /**
+             * @brief Move assignement operator of the Task class
+             */
+            Task& operator=(Task&& other) noexcept
+            {
+                if (this != &other) {
+                    if (handle_) {
+                        handle_.destroy();
+                    }
+                    handle_ = std::exchange(other.handle_, {});
+                }
+                return *this;
+            }
+
+            /**
+             * @brief Destroy the Task object and its coroutine if it is still owned
+             */
+            ~Task()
+            {
+                if (handle_) {
+                    handle_.destroy();
+                }
+            }
+
+            /**
+             * @brief Start the task without awaiting it, the coroutine releases itself when it completes
+             */
+            void detach()
+            {
+                Handle handle = std::exchange(handle_, {});
+
+                handle.promise().detached_ = true;
+                handle.resume();
+            }
+
+            /**
+             * @brief Await the task, starting it and resuming the caller when it completes
+             */
+            auto operator co_await() && noexcept
+            {
+                struct Awaiter {
+                        Handle handle;
+
+                        bool await_ready() noexcept
+                        {
+                            return !handle || handle.done();
+                        }
+
+                        std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+                        {
+                            handle.promise().continuation_ = continuation;
+                            return handle;
+                        }
+
+                        T await_resume()
+                        {
+                            if (handle.promise().exception_) {
+                                std::rethrow_exception(handle.promise().exception_);
+                            }
+                            return handle.promise().take();
+                        }
+                };
+                return Awaiter{handle_};
+            }
+
+        private:
+            /**
+             * @brief Construct a new Task object owning the given coroutine
+             *
+             * @param handle The coroutine of the task
+             */
+            explicit Task(Handle handle) : handle_(handle)
+            {
+            }
+
+            Handle handle_; /*!> The coroutine of the task */
+    };
+}
@@ -0,0 +1,16 @@
+
+#pragma once
+
+#include <cstdint>
+
+namespace glnet
+{
+    /**
+     * @struct ConnectionLimits
+     * @brief Represent the admission control of a tcp server
+     */
+    struct ConnectionLimits {
+            std::size_t maxConnections = 0;  /*!> The highest number of clients connected at once, the others are accepted and closed at once (0 for no limit) */
+            std::size_t acceptsPerTick = 64; /*!> The highest number of connections accepted per loop iteration, the rest wait for the next one (0 for no limit) */
+    };
+}
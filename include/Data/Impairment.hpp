@@ -0,0 +1,22 @@
+
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+
+namespace glnet
+{
+    /**
+     * @struct Impairment
+     * @brief Represent the conditions of a simulated network link in one direction
+     */
+    struct Impairment {
+            std::chrono::milliseconds latency{0};       /*!> The one-way delay added to every packet */
+            std::chrono::milliseconds jitter{0};        /*!> The largest deviation from the latency, drawn uniformly for each packet */
+            double loss = 0;                            /*!> The probability of dropping a datagram (udp only) */
+            double duplicate = 0;                       /*!> The probability of delivering a datagram twice (udp only) */
+            double reorder = 0;                         /*!> The probability of holding a datagram back, so that the next ones overtake it (udp only) */
+            std::chrono::milliseconds reorderDelay{10}; /*!> The extra delay of a reordered datagram */
+            std::uint64_t bytesPerSecond = 0;           /*!> The capacity of the link, the packets queueing behind each other (0 for no limit) */
+    };
+}
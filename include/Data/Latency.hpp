@@ -0,0 +1,35 @@
+
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+
+namespace glnet
+{
+    /**
+     * @struct LatencyStats
+     * @brief Represent the distribution of the latencies of a stage, each percentile within about 6% of its true value
+     */
+    struct LatencyStats {
+            std::uint64_t count = 0;          /*!> The number of latencies recorded */
+            std::chrono::nanoseconds min{0};  /*!> The lowest latency */
+            std::chrono::nanoseconds mean{0}; /*!> The mean latency */
+            std::chrono::nanoseconds p50{0};  /*!> The median latency */
+            std::chrono::nanoseconds p90{0};  /*!> The 90th percentile */
+            std::chrono::nanoseconds p99{0};  /*!> The 99th percentile */
+            std::chrono::nanoseconds p999{0}; /*!> The 99.9th percentile */
+            std::chrono::nanoseconds max{0};  /*!> The highest latency */
+    };
+
+    /**
+     * @struct Latency
+     * @brief Represent where the time goes between a message reaching the host and a reply leaving it, stage by stage
+     */
+    struct Latency {
+            LatencyStats kernelReceive; /*!> From the kernel receive timestamp to the read by the I/O thread */
+            LatencyStats dispatch;      /*!> From the read to the entry of the message callback (reassembly, ordering, batching) */
+            LatencyStats callback;      /*!> From the entry to the exit of the message callback */
+            LatencyStats queue;         /*!> From the send call to the I/O thread taking the frame out of its queues */
+            LatencyStats kernelSend;    /*!> From the write on the socket to the kernel send timestamp */
+    };
+}
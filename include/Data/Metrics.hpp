@@ -0,0 +1,59 @@
+
+#pragma once
+
+#include <unordered_map>
+#include <cstdint>
+#include <chrono>
+#include <string>
+
+namespace glnet
+{
+    /**
+     * @struct TrafficMetrics
+     * @brief Represent the traffic of a connection, or of every connection of a transport
+     */
+    struct TrafficMetrics {
+            std::uint64_t bytesIn = 0;       /*!> The number of bytes read */
+            std::uint64_t bytesOut = 0;      /*!> The number of bytes written */
+            std::uint64_t packetsIn = 0;     /*!> The number of frames (tcp) or datagrams (udp) read */
+            std::uint64_t packetsOut = 0;    /*!> The number of frames (tcp) or datagrams (udp) written */
+            std::uint64_t partialReads = 0;  /*!> The number of reads that returned less than asked (tcp) */
+            std::uint64_t partialWrites = 0; /*!> The number of writes the socket took only part of (tcp) */
+            std::uint64_t queuedBytes = 0;   /*!> The number of bytes waiting to be written (tcp) */
+    };
+
+    /**
+     * @struct TransportMetrics
+     * @brief Represent the counters of a transport
+     */
+    struct TransportMetrics {
+            TrafficMetrics total;                                          /*!> The traffic of the transport, closed connections included */
+            std::unordered_map<std::uint32_t, TrafficMetrics> connections; /*!> The traffic of each open connection, by client id */
+            std::uint64_t framesDropped = 0;                               /*!> The number of frames dropped: queue full, deadline over, rate limit, window full or malformed */
+            std::uint64_t queuedFrames = 0;                                /*!> The number of frames held by the scheduler */
+            std::uint64_t accepted = 0;                                    /*!> The number of connections accepted (tcp server) */
+            std::uint64_t rejected = 0;                                    /*!> The number of connections closed by the connection limit (tcp server) */
+            std::uint64_t callbacks = 0;                                   /*!> The number of message callbacks run */
+            std::chrono::nanoseconds callbackTime{0};                      /*!> The time spent in the message callbacks */
+    };
+
+    /**
+     * @struct Metrics
+     * @brief Represent a snapshot of the counters of a Manager
+     */
+    struct Metrics {
+            std::chrono::system_clock::time_point time{}; /*!> The time the snapshot was taken */
+            TransportMetrics tcp;                         /*!> The counters of the tcp transport */
+            TransportMetrics udp;                         /*!> The counters of the udp transport */
+            TransportMetrics local;                       /*!> The counters of the local transport */
+            TransportMetrics shm;                         /*!> The counters of the shm transport */
+            TransportMetrics loopback;                    /*!> The counters of the loopback transport */
+
+            /**
+             * @brief Format the snapshot in the Prometheus text exposition format, every counter labelled with its transport and the per-connection ones with their client id
+             *
+             * @return std::string The formatted snapshot
+             */
+            std::string format() const;
+    };
+}
@@ -0,0 +1,34 @@
+
+#pragma once
+
+#include "Enum/Connection.hpp"
+
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace glnet
+{
+    class Socket;
+
+    /**
+     * @brief A serialized frame (header and body), shared between every client it is sent to
+     */
+    using Frame = std::shared_ptr<const std::vector<std::uint8_t>>;
+
+    /**
+     * @struct Outbound
+     * @brief Represent a frame waiting to be written by an I/O thread
+     */
+    struct Outbound {
+            std::uint32_t clientId;                                           /*!> The id of the destination client (0 for the server on client side) */
+            Frame frame;                                                      /*!> The frame to write */
+            connection::Delivery delivery = connection::Delivery::UNRELIABLE; /*!> The delivery mode (udp only) */
+            std::uint8_t channel = 0;                                         /*!> The channel of the frame (udp only) */
+            connection::Priority priority = connection::Priority::BULK;       /*!> The priority class of the frame */
+            std::chrono::steady_clock::time_point deadline = {};              /*!> The time after which the frame is dropped if it was not written yet (epoch for no limit) */
+            std::chrono::steady_clock::time_point enqueuedAt = {};            /*!> The time the frame was queued, set only while the latency is traced */
+            std::shared_ptr<Socket> descriptor = nullptr;                     /*!> The file descriptor passed along with the frame (local only), closed once sent or dropped */
+    };
+}
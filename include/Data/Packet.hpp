@@ -70,7 +70,7 @@ namespace glnet
             {
                 static_assert(std::is_trivially_copyable_v<T>, "Payload type must be trivially copyable");
 
-                if (bytes.size() < sizeof(T)) {
+                if (bytes.size() < readOffset_ + sizeof(T)) {
                     throw std::runtime_error("Insufficient data to transform into the target type");
                 }
 
@@ -91,6 +91,21 @@ namespace glnet
              */
             Packet& operator>>(std::string& data);
 
+            /**
+             * @brief Skip bytes that were already decoded elsewhere
+             *
+             * @param size The number of bytes to skip
+             * @return Packet& A reference to the packet after the bytes have been skipped
+             */
+            Packet& skip(std::size_t size);
+
+            /**
+             * @brief Serialize the packet into a frame, the length header followed by the bytes
+             *
+             * @return std::vector<std::uint8_t> The serialized frame
+             */
+            std::vector<std::uint8_t> serialize() const;
+
         private:
             std::uint32_t writeOffset_; /*!> The offset used when writing the bytes  */
             std::uint32_t readOffset_;  /*!> The offset used when reading the bytes  */
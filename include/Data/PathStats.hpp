@@ -0,0 +1,20 @@
+
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+
+namespace glnet
+{
+    /**
+     * @struct PathStats
+     * @brief Represent what the congestion controller measured on the path to a udp peer
+     */
+    struct PathStats {
+            std::chrono::microseconds rtt{0};    /*!> The smoothed round trip time */
+            std::chrono::microseconds minRtt{0}; /*!> The lowest round trip time seen recently, the path without queuing */
+            std::chrono::microseconds jitter{0}; /*!> The mean deviation between consecutive round trip times */
+            double loss = 0;                     /*!> The fraction of the reliable datagrams retransmitted, over the last measure of at least 16 transmissions */
+            std::uint64_t targetRate = 0;        /*!> The send rate the path is estimated to sustain, in bytes per second */
+    };
+}
@@ -0,0 +1,16 @@
+
+#pragma once
+
+#include <cstdint>
+
+namespace glnet
+{
+    /**
+     * @struct RateLimit
+     * @brief Represent the parameters of a token bucket
+     */
+    struct RateLimit {
+            std::uint64_t bytesPerSecond = 0; /*!> The sustained rate (0 for no limit) */
+            std::uint64_t burst = 0;          /*!> The number of bytes that can be sent at once after an idle period (0 for one second of traffic) */
+    };
+}
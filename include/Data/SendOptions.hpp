@@ -0,0 +1,21 @@
+
+#pragma once
+
+#include "Enum/Connection.hpp"
+
+#include <cstdint>
+#include <chrono>
+
+namespace glnet
+{
+    /**
+     * @struct SendOptions
+     * @brief Represent how a packet should be sent
+     */
+    struct SendOptions {
+            connection::Delivery delivery = connection::Delivery::UNRELIABLE; /*!> The delivery mode of the packet (udp only, tcp is always reliable and ordered) */
+            std::uint8_t channel = 0;                                         /*!> The channel of the packet, each channel is sequenced independently (udp only) */
+            connection::Priority priority = connection::Priority::BULK;       /*!> The priority class of the packet */
+            std::chrono::milliseconds lifetime{0};                            /*!> The time after which the packet is dropped if it was not written yet (0 for no limit) */
+    };
+}
@@ -0,0 +1,17 @@
+
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+
+namespace glnet
+{
+    /**
+     * @struct ShmOptions
+     * @brief Represent the settings of the shared memory connections
+     */
+    struct ShmOptions {
+            std::size_t capacity = 1024 * 1024; /*!> The size of the ring of each direction, a power of two chosen by the client which creates the memory (the largest frame is half of it) */
+            std::chrono::microseconds spin{0};  /*!> The time the shm thread keeps reading the rings after the last frame before it sleeps on the doorbells (threaded mode, 0 to sleep at once, worth it only with a core to spare) */
+    };
+}
@@ -0,0 +1,20 @@
+
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+
+namespace glnet
+{
+    /**
+     * @struct Tick
+     * @brief Represent one run of a fixed-rate tick callback
+     */
+    struct Tick {
+            std::uint64_t index = 0;                           /*!> The number of periods elapsed since the tick was added, skipped ones included */
+            std::chrono::steady_clock::time_point scheduled{}; /*!> The time this run was due, a whole number of periods after the first one */
+            std::chrono::nanoseconds lateness{0};              /*!> How long after its due time this run started */
+            std::uint64_t missed = 0;                          /*!> The periods skipped right before this run because the loop fell behind */
+            std::uint64_t overruns = 0;                        /*!> The periods skipped since the tick was added */
+    };
+}
@@ -0,0 +1,17 @@
+
+#pragma once
+
+#include <chrono>
+
+namespace glnet
+{
+    /**
+     * @struct Timeouts
+     * @brief Represent the deadlines of the tcp connections, each one disabled at 0
+     */
+    struct Timeouts {
+            std::chrono::milliseconds idle{0};      /*!> The time without receiving anything after which a client is disconnected (server side) */
+            std::chrono::milliseconds heartbeat{0}; /*!> The time without sending anything after which an empty frame is sent, keeping the peer's idle timer from firing */
+            std::chrono::milliseconds connect{0};   /*!> The time a connection to the server may take before it fails (client side) */
+    };
+}
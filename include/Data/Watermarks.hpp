@@ -0,0 +1,19 @@
+
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+
+namespace glnet
+{
+    /**
+     * @struct Watermarks
+     * @brief Represent the outbound byte thresholds of a connection
+     */
+    struct Watermarks {
+            std::size_t low = 256 * 1024;                     /*!> The queued bytes below which a congested connection is writable again */
+            std::size_t high = 1024 * 1024;                   /*!> The queued bytes above which a connection is congested */
+            std::size_t hardLimit = 0;                        /*!> The queued bytes above which a connection is dropped after hardLimitTimeout (0 to never drop) */
+            std::chrono::milliseconds hardLimitTimeout{5000}; /*!> The time a connection may stay above the hard limit */
+    };
+}
@@ -8,8 +8,20 @@ namespace glnet::connection
      * @brief Connection types
      */
     enum class Type {
-        TCP, /*!> TCP connection type */
-        UDP, /*!> UDP connection type */
+        TCP,      /*!> TCP connection type */
+        UDP,      /*!> UDP connection type */
+        LOCAL,    /*!> Unix domain socket connection type, framed like tcp, for the services of a same host */
+        SHM,      /*!> Shared memory connection type, a ring per direction, for the processes of a same host */
+        LOOPBACK, /*!> In-memory connection type between the managers of a same process, for tests and simulations */
+    };
+
+    /**
+     * @enum Local socket modes
+     * @brief Socket types of the local connections
+     */
+    enum class LocalMode {
+        STREAM,    /*!> SOCK_STREAM, the frames are read like on tcp */
+        SEQPACKET, /*!> SOCK_SEQPACKET, each frame is a record read by a single call, up to the size of the socket buffer */
     };
 
     /**
@@ -20,4 +32,54 @@ namespace glnet::connection
         CLIENT, /*!> Client side */
         SERVER, /*!> Server side */
     };
+
+    /**
+     * @enum Directions
+     * @brief Direction of the traffic of a connection, seen from the local end
+     */
+    enum class Direction {
+        INBOUND,  /*!> Received from the peer */
+        OUTBOUND, /*!> Sent to the peer */
+    };
+
+    /**
+     * @enum Delivery modes
+     * @brief Delivery modes of the udp messages (ignored for tcp)
+     */
+    enum class Delivery {
+        UNRELIABLE,           /*!> Fire and forget, messages may be lost, duplicated or reordered */
+        RELIABLE_ORDERED,     /*!> Messages are acknowledged, retransmitted and delivered once, in order, per channel */
+        UNRELIABLE_SEQUENCED, /*!> Messages may be lost, but a message older than the last one received on its channel is dropped */
+    };
+
+    /**
+     * @enum Priority classes
+     * @brief Priority classes of the outbound messages, each connection sharing its link between them
+     */
+    enum class Priority {
+        CONTROL,  /*!> Small latency-critical messages (handshakes, chat, commands), served first */
+        REALTIME, /*!> Frequent state updates, usually sent with a lifetime after which they are dropped */
+        BULK,     /*!> Large transfers (assets, snapshots), served with the remaining bandwidth */
+        COUNT,    /*!> The number of priority classes */
+    };
+
+    /**
+     * @enum Send results
+     * @brief Outcome of a send request
+     */
+    enum class SendResult {
+        QUEUED,    /*!> The packet was queued */
+        CONGESTED, /*!> The packet was queued, but the connection is above its high watermark and the producer should slow down */
+        FAILED,    /*!> The packet was not queued (unknown client, missing connection or full queue) */
+    };
+
+    /**
+     * @enum Overflow policies
+     * @brief What to do with a frame that exceeds its rate limit
+     */
+    enum class Overflow {
+        DEFER,      /*!> Keep the frame until the bucket refills */
+        DROP,       /*!> Drop the frame */
+        DOWNSAMPLE, /*!> Drop the realtime frames, which are superseded by the next update, and keep the others until the bucket refills */
+    };
 }
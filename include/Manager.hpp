@@ -1,30 +1,68 @@
 
 #pragma once
 
+#include "Coroutine/Connection.hpp"
 #include "Enum/Connection.hpp"
-#include "Utils/Singleton.hpp"
 #include "Protocol/Tcp.hpp"
 #include "Protocol/Udp.hpp"
+#include "Protocol/Shm.hpp"
+#include "Protocol/Loopback.hpp"
+#include "Utils/TimerQueue.hpp"
+#include "Utils/Capture.hpp"
+#include "Utils/Wakeup.hpp"
+#include "Utils/Ring.hpp"
+#include "Data/SendOptions.hpp"
+#include "Data/RateLimit.hpp"
+#include "Data/Impairment.hpp"
+#include "Data/Watermarks.hpp"
+#include "Data/ShmOptions.hpp"
+#include "Data/ConnectionLimits.hpp"
+#include "Data/Timeouts.hpp"
+#include "Data/PathStats.hpp"
+#include "Data/Tick.hpp"
+#include "Data/Metrics.hpp"
+#include "Data/Latency.hpp"
 #include "Data/Packet.hpp"
 #include "Callback.hpp"
 
 #include <unordered_map>
+#include <shared_mutex>
 #include <functional>
+#include <optional>
+#include <coroutine>
 #include <cstdint>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
-#include <queue>
 
 #define LOCALHOST "127.0.0.1"
 
 namespace glnet
 {
-    class Manager : public utils::Singleton<Manager>
+    class Manager
     {
         public:
             /**
-             * @brief Construct a new Network Manager object
+             * @enum Mode
+             * @brief The threading modes of the Manager
+             */
+            enum class Mode {
+                THREADED, /*!> The Manager runs its own main, tcp and udp threads */
+                POLLED,   /*!> No thread is created, the application drives the Manager with poll */
+            };
+
+            /**
+             * @brief Identifier of a timer of the Manager
+             */
+            using TimerId = utils::TimerQueue::Id;
+
+            static constexpr std::size_t DEFAULT_CAPTURE_CAPACITY = 256 * 1024 * 1024; /*!> The default size of a capture file */
+
+            /**
+             * @brief Construct a new Network Manager object, every instance is independent from the others
              */
             Manager();
 
@@ -33,18 +71,80 @@ namespace glnet
              */
             ~Manager();
 
+            /**
+             * @brief Delete the copy constructor of the Manager class
+             */
+            Manager(const Manager&) = delete;
+
+            /**
+             * @brief Delete the assignement operator of the Manager class
+             */
+            Manager& operator=(const Manager&) = delete;
+
             /**
              * @brief Initialize the Manager
              *
              * @param side The side of the connection (client or server)
+             * @param mode The threading mode of the Manager
              */
-            void initialize(connection::Side side);
+            void initialize(connection::Side side, Mode mode = Mode::THREADED);
 
             /**
              * @brief Stop the Manager
              */
             void stop();
 
+            /**
+             * @brief Wait for network events, then dispatch the callbacks and write the queued packets on the calling thread (only in polled mode)
+             *
+             * @param timeout The maximum time to wait in milliseconds (-1 for infinite, 0 to return immediately)
+             * @return std::int32_t The number of file descriptors that had events
+             */
+            std::int32_t poll(std::int32_t timeout);
+
+            /**
+             * @brief Service the network on the calling thread until the given deadline (only in polled mode)
+             *
+             * @param deadline The time at which to return
+             * @return std::int32_t The number of file descriptors that had events
+             */
+            std::int32_t pollUntil(std::chrono::steady_clock::time_point deadline);
+
+            /**
+             * @brief Add a one-shot timer to the event loop, run on the main thread (threaded mode) or inside poll (polled mode)
+             *
+             * @param delay The time before the callback runs
+             * @param callback The function called once
+             * @return TimerId The identifier of the timer
+             */
+            TimerId addTimer(std::chrono::nanoseconds delay, std::function<void()> callback);
+
+            /**
+             * @brief Add a periodic timer to the event loop, re-armed an interval after each run returns
+             *
+             * @param interval The time between the end of a run and the start of the next one
+             * @param callback The function called on every run
+             * @return TimerId The identifier of the timer
+             */
+            TimerId addPeriodicTimer(std::chrono::nanoseconds interval, std::function<void()> callback);
+
+            /**
+             * @brief Add a fixed-rate tick to the event loop, due a whole number of periods after its first run so it does not drift, the periods the loop fell behind on are skipped and reported as overruns
+             *
+             * @param period The time between two due times
+             * @param callback The function called on every run with its index, lateness and overruns
+             * @return TimerId The identifier of the timer
+             */
+            TimerId addTick(std::chrono::nanoseconds period, std::function<void(const Tick&)> callback);
+
+            /**
+             * @brief Cancel a timer or a tick of the event loop
+             *
+             * @param id The identifier of the timer
+             * @return true if the timer was pending, false otherwise
+             */
+            bool cancelTimer(TimerId id);
+
             /**
              * @brief Create a Connection object
              *
@@ -54,34 +154,273 @@ namespace glnet
             void createConnection(connection::Type type, Endpoint endpoint = Endpoint{"", 0});
 
             /**
-             * @brief Connect to the server (only for client side)
+             * @brief Set the socket type of the local connection, before it is created (stream by default)
+             *
+             * @param mode The socket type: stream, or seqpacket to read each frame with a single call
+             */
+            void setLocalMode(connection::LocalMode mode);
+
+            /**
+             * @brief Set the size of the rings and the spin time of the shm connection, before it is created (the size is chosen by the client)
+             *
+             * @param options The shared memory settings
+             */
+            void setShmOptions(ShmOptions options);
+
+            /**
+             * @brief Connect to the server (only for client side), a local connection using the address of the server endpoint as socket path
              */
             void connectToServer();
 
             /**
-             * @brief Send a packet to the server
+             * @brief Connect to a server from a coroutine (only for client side, the tcp connection must be created)
+             *
+             * @param endpoint The endpoint of the server
+             * @return ConnectAwaiter The awaitable resuming on the tcp thread with the connection to the server, throws if the connection failed
+             */
+            ConnectAwaiter connect(Endpoint endpoint);
+
+            /**
+             * @brief Route the packets of a client to a coroutine connection instead of the message callbacks
+             *
+             * @param clientId The id of the client (0 for the server on client side)
+             * @param type The type of connection used to send on the connection
+             * @return Connection The connection to await on
+             */
+            Connection attach(std::uint32_t clientId, connection::Type type = connection::Type::TCP);
+
+            /**
+             * @brief Queue a packet to be sent to the server, never blocks and is safe to call from any thread
              *
              * @param type The type of connection to use
              * @param packet The packet to send
+             * @param options The delivery mode, channel, priority class and lifetime of the packet
+             * @return connection::SendResult QUEUED, CONGESTED if the outbound backlog is above the high watermark, FAILED if the packet was not queued
              */
-            void sendToServer(connection::Type type, Packet& packet);
+            connection::SendResult sendToServer(connection::Type type, Packet& packet, SendOptions options = {});
 
             /**
-             * @brief Send a packet to the clients
+             * @brief Queue a packet to be sent to the clients, never blocks and is safe to call from any thread
              *
              * @param type The type of connection to use
              * @param ids The ids of the clients to send to
              * @param packet The packet to send
+             * @param options The delivery mode, channel, priority class and lifetime of the packet
+             * @return connection::SendResult The worst result among the clients
+             */
+            connection::SendResult sendToClients(connection::Type type, std::vector<std::uint32_t> ids, Packet& packet, SendOptions options = {});
+
+            /**
+             * @brief Queue a packet with a file descriptor to be passed to a peer over the local connection (SCM_RIGHTS, Unix only), to hand an accepted connection to a worker process for instance
+             *
+             * @param clientId The id of the client (0 for the server on client side)
+             * @param fd The file descriptor to pass, duplicated so the caller may close it at once
+             * @param packet The packet sent along with the descriptor, given to onDescriptorReception on the other side
+             * @param options The priority class and lifetime of the packet
+             * @return connection::SendResult QUEUED, CONGESTED if the outbound backlog is above the high watermark, FAILED if the packet was not queued
+             */
+            connection::SendResult sendDescriptor(std::uint32_t clientId, Socket::Fd fd, Packet& packet, SendOptions options = {});
+
+            /**
+             * @brief Serve an already connected socket as a new client, like an accepted one, a descriptor received from a front process for instance (only for server side, safe to call from any thread)
+             *
+             * @param type The type of the socket (tcp or local), whose connection must be created, without endpoint if it should not listen
+             * @param fd The socket, owned by the Manager from now on
+             * @return true if the socket was queued, false if the queue is full
+             */
+            bool adoptClient(connection::Type type, Socket::Fd fd);
+
+            /**
+             * @brief Limit the bandwidth used to send to a client (0 for the server on client side), overriding the default limit
+             *
+             * @param type The type of connection to limit
+             * @param clientId The id of the client
+             * @param limit The rate and burst of the client (a rate of 0 removes the limit)
+             */
+            void setRateLimit(connection::Type type, std::uint32_t clientId, RateLimit limit);
+
+            /**
+             * @brief Limit the bandwidth used to send to each client without a limit of its own
+             *
+             * @param type The type of connection to limit
+             * @param limit The rate and burst of each client (a rate of 0 removes the limit)
+             */
+            void setDefaultRateLimit(connection::Type type, RateLimit limit);
+
+            /**
+             * @brief Limit the bandwidth used to send to all the clients together
+             *
+             * @param type The type of connection to limit
+             * @param limit The rate and burst of the connection (a rate of 0 removes the limit)
+             */
+            void setGlobalRateLimit(connection::Type type, RateLimit limit);
+
+            /**
+             * @brief Set what to do with the packets exceeding a rate limit (deferred by default)
+             *
+             * @param type The type of connection
+             * @param overflow The overflow policy
+             */
+            void setOverflowPolicy(connection::Type type, connection::Overflow overflow);
+
+            /**
+             * @brief Get the number of times the rate limits were hit
+             *
+             * @param type The type of connection
+             * @return RateLimiter::Counters The counters
+             */
+            RateLimiter::Counters getRateLimitCounters(connection::Type type);
+
+            /**
+             * @brief Set the outbound watermarks of the tcp and local connections, crossing the high watermark calls onBackpressure and draining below the low one calls onWritable
+             *
+             * @param watermarks The low and high watermarks, and the hard limit above which a client is disconnected
+             */
+            void setWatermarks(Watermarks watermarks);
+
+            /**
+             * @brief Set the admission control of the tcp and local servers: the connection limit, above which new clients are closed at once, and the number of connections accepted per loop iteration
+             *
+             * @param limits The connection limit and the accept budget
+             */
+            void setConnectionLimits(ConnectionLimits limits);
+
+            /**
+             * @brief Get the number of tcp and local connections closed because the server reached its connection limit
+             *
+             * @return std::uint64_t The number of rejected connections
+             */
+            std::uint64_t getRejectedConnections();
+
+            /**
+             * @brief Set the deadlines of the tcp and local connections: the server disconnects the clients idle for longer than the idle timeout, both sides send an empty frame after a heartbeat interval without traffic, and the client gives up connecting after the connect timeout
+             *
+             * @param timeouts The idle timeout, heartbeat interval and connect timeout, zero disabling each of them
              */
-            void sendToClients(connection::Type type, std::vector<std::uint32_t> ids, Packet& packet);
+            void setTimeouts(Timeouts timeouts);
+
+            /**
+             * @brief Cap the udp send rate of each peer at the rate its congestion controller estimates from the rtt, jitter and loss of the reliable channels
+             *
+             * @param enable If the estimated rates are enforced (they are measured either way)
+             */
+            void setAdaptiveRate(bool enable);
+
+            /**
+             * @brief Get the rtt, jitter, loss and target send rate measured on the udp path to a peer, to scale the snapshot rate or detail level
+             *
+             * @param clientId The id of the client (0 for the server on client side)
+             * @return std::optional<PathStats> The statistics of the path, std::nullopt if nothing was measured yet
+             */
+            std::optional<PathStats> getPathStats(std::uint32_t clientId);
+
+            /**
+             * @brief Take a snapshot of the traffic, drop, queue, accept and callback counters of the transports and of their connections, without stopping the I/O threads
+             *
+             * @return Metrics The counters, zero for the transports not created
+             */
+            Metrics getMetrics();
+
+            /**
+             * @brief Write a snapshot of the counters to a file in the Prometheus text format, replacing it atomically so a scraper never reads it half written
+             *
+             * @param path The path of the file
+             */
+            void writeMetrics(const std::string& path);
+
+            /**
+             * @brief Trace the latency of a transport stage by stage, from the kernel receive timestamp to the message callback and from the send call to the kernel send timestamp (the kernel stages need SO_TIMESTAMPING, Linux only)
+             *
+             * @param type The type of the connection
+             * @param enable If the latency should be traced
+             */
+            void setLatencyTracing(connection::Type type, bool enable);
+
+            /**
+             * @brief Get the latency histograms of a transport, to tell whether the time goes to the kernel, the I/O thread or the application
+             *
+             * @param type The type of the connection
+             * @return Latency The count, mean and percentiles of each stage
+             */
+            Latency getLatency(connection::Type type);
+
+            /**
+             * @brief Start recording every frame sent and received, with its time, client id, direction and transport, to a memory-mapped file
+             *
+             * @param path The path of the capture file, truncated if it exists
+             * @param capacity The size of the file, the frames that do not fit are dropped
+             */
+            void startCapture(const std::string& path, std::size_t capacity = DEFAULT_CAPTURE_CAPACITY);
+
+            /**
+             * @brief Stop recording and truncate the capture file to the frames written
+             */
+            void stopCapture();
+
+            /**
+             * @brief Get the number of frames the capture dropped because its file was full
+             *
+             * @return std::uint64_t The number of frames
+             */
+            std::uint64_t getCaptureDropped() const;
+
+            /**
+             * @brief Simulate the network conditions of the link to a client in one direction (0 for the server on client side), overriding the default impairment
+             *
+             * @param type The type of connection to impair (tcp only applies the latency, jitter and bandwidth)
+             * @param direction The direction to impair
+             * @param clientId The id of the client
+             * @param impairment The latency, jitter, loss, duplication, reordering and bandwidth of the link
+             */
+            void setImpairment(connection::Type type, connection::Direction direction, std::uint32_t clientId, Impairment impairment);
+
+            /**
+             * @brief Simulate the network conditions of the links to the clients without an impairment of their own
+             *
+             * @param type The type of connection to impair (tcp only applies the latency, jitter and bandwidth)
+             * @param direction The direction to impair
+             * @param impairment The latency, jitter, loss, duplication, reordering and bandwidth of each link
+             */
+            void setDefaultImpairment(connection::Type type, connection::Direction direction, Impairment impairment);
+
+            /**
+             * @brief Remove every impairment of a connection, the packets held being released at once
+             *
+             * @param type The type of connection
+             */
+            void clearImpairments(connection::Type type);
+
+            /**
+             * @brief Get the number of packets the impairments delayed, dropped, duplicated and reordered
+             *
+             * @param type The type of connection
+             * @return Impairer::Counters The counters
+             */
+            Impairer::Counters getImpairmentCounters(connection::Type type);
+
+            /**
+             * @brief Drop a fraction of the outgoing udp datagrams, to exercise the reliable channels on a lossless network (the loss of the default outbound udp impairment)
+             *
+             * @param probability The probability of dropping a datagram, between 0 and 1
+             */
+            void setSimulatedLoss(double probability);
 
             /**
              * @brief Handler of the callbacks
              *
              * @param callback The type of the callback
              * @param socket The socket of the client
+             * @param type The type of the connection (tcp, local or shm)
              */
-            void callbackHandler(Callback::Type callback, Socket& socket);
+            void callbackHandler(Callback::Type callback, Socket& socket, connection::Type type = connection::Type::TCP);
+
+            /**
+             * @brief Handler of the callbacks of the connections without socket
+             *
+             * @param callback The type of the callback
+             * @param type The type of the connection (loopback)
+             */
+            void callbackHandler(Callback::Type callback, connection::Type type);
 
             /**
              * @brief Handler of the callbacks
@@ -101,6 +440,16 @@ namespace glnet
              */
             void callbackHandler(Callback::Type callback, connection::Type type, std::uint32_t id, Packet& packet);
 
+            /**
+             * @brief Handler of the callbacks
+             *
+             * @param callback The type of the callback
+             * @param id The id of the client
+             * @param descriptor The received file descriptor, closed if no callback takes it
+             * @param packet The packet received with the descriptor
+             */
+            void callbackHandler(Callback::Type callback, std::uint32_t id, Socket::Fd descriptor, Packet& packet);
+
             /**
              * @brief Get the Client Socket By object
              *
@@ -121,6 +470,14 @@ namespace glnet
             template <typename T>
             std::uint32_t getClientIdBy(T& ref);
 
+            /**
+             * @brief Find the socket of a client, keeping it alive while the caller uses it
+             *
+             * @param id The id of the client
+             * @return std::shared_ptr<Socket> The socket of the client, or nullptr if it is not connected
+             */
+            std::shared_ptr<Socket> findClient(std::uint32_t id);
+
             /**
              * @brief Set the server endpoint (only for client side)
              *
@@ -128,6 +485,20 @@ namespace glnet
              */
             void setServerEndpoint(Endpoint endpoint);
 
+            /**
+             * @brief Get the server endpoint (only for client side)
+             *
+             * @return const Endpoint& The endpoint of the server
+             */
+            const Endpoint& getServerEndpoint() const;
+
+            /**
+             * @brief Get the side of the Manager
+             *
+             * @return connection::Side The side of the connection (client or server)
+             */
+            connection::Side getSide() const;
+
             /**
              * @brief Get the Callback Handler object
              *
@@ -141,43 +512,135 @@ namespace glnet
              * @brief Represent the server information
              */
             struct Server {
-                    std::unordered_map<std::uint32_t, std::shared_ptr<Socket>> clients; /*!> The map of the clients connected via the tcp socket */
-                    std::uint32_t nextClientId;                                         /*!> The next id to give to a client */
+                    std::unordered_map<std::uint32_t, std::shared_ptr<Socket>> clients; /*!> The map of the clients, by id (nullptr for the loopback clients, which have no socket) */
+                    std::uint32_t nextClientId = 0;                                     /*!> The next id to give to a client */
             } server_; /*!> The server information (only for server side) */
 
+            std::shared_mutex clientsMutex_; /*!> Guard of the clients map, only taken by the I/O threads */
+
             /**
              * @struct Client
              * @brief Represent the client information
              */
             struct Client {
-                    Endpoint server;          /*!> The endpoint of the server */
+                    Endpoint server;                /*!> The endpoint of the server */
                     std::shared_ptr<Socket> socket; /*!> The client connection information */
                     std::uint32_t clientPort;       /*!> The port of the client */
             } client_;  /*!> The client information (only for client side) */
 
             /**
-             * @brief The main loop of the Manager
+             * @brief The main loop of the Manager (threaded mode)
              */
             void run();
 
+            /**
+             * @brief Notify the disconnected clients and remove them from the clients map
+             */
+            void processDisconnections();
+
+            /**
+             * @brief Register a new connection and run the connection callback
+             *
+             * @param socket The socket of the connection, nullptr for a loopback connection
+             * @param type The type of the connection
+             */
+            void registerConnection(std::shared_ptr<Socket> socket, connection::Type type);
+
+            /**
+             * @brief Check if a client is connected, whether or not it has a socket
+             *
+             * @param id The id of the client
+             * @return true if the client is in the clients map, false otherwise
+             */
+            bool hasClient(std::uint32_t id);
+
             /**
              * @brief Get an available port for the client (only for client side)
              */
             std::uint16_t getAvailablePort();
 
-            friend class Singleton<Manager>; /*!> Friend class to allow access to the private constructor and destructor */
+            /**
+             * @brief Serialize a packet into a frame shared by every destination, with its send options
+             *
+             * @param packet The packet to send
+             * @param options The options of the packet
+             * @return Outbound The frame, without destination
+             */
+            Outbound makeOutbound(Packet& packet, const SendOptions& options);
+
+            /**
+             * @brief Queue a frame on a connection
+             *
+             * @param type The type of connection to use
+             * @param outbound The frame and its destination
+             * @return connection::SendResult The result of the queueing
+             */
+            connection::SendResult enqueue(connection::Type type, Outbound outbound);
 
-            bool running_;                /*!> If the Manager is running */
-            std::thread mainThread_;      /*!> The main thread of the Manager */
-            connection::Side side_; /*!> The side of the connection (client or server) */
+            /**
+             * @brief Hand a received packet to the coroutine attached to its client, or to the message callbacks
+             *
+             * @param type The type of the connection
+             * @param id The id of the client
+             * @param packet The received message
+             */
+            void dispatchMessage(connection::Type type, std::uint32_t id, Packet& packet);
+
+            /**
+             * @brief Get the rate limiter of a connection
+             *
+             * @param type The type of connection
+             * @return RateLimiter& The rate limiter, throws if the connection was not created
+             */
+            RateLimiter& getRateLimiter(connection::Type type);
+
+            /**
+             * @brief Get the impairer of a connection
+             *
+             * @param type The type of connection
+             * @return Impairer& The impairer, throws if the connection was not created
+             */
+            Impairer& getImpairer(connection::Type type);
+
+            friend class ConnectAwaiter; /*!> Friend class to allow the registration of the connecting coroutine */
+
+            std::atomic<bool> running_; /*!> If the Manager is running */
+            std::thread mainThread_;    /*!> The main thread of the Manager */
+            connection::Side side_;     /*!> The side of the connection (client or server) */
+            Mode mode_;                 /*!> The threading mode of the Manager */
 
             std::shared_ptr<Tcp> tcp_; /*!> The tcp instance */
-            std::thread tcpThread_;              /*!> The tcp thread */
+            bool tcpActive_;           /*!> If the tcp instance is serving (listening or connecting) */
+            std::thread tcpThread_;    /*!> The tcp thread */
             std::shared_ptr<Udp> udp_; /*!> The udp instance */
-            std::thread udpThread_;              /*!> The udp thread */
+            std::thread udpThread_;    /*!> The udp thread */
+
+            std::shared_ptr<Tcp> local_;      /*!> The local instance, a tcp instance over unix domain sockets */
+            bool localActive_;                /*!> If the local instance is serving (listening or connecting) */
+            std::thread localThread_;         /*!> The local thread */
+            connection::LocalMode localMode_; /*!> The socket type of the local instance */
+
+            std::shared_ptr<Shm> shm_; /*!> The shm instance, shared memory rings with a unix domain socket for the handshake and the doorbells */
+            bool shmActive_;           /*!> If the shm instance is serving (listening or connected) */
+            std::thread shmThread_;    /*!> The shm thread */
+            ShmOptions shmOptions_;    /*!> The settings of the shm instance */
+
+            std::shared_ptr<Loopback> loopback_; /*!> The loopback instance, in-memory queues to the managers of the process */
+            bool loopbackActive_;                /*!> If the loopback instance is serving (listening or connected) */
+            std::thread loopbackThread_;         /*!> The loopback thread */
+
+            std::vector<Socket::PollFd> pollFds_; /*!> The merged pollfd array of the tcp, local, shm, loopback and udp instances (polled mode) */
 
             Callback callbacks_; /*!> The callback handler */
 
-            std::queue<std::uint16_t> disconnectionQueue_; /*!> The queue of disconnections to process */
+            utils::Ring<std::uint32_t> disconnectionQueue_; /*!> The queue of disconnections to process */
+            utils::Wakeup disconnectionWakeup_;             /*!> The wakeup signaled when a disconnection is queued */
+            utils::TimerQueue timers_;                      /*!> The timers and ticks of the event loop */
+            utils::Capture capture_;                        /*!> The recording of the frames sent and received */
+
+            std::unordered_map<std::uint32_t, std::shared_ptr<Mailbox>> mailboxes_; /*!> The mailboxes of the clients attached to a coroutine connection */
+            std::mutex mailboxesMutex_;                                             /*!> Guard of the mailboxes map */
+            std::coroutine_handle<> connectWaiter_;                                 /*!> The coroutine waiting for the connection to the server */
+            bool *connectFailed_ = nullptr;                                         /*!> The flag to set if the connection to the server failed */
     };
 }
@@ -0,0 +1,104 @@
+
+#pragma once
+
+#include "Data/PathStats.hpp"
+#include "Data/RateLimit.hpp"
+
+#include <cstdint>
+#include <chrono>
+
+namespace glnet
+{
+    class CongestionControl
+    {
+        public:
+            /**
+             * @brief Clock used to time the rate updates
+             */
+            using Clock = std::chrono::steady_clock;
+
+            static constexpr std::uint64_t MIN_RATE = 16 * 1024;                /*!> The lowest target rate, in bytes per second */
+            static constexpr std::uint64_t MAX_RATE = 64 * 1024 * 1024;         /*!> The highest target rate, in bytes per second */
+            static constexpr std::uint64_t INITIAL_RATE = 256 * 1024;           /*!> The target rate before any feedback, in bytes per second */
+            static constexpr std::chrono::milliseconds UPDATE_INTERVAL{100};    /*!> The shortest time between two rate updates (one rtt if longer) */
+            static constexpr std::chrono::milliseconds MIN_RTT_WINDOW{10000};   /*!> The time after which the lowest rtt is measured again, to follow route changes */
+            static constexpr std::chrono::microseconds MIN_QUEUING_DELAY{5000}; /*!> The queuing delay always tolerated above the lowest rtt */
+            static constexpr std::chrono::milliseconds BURST{100};              /*!> The traffic sent at once after an idle period, as a duration at the target rate */
+            static constexpr std::uint32_t MIN_LOSS_SAMPLES = 16;               /*!> The reliable transmissions counted before the loss is measured, carried over several intervals if needed */
+            static constexpr double LOSS_THRESHOLD = 0.05;                      /*!> The loss above which the rate decreases */
+            static constexpr double DELAY_DECREASE = 0.85;                      /*!> The factor applied to the rate when the queuing delay grows */
+            static constexpr double INCREASE = 1.05;                            /*!> The factor applied to the rate when the path shows no congestion */
+
+            /**
+             * @brief Construct a new CongestionControl object
+             *
+             * @param now The current time
+             */
+            explicit CongestionControl(Clock::time_point now);
+
+            /**
+             * @brief Account a datagram written to the peer
+             *
+             * @param size The size of the datagram
+             */
+            void onSent(std::size_t size);
+
+            /**
+             * @brief Account a transmission of a reliable datagram, whose retransmissions are taken as losses
+             *
+             * @param retransmission If the datagram was sent before
+             */
+            void onTransmission(bool retransmission);
+
+            /**
+             * @brief Feed a round trip time sample, taken from an acknowledgement
+             *
+             * @param sample The round trip time of a datagram acknowledged without retransmission
+             * @param now The current time
+             */
+            void onRtt(std::chrono::microseconds sample, Clock::time_point now);
+
+            /**
+             * @brief Update the target rate once per interval: decrease it if the loss or the queuing delay grows, increase it if the peer used it
+             *
+             * @param now The current time
+             * @return true if the interval elapsed and the statistics changed, false otherwise
+             */
+            bool update(Clock::time_point now);
+
+            /**
+             * @brief Get the send rate the path is estimated to sustain
+             *
+             * @return std::uint64_t The target rate in bytes per second
+             */
+            std::uint64_t getRate() const;
+
+            /**
+             * @brief Get the token bucket enforcing the target rate
+             *
+             * @return RateLimit The target rate and its burst
+             */
+            RateLimit getLimit() const;
+
+            /**
+             * @brief Get the measurements of the path
+             *
+             * @return PathStats The statistics of the path
+             */
+            PathStats getStats() const;
+
+        private:
+            double rate_ = INITIAL_RATE;           /*!> The target rate in bytes per second */
+            std::chrono::microseconds srtt_{0};    /*!> The smoothed round trip time */
+            std::chrono::microseconds lastRtt_{0}; /*!> The previous round trip time sample */
+            std::chrono::microseconds minRtt_{0};  /*!> The lowest round trip time of the window */
+            Clock::time_point minRttAt_;           /*!> The time the lowest round trip time was sampled */
+            std::chrono::microseconds jitter_{0};  /*!> The mean deviation between consecutive samples (RFC 3550) */
+            double loss_ = 0;                      /*!> The loss of the last interval */
+            Clock::time_point intervalStart_;      /*!> The start of the current interval */
+            std::uint64_t bytesSent_ = 0;          /*!> The bytes written during the interval */
+            std::uint32_t transmissions_ = 0;      /*!> The reliable transmissions since the loss was last measured */
+            std::uint32_t retransmissions_ = 0;    /*!> The reliable retransmissions since the loss was last measured */
+            std::uint32_t samples_ = 0;            /*!> The rtt samples of the interval */
+    };
+}
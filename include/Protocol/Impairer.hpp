@@ -0,0 +1,174 @@
+
+#pragma once
+
+#include "Enum/Connection.hpp"
+#include "Data/Impairment.hpp"
+
+#include <unordered_map>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <array>
+#include <mutex>
+
+namespace glnet
+{
+    class Impairer
+    {
+        public:
+            /**
+             * @brief Clock of the release times
+             */
+            using Clock = std::chrono::steady_clock;
+
+            static constexpr std::size_t MAX_COPIES = 2;                      /*!> The highest number of copies of a packet, when it is duplicated */
+            static constexpr std::chrono::milliseconds MAX_QUEUE_DELAY{1000}; /*!> The longest wait behind a bandwidth cap before a datagram is dropped */
+
+            /**
+             * @struct Plan
+             * @brief What happens to a packet: the time each of its copies is released
+             */
+            struct Plan {
+                    std::size_t copies;                           /*!> The number of copies to release (0 if the packet is dropped) */
+                    std::array<Clock::time_point, MAX_COPIES> at; /*!> The release time of each copy */
+            };
+
+            /**
+             * @struct Counters
+             * @brief The number of packets impaired
+             */
+            struct Counters {
+                    std::uint64_t delayed;    /*!> The number of packets that went through the impairment */
+                    std::uint64_t dropped;    /*!> The number of datagrams lost or dropped behind a bandwidth cap */
+                    std::uint64_t duplicated; /*!> The number of datagrams delivered twice */
+                    std::uint64_t reordered;  /*!> The number of datagrams held back to be overtaken */
+            };
+
+            /**
+             * @brief Construct a new Impairer object, disabled
+             *
+             * @param stream If the transport is a stream, whose packets are never lost, duplicated or reordered
+             */
+            Impairer(bool stream);
+
+            /**
+             * @brief Set the impairment of a client, overriding the default one (safe to call from any thread)
+             *
+             * @param direction The direction to impair
+             * @param clientId The id of the client (0 for the server on client side)
+             * @param impairment The conditions of the link
+             */
+            void setClientImpairment(connection::Direction direction, std::uint32_t clientId, Impairment impairment);
+
+            /**
+             * @brief Set the impairment of the clients without an impairment of their own (safe to call from any thread)
+             *
+             * @param direction The direction to impair
+             * @param impairment The conditions of the link
+             */
+            void setDefaultImpairment(connection::Direction direction, Impairment impairment);
+
+            /**
+             * @brief Get the impairment of the clients without an impairment of their own (safe to call from any thread)
+             *
+             * @param direction The direction
+             * @return Impairment The conditions of the link
+             */
+            Impairment getDefaultImpairment(connection::Direction direction);
+
+            /**
+             * @brief Remove every impairment, the packets held being released at the next refresh (safe to call from any thread)
+             */
+            void clear();
+
+            /**
+             * @brief Apply the settings changed since the last call, called by the I/O thread before each loop iteration
+             */
+            void refresh();
+
+            /**
+             * @brief Check if any impairment is set on a direction, the packets going straight through otherwise (I/O thread only)
+             *
+             * @param direction The direction
+             * @return true if the packets of the direction must be planned, false otherwise
+             */
+            bool isActive(connection::Direction direction) const;
+
+            /**
+             * @brief Decide what happens to a packet (I/O thread only)
+             *
+             * @param direction The direction of the packet
+             * @param clientId The id of the peer
+             * @param size The size of the packet on the wire
+             * @param now The current time
+             * @return Plan The copies of the packet to release and when
+             */
+            Plan plan(connection::Direction direction, std::uint32_t clientId, std::size_t size, Clock::time_point now);
+
+            /**
+             * @brief Forget the link state of a disconnected client (I/O thread only)
+             *
+             * @param clientId The id of the client
+             */
+            void erase(std::uint32_t clientId);
+
+            /**
+             * @brief Get the number of packets impaired (safe to call from any thread)
+             *
+             * @return Counters The counters
+             */
+            Counters getCounters() const;
+
+        private:
+            /**
+             * @struct Settings
+             * @brief The impairments of each direction
+             */
+            struct Settings {
+                    std::array<std::unordered_map<std::uint32_t, Impairment>, 2> clients; /*!> The impairments set for a given client */
+                    std::array<Impairment, 2> defaults;                                   /*!> The impairments of the other clients */
+            };
+
+            /**
+             * @struct Link
+             * @brief The state of the simulated link to a client in one direction
+             */
+            struct Link {
+                    Clock::time_point busyUntil;   /*!> The time the last packet finishes crossing the bandwidth cap */
+                    Clock::time_point lastRelease; /*!> The release time of the last packet, that a stream never releases before */
+            };
+
+            /**
+             * @brief Check if an impairment changes anything
+             *
+             * @param impairment The impairment
+             * @return true if the impairment is not a perfect link, false otherwise
+             */
+            static bool isEnabled(const Impairment& impairment);
+
+            /**
+             * @brief Draw a random event
+             *
+             * @param probability The probability of the event
+             * @return true if the event happens, false otherwise
+             */
+            bool chance(double probability);
+
+            bool stream_; /*!> If the packets must stay in order and never be lost */
+
+            std::mutex settingsMutex_;         /*!> Guard of the staged settings */
+            Settings staged_;                  /*!> The settings written by the setters */
+            std::atomic<bool> changed_{false}; /*!> If the staged settings changed since the last refresh */
+
+            Settings settings_;                                            /*!> The settings used by the I/O thread */
+            std::array<bool, 2> active_ = {false, false};                  /*!> If each direction has an impairment set */
+            std::array<std::unordered_map<std::uint32_t, Link>, 2> links_; /*!> The link state of the clients in each direction */
+            std::minstd_rand random_;                                      /*!> The generator of the random events */
+
+            std::atomic<std::uint64_t> delayed_{0};    /*!> The number of packets that went through the impairment */
+            std::atomic<std::uint64_t> dropped_{0};    /*!> The number of datagrams lost or dropped behind a bandwidth cap */
+            std::atomic<std::uint64_t> duplicated_{0}; /*!> The number of datagrams delivered twice */
+            std::atomic<std::uint64_t> reordered_{0};  /*!> The number of datagrams held back to be overtaken */
+    };
+}
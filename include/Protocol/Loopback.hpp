@@ -0,0 +1,199 @@
+
+#pragma once
+
+#include "Enum/Connection.hpp"
+#include "Data/Outbound.hpp"
+#include "Data/Metrics.hpp"
+#include "Utils/Singleton.hpp"
+#include "Utils/Wakeup.hpp"
+#include "Protocol/Meter.hpp"
+#include "Socket.hpp"
+
+#include <unordered_map>
+#include <shared_mutex>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <mutex>
+#include <vector>
+
+namespace glnet
+{
+    class Manager;
+
+    class Loopback : public std::enable_shared_from_this<Loopback>
+    {
+        public:
+            /**
+             * @brief Construct a new Loopback object
+             *
+             * @param manager The manager owning the loopback instance
+             * @param side The side of the connection (client or server)
+             */
+            Loopback(Manager& manager, connection::Side side);
+
+            /**
+             * @brief Destroy the Loopback object, unregistering its name and closing its connections
+             */
+            ~Loopback();
+
+            /**
+             * @brief Register the server under a name for the clients of the process to connect to it (only for server side)
+             *
+             * @param name The name of the server, unique in the process
+             */
+            void listen(const std::string& name);
+
+            /**
+             * @brief Stop the loopback instance
+             */
+            void stop();
+
+            /**
+             * @brief Main loop of the loopback instance (threaded mode)
+             */
+            void run();
+
+            /**
+             * @brief Handle the connections, frames and disconnections queued by the peers
+             */
+            void process();
+
+            /**
+             * @brief Get the pollfd array of the loopback instance, to poll it along with other instances
+             *
+             * @return std::vector<Socket::PollFd>& The pollfd array, holding the wakeup signaled by the peers
+             */
+            std::vector<Socket::PollFd>& getPollFds();
+
+            /**
+             * @brief Get the timeout of the next poll
+             *
+             * @return std::int32_t -1, the peers signaling the wakeup
+             */
+            std::int32_t getTimeout() const;
+
+            /**
+             * @brief Connect to a server of the process (only for client side)
+             *
+             * @param name The name the server listens on
+             */
+            void connectToServer(const std::string& name);
+
+            /**
+             * @brief Hand a frame to the peer, which shares it without copying (safe to call from any thread)
+             *
+             * @param outbound The frame and its destination, the delivery, priority and lifetime being ignored
+             * @return connection::SendResult QUEUED, FAILED if the client is unknown or gone, or the queue of the peer full
+             */
+            connection::SendResult enqueue(Outbound outbound);
+
+            /**
+             * @brief Bind the connection being registered to its client id, before its connection callback lets producers send to it
+             *
+             * @param clientId The id of the client
+             */
+            void track(std::uint32_t clientId);
+
+            /**
+             * @brief Aggregate the counters of the loopback instance and of its connections (safe to call from any thread)
+             *
+             * @return TransportMetrics The counters
+             */
+            TransportMetrics getMetrics();
+
+        private:
+            static constexpr std::size_t MAX_QUEUED_FRAMES = 65536; /*!> The maximum number of frames waiting in the queue of an instance */
+
+            /**
+             * @enum Event
+             * @brief What a peer queued
+             */
+            enum class Event {
+                CONNECT,    /*!> A client connected */
+                MESSAGE,    /*!> A frame was sent */
+                DISCONNECT, /*!> The peer was destroyed */
+            };
+
+            /**
+             * @struct Link
+             * @brief A connection, shared by its client and its server
+             */
+            struct Link {
+                    std::mutex mutex;                                  /*!> Guard of the closing of the connection against the producers of both sides */
+                    bool closed = false;                               /*!> If the connection is closed, the producers failing from then on */
+                    std::weak_ptr<Loopback> ends[2];                   /*!> The client and the server, by side */
+                    Meter::Counters *counters[2] = {nullptr, nullptr}; /*!> The traffic counters of the connection on each side */
+                    std::uint32_t clientId = 0;                        /*!> The id of the connection on the server */
+            };
+
+            /**
+             * @struct Message
+             * @brief An entry of the queue of an instance
+             */
+            struct Message {
+                    Event event;                /*!> What the peer queued */
+                    std::shared_ptr<Link> link; /*!> The connection */
+                    Frame frame;                /*!> The frame (message only) */
+            };
+
+            /**
+             * @class Registry
+             * @brief The servers of the process, by name
+             */
+            class Registry : public utils::Singleton<Registry>
+            {
+                public:
+                    std::mutex mutex;                                                 /*!> Guard of the servers map */
+                    std::unordered_map<std::string, std::weak_ptr<Loopback>> servers; /*!> The listening servers */
+            };
+
+            Manager& manager_;          /*!> The manager owning the loopback instance */
+            connection::Side side_;     /*!> The side of the connection (client or server) */
+            std::atomic<bool> running_; /*!> If the loopback instance should run */
+            std::string name_;          /*!> The name the server listens on */
+
+            std::vector<Socket::PollFd> pollFds_; /*!> The pollfd array for the loopback instance */
+            utils::Wakeup wakeup_;                /*!> The wakeup signaled by the peers when they queue an entry */
+            std::vector<Message> inbox_;          /*!> The entries queued by the peers, in order */
+            std::mutex inboxMutex_;               /*!> Guard of the inbox against the peers */
+            std::vector<Message> received_;       /*!> The entries being handled, swapped with the inbox */
+            Meter meter_;                         /*!> The traffic counters of the connections */
+            std::shared_ptr<Link> registering_;   /*!> The connection whose connection callback is running, bound to its id by track */
+
+            std::unordered_map<std::uint32_t, std::shared_ptr<Link>> links_; /*!> The open connections, modified by the loopback thread only */
+            std::shared_mutex linksMutex_;                                   /*!> Guard of the links map against the producers */
+
+            /**
+             * @brief Queue an entry for the loopback thread (called by the peers)
+             *
+             * @param message The entry
+             * @return true if it was queued, false if the queue holds MAX_QUEUED_FRAMES frames (the connections and disconnections always fit)
+             */
+            bool post(Message message);
+
+            /**
+             * @brief Hand a frame to the message callbacks
+             *
+             * @param link The connection of the frame
+             * @param frame The frame
+             */
+            void deliver(const std::shared_ptr<Link>& link, const Frame& frame);
+
+            /**
+             * @brief Close a connection whose peer was destroyed and forget it
+             *
+             * @param link The connection
+             */
+            void disconnect(const std::shared_ptr<Link>& link);
+
+            /**
+             * @brief Find an open connection (safe to call from any thread)
+             *
+             * @param clientId The id of the connection
+             * @return std::shared_ptr<Link> The connection, nullptr if it is unknown
+             */
+            std::shared_ptr<Link> findLink(std::uint32_t clientId);
+    };
+}
@@ -0,0 +1,104 @@
+
+#pragma once
+
+#include "Utils/Counter.hpp"
+#include "Utils/Ring.hpp"
+#include "Data/Metrics.hpp"
+
+#include <unordered_map>
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+namespace glnet
+{
+    class Meter
+    {
+        public:
+            /**
+             * @struct Counters
+             * @brief The traffic counters of a connection, written by the I/O thread of its transport only
+             */
+            struct alignas(utils::CACHE_LINE_SIZE) Counters {
+                    utils::Counter bytesIn;       /*!> The number of bytes read */
+                    utils::Counter bytesOut;      /*!> The number of bytes written */
+                    utils::Counter packetsIn;     /*!> The number of frames or datagrams read */
+                    utils::Counter packetsOut;    /*!> The number of frames or datagrams written */
+                    utils::Counter partialReads;  /*!> The number of short reads */
+                    utils::Counter partialWrites; /*!> The number of short writes */
+            };
+
+            /**
+             * @brief Get the counters of a connection, creating them on first use (I/O thread only)
+             *
+             * @param clientId The id of the connection
+             * @return Counters& The counters, valid until the connection is forgotten
+             */
+            Counters& track(std::uint32_t clientId);
+
+            /**
+             * @brief Fold the counters of a closed connection into the totals of the transport (I/O thread only)
+             *
+             * @param clientId The id of the connection
+             */
+            void forget(std::uint32_t clientId);
+
+            /**
+             * @brief Count a dropped frame (safe to call from any thread)
+             */
+            void onDrop();
+
+            /**
+             * @brief Count an accepted connection (I/O thread only)
+             */
+            void onAccept();
+
+            /**
+             * @brief Count a message callback and the time it took (I/O thread only)
+             *
+             * @param elapsed The time spent in the callback
+             */
+            void onCallback(std::chrono::steady_clock::duration elapsed);
+
+            /**
+             * @brief Set the number of frames held by the scheduler (I/O thread only)
+             *
+             * @param frames The number of frames
+             */
+            void setQueuedFrames(std::size_t frames);
+
+            /**
+             * @brief Aggregate the counters (safe to call from any thread, only locks out the creation and removal of connections)
+             *
+             * @return TransportMetrics The counters of the transport, the queued bytes are left to the transport
+             */
+            TransportMetrics snapshot() const;
+
+        private:
+            /**
+             * @brief Add the counters of a connection to a snapshot
+             *
+             * @param counters The counters to read
+             * @param traffic The snapshot to add to
+             */
+            static void collect(const Counters& counters, TrafficMetrics& traffic);
+
+            /**
+             * @struct Totals
+             * @brief The counters of the transport, written by its I/O thread only
+             */
+            struct alignas(utils::CACHE_LINE_SIZE) Totals {
+                    utils::Counter accepted;     /*!> The number of connections accepted */
+                    utils::Counter callbacks;    /*!> The number of message callbacks run */
+                    utils::Counter callbackTime; /*!> The time spent in the message callbacks, in nanoseconds */
+                    utils::Counter queuedFrames; /*!> The number of frames held by the scheduler */
+            };
+
+            mutable std::mutex mutex_;                                                 /*!> Guard of the creation and removal of connections, never taken to count */
+            std::unordered_map<std::uint32_t, std::unique_ptr<Counters>> connections_; /*!> The counters of the open connections */
+            Counters retired_;                                                         /*!> The counters of the closed connections */
+            Totals totals_;                                                            /*!> The counters of the transport */
+            utils::SharedCounter dropped_;                                             /*!> The number of frames dropped, by the I/O thread or the sending threads */
+    };
+}
@@ -0,0 +1,183 @@
+
+#pragma once
+
+#include "Enum/Connection.hpp"
+#include "Data/RateLimit.hpp"
+#include "Data/Outbound.hpp"
+#include "Utils/TokenBucket.hpp"
+
+#include <unordered_map>
+#include <optional>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace glnet
+{
+    class RateLimiter
+    {
+        public:
+            /**
+             * @brief Clock used to refill the buckets
+             */
+            using Clock = std::chrono::steady_clock;
+
+            /**
+             * @enum Verdict
+             * @brief What to do with a frame
+             */
+            enum class Verdict {
+                SEND,  /*!> The frame fits in its buckets, whose tokens were taken */
+                DEFER, /*!> The frame must wait for its buckets to refill */
+                DROP,  /*!> The frame must be dropped */
+            };
+
+            /**
+             * @struct Counters
+             * @brief The number of times the limits were hit
+             */
+            struct Counters {
+                    std::uint64_t deferred;    /*!> The number of times a frame was held back */
+                    std::uint64_t dropped;     /*!> The number of frames dropped by the DROP policy */
+                    std::uint64_t downsampled; /*!> The number of realtime frames dropped by the DOWNSAMPLE policy */
+            };
+
+            /**
+             * @brief Set the limit of a client, overriding the default one (safe to call from any thread)
+             *
+             * @param clientId The id of the client (0 for the server on client side)
+             * @param limit The limit of the client
+             */
+            void setClientLimit(std::uint32_t clientId, RateLimit limit);
+
+            /**
+             * @brief Set the limit of the clients without a limit of their own (safe to call from any thread)
+             *
+             * @param limit The limit of each client
+             */
+            void setDefaultClientLimit(RateLimit limit);
+
+            /**
+             * @brief Set the limit of the traffic to all the clients together (safe to call from any thread)
+             *
+             * @param limit The global limit
+             */
+            void setGlobalLimit(RateLimit limit);
+
+            /**
+             * @brief Set what to do with the frames exceeding a limit (safe to call from any thread)
+             *
+             * @param overflow The overflow policy
+             */
+            void setOverflow(connection::Overflow overflow);
+
+            /**
+             * @brief Cap the rate of a client on top of its other limits, used by the congestion control of the I/O thread (not thread safe)
+             *
+             * @param clientId The id of the client
+             * @param limit The rate and burst estimated for the client (a rate of 0 removes the cap)
+             */
+            void setAdaptiveLimit(std::uint32_t clientId, RateLimit limit);
+
+            /**
+             * @brief Remove the adaptive caps of every client (not thread safe)
+             */
+            void clearAdaptiveLimits();
+
+            /**
+             * @brief Apply the settings changed since the last call, keeping the tokens of the buckets, and forget the retry deadline, called by the I/O thread before each flush
+             */
+            void refresh();
+
+            /**
+             * @brief Decide whether a frame can be written now, taking its tokens if so
+             *
+             * @param outbound The frame and its destination
+             * @param now The current time
+             * @return Verdict What to do with the frame
+             */
+            Verdict admit(const Outbound& outbound, Clock::time_point now);
+
+            /**
+             * @brief Forget the buckets and the limit of a disconnected client
+             *
+             * @param clientId The id of the client
+             */
+            void erase(std::uint32_t clientId);
+
+            /**
+             * @brief Get the time at which a deferred frame fits in its buckets
+             *
+             * @return Clock::time_point The retry deadline, Clock::time_point::max() if no frame was deferred since the last refresh
+             */
+            Clock::time_point getRetryDeadline() const;
+
+            /**
+             * @brief Get the number of times the limits were hit (safe to call from any thread)
+             *
+             * @return Counters The counters
+             */
+            Counters getCounters() const;
+
+        private:
+            /**
+             * @struct Settings
+             * @brief The limits and overflow policy
+             */
+            struct Settings {
+                    std::unordered_map<std::uint32_t, RateLimit> clients;        /*!> The limits set for a given client */
+                    RateLimit defaultClient;                                     /*!> The limit of the other clients */
+                    RateLimit global;                                            /*!> The limit of all the clients together */
+                    connection::Overflow overflow = connection::Overflow::DEFER; /*!> The overflow policy */
+            };
+
+            /**
+             * @brief Get the bucket of a client, creating it from the settings if needed
+             *
+             * @param clientId The id of the client
+             * @param now The current time
+             * @return utils::TokenBucket* The bucket, nullptr if the client is not limited
+             */
+            utils::TokenBucket *getBucket(std::uint32_t clientId, Clock::time_point now);
+
+            /**
+             * @brief Get the limit of a client from the applied settings
+             *
+             * @param clientId The id of the client
+             * @return RateLimit The limit of the client, or the default one
+             */
+            RateLimit getLimit(std::uint32_t clientId) const;
+
+            /**
+             * @brief Apply the limit of a client to its bucket, keeping its tokens, or drop the bucket if the client is no longer limited
+             *
+             * @param clientId The id of the client
+             */
+            void updateBucket(std::uint32_t clientId);
+
+            /**
+             * @brief Apply the limit of a client to its bucket, keeping its tokens, or drop the bucket if the client is no longer limited
+             *
+             * @param bucket The bucket of the client
+             * @return std::unordered_map<std::uint32_t, utils::TokenBucket>::iterator The next bucket
+             */
+            std::unordered_map<std::uint32_t, utils::TokenBucket>::iterator updateBucket(std::unordered_map<std::uint32_t, utils::TokenBucket>::iterator bucket);
+
+            std::mutex settingsMutex_;         /*!> Guard of the staged settings */
+            Settings staged_;                  /*!> The settings written by the setters, with the client limits set since the last refresh only */
+            std::atomic<bool> changed_{false}; /*!> If the staged settings changed since the last refresh */
+
+            Settings settings_;                                              /*!> The settings used by the I/O thread */
+            bool limited_ = false;                                           /*!> If any limit is set */
+            std::size_t limitedClients_ = 0;                                 /*!> The number of clients with a limit of their own */
+            std::unordered_map<std::uint32_t, utils::TokenBucket> buckets_;  /*!> The buckets of the limited clients */
+            std::unordered_map<std::uint32_t, utils::TokenBucket> adaptive_; /*!> The buckets capping the clients at their estimated rate */
+            std::optional<utils::TokenBucket> global_;                       /*!> The global bucket */
+            Clock::time_point retryAt_ = Clock::time_point::max();           /*!> The earliest time a deferred frame fits in its buckets */
+
+            std::atomic<std::uint64_t> deferred_{0};    /*!> The number of times a frame was held back */
+            std::atomic<std::uint64_t> dropped_{0};     /*!> The number of frames dropped by the DROP policy */
+            std::atomic<std::uint64_t> downsampled_{0}; /*!> The number of realtime frames dropped by the DOWNSAMPLE policy */
+    };
+}
@@ -0,0 +1,173 @@
+
+#pragma once
+
+#include "Data/Outbound.hpp"
+#include "Data/Packet.hpp"
+
+#include <unordered_map>
+#include <cstdint>
+#include <chrono>
+#include <vector>
+#include <deque>
+
+namespace glnet
+{
+    class Reliability
+    {
+        public:
+            /**
+             * @brief Clock used for the retransmission timers
+             */
+            using Clock = std::chrono::steady_clock;
+
+            static constexpr std::size_t MAX_PENDING = 16384;               /*!> The maximum number of queued and unacknowledged messages per channel */
+            static constexpr std::size_t SEND_WINDOW = 32;                  /*!> The span of sequences in flight, bounded by the range of the ack bitfield */
+            static constexpr std::uint16_t RECEIVE_WINDOW = 256;            /*!> The number of sequences buffered ahead of the next expected one */
+            static constexpr std::chrono::microseconds INITIAL_RTO{100000}; /*!> The retransmission timeout before any rtt sample */
+            static constexpr std::chrono::microseconds MIN_RTO{20000};      /*!> The lowest retransmission timeout */
+            static constexpr std::chrono::microseconds MAX_RTO{1000000};    /*!> The highest retransmission timeout */
+
+            /**
+             * @struct Pending
+             * @brief A message sent and not acknowledged yet
+             */
+            struct Pending {
+                    std::uint16_t sequence;      /*!> The sequence number of the message */
+                    Frame frame;                 /*!> The frame of the message */
+                    Clock::time_point sentAt;    /*!> The time of the last transmission */
+                    std::uint32_t transmissions; /*!> The number of transmissions */
+                    std::uint16_t messageId;     /*!> The id of the fragments of the message, kept by its retransmissions so their fragments combine */
+            };
+
+            /**
+             * @brief Compare two sequence numbers, handling the wrap around
+             *
+             * @param lhs The first sequence number
+             * @param rhs The second sequence number
+             * @return true if lhs is more recent than rhs, false otherwise
+             */
+            static bool isNewer(std::uint16_t lhs, std::uint16_t rhs);
+
+            /**
+             * @brief Queue a new message to send, the caller keeping the channel under MAX_PENDING messages
+             *
+             * @param frame The frame of the message
+             * @param messageId The id of the fragments of the message, if it is fragmented
+             */
+            void send(const Frame& frame, std::uint16_t messageId);
+
+            /**
+             * @brief Give a sequence number to the queued messages that fit in the send window, and arm their timer
+             *
+             * @param now The current time
+             * @param sendable Filled with the messages to send for the first time
+             */
+            void collectSendable(Clock::time_point now, std::vector<const Pending *>& sendable);
+
+            /**
+             * @brief Acknowledge the messages covered by an ack and its bitfield
+             *
+             * @param ack The most recent sequence received by the peer
+             * @param ackBits The bitfield of the 32 sequences preceding ack (bit n for ack - n - 1)
+             * @param now The current time
+             * @return std::chrono::microseconds The round trip time of the last message acknowledged without retransmission, zero if none
+             */
+            std::chrono::microseconds acknowledge(std::uint16_t ack, std::uint32_t ackBits, Clock::time_point now);
+
+            /**
+             * @brief Collect the messages whose retransmission timer expired, and rearm their timer
+             *
+             * @param now The current time
+             * @param expired Filled with the messages to send again
+             */
+            void collectExpired(Clock::time_point now, std::vector<const Pending *>& expired);
+
+            /**
+             * @brief Get the time of the next retransmission
+             *
+             * @return Clock::time_point The deadline, Clock::time_point::max() if nothing is pending
+             */
+            Clock::time_point getNextDeadline() const;
+
+            /**
+             * @brief Receive a message, buffering it until every previous one was delivered
+             *
+             * @param sequence The sequence number of the message
+             * @param packet The received message
+             * @param deliverable Filled with the messages that can be delivered, in order
+             * @return true if the message was new, false if it is a duplicate or outside the receive window
+             */
+            bool receive(std::uint16_t sequence, Packet&& packet, std::vector<Packet>& deliverable);
+
+            /**
+             * @brief Check if a reliable message was received, making the ack fields meaningful
+             *
+             * @return true if a message was received, false otherwise
+             */
+            bool hasReceived() const;
+
+            /**
+             * @brief Get the most recent sequence received
+             *
+             * @return std::uint16_t The sequence number
+             */
+            std::uint16_t getAck() const;
+
+            /**
+             * @brief Get the bitfield of the 32 sequences received before the ack
+             *
+             * @return std::uint32_t The bitfield
+             */
+            std::uint32_t getAckBits() const;
+
+            /**
+             * @brief Get the smoothed round trip time
+             *
+             * @return std::chrono::microseconds The smoothed rtt, 0 before any sample
+             */
+            std::chrono::microseconds getRtt() const;
+
+            /**
+             * @brief Get the number of unacknowledged messages
+             *
+             * @return std::size_t The number of messages
+             */
+            std::size_t getPendingCount() const;
+
+        private:
+            /**
+             * @brief Get the retransmission timeout of a message, doubled at each retransmission
+             *
+             * @param pending The message
+             * @return std::chrono::microseconds The timeout since its last transmission
+             */
+            std::chrono::microseconds getTimeout(const Pending& pending) const;
+
+            /**
+             * @brief Update the rtt estimation with a new sample (RFC 6298)
+             *
+             * @param sample The measured round trip time
+             */
+            void sampleRtt(std::chrono::microseconds sample);
+
+            /**
+             * @brief Record a received sequence in the ack fields
+             *
+             * @param sequence The received sequence number
+             */
+            void recordAck(std::uint16_t sequence);
+
+            std::uint16_t nextSequence_ = 0;             /*!> The sequence number of the next message to send */
+            std::deque<Pending> queued_;                 /*!> The messages waiting for room in the send window, without sequence yet */
+            std::deque<Pending> pending_;                /*!> The unacknowledged messages, by sending order */
+            std::chrono::microseconds srtt_{0};          /*!> The smoothed round trip time */
+            std::chrono::microseconds rttVar_{0};        /*!> The round trip time variation */
+            std::chrono::microseconds rto_{INITIAL_RTO}; /*!> The retransmission timeout */
+
+            bool received_ = false;                              /*!> If a message was received */
+            std::uint16_t remoteSequence_ = 0;                   /*!> The most recent sequence received */
+            std::uint32_t remoteBits_ = 0;                       /*!> The bitfield of the sequences received before the most recent one */
+            std::uint16_t nextExpected_ = 0;                     /*!> The sequence of the next message to deliver */
+            std::unordered_map<std::uint16_t, Packet> buffered_; /*!> The messages received ahead of the next expected one */
+    };
+}
@@ -0,0 +1,132 @@
+
+#pragma once
+
+#include "Enum/Connection.hpp"
+#include "Protocol/RateLimiter.hpp"
+#include "Data/Outbound.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <cstdint>
+#include <chrono>
+#include <array>
+#include <deque>
+
+namespace glnet
+{
+    class Scheduler
+    {
+        public:
+            /**
+             * @brief Clock used for the deadlines of the frames
+             */
+            using Clock = std::chrono::steady_clock;
+
+            static constexpr std::size_t CLASS_COUNT = static_cast<std::size_t>(connection::Priority::COUNT); /*!> The number of priority classes */
+            static constexpr std::array<std::size_t, CLASS_COUNT> WEIGHTS = {16, 4, 1};                       /*!> The share of the link given to each class, by priority */
+            static constexpr std::size_t QUANTUM = 1500;                                                      /*!> The number of bytes a class of weight 1 may write per round */
+            static constexpr std::size_t MAX_SCHEDULED = 4096;                                                /*!> The maximum number of frames held by the scheduler */
+
+            /**
+             * @brief Queue a frame in the class of its destination
+             *
+             * @param outbound The frame and its destination
+             */
+            void push(Outbound&& outbound);
+
+            /**
+             * @brief Get the next frame to write, taking turns between the connections and sharing each connection between its classes by weighted fair queuing
+             *
+             * @param now The current time, frames whose deadline is over are dropped
+             * @param limiter The rate limiter deciding whether the frame of a connection may be written now
+             * @param outbound Filled with the frame to write
+             * @return true if a frame was popped, false if nothing is left or every connection is held back by its limits
+             */
+            bool pop(Clock::time_point now, RateLimiter& limiter, Outbound& outbound);
+
+            /**
+             * @brief Stop giving the frames of a connection, whose socket cannot take more data
+             *
+             * @param clientId The id of the connection
+             */
+            void block(std::uint32_t clientId);
+
+            /**
+             * @brief Give the frames of a blocked connection again
+             *
+             * @param clientId The id of the connection
+             */
+            void unblock(std::uint32_t clientId);
+
+            /**
+             * @brief Set the function called with every frame dropped because of its deadline or its rate limit
+             *
+             * @param func The function to set
+             */
+            void setOnDiscard(std::function<void(const Outbound&)> func);
+
+            /**
+             * @brief Drop the frames queued for a connection
+             *
+             * @param clientId The id of the connection
+             */
+            void erase(std::uint32_t clientId);
+
+            /**
+             * @brief Check whether the scheduler holds no frame
+             *
+             * @return true if no frame is queued, false otherwise
+             */
+            bool empty() const;
+
+            /**
+             * @brief Check whether the scheduler can take more frames
+             *
+             * @return true if the scheduler holds MAX_SCHEDULED frames, false otherwise
+             */
+            bool full() const;
+
+            /**
+             * @brief Get the number of frames held by the scheduler
+             *
+             * @return std::size_t The number of frames queued over all connections
+             */
+            std::size_t size() const;
+
+            /**
+             * @brief Get the number of frames dropped because their deadline was over
+             *
+             * @return std::uint64_t The number of frames
+             */
+            std::uint64_t getExpiredCount() const;
+
+        private:
+            /**
+             * @struct Classes
+             * @brief The frames queued for a connection, by priority class
+             */
+            struct Classes {
+                    std::array<std::deque<Outbound>, CLASS_COUNT> queues; /*!> The frames of each class, in sending order */
+                    std::array<std::size_t, CLASS_COUNT> deficits = {0};  /*!> The number of bytes each class may still write this round */
+                    std::size_t current = 0;                              /*!> The class whose turn it is */
+                    std::size_t size = 0;                                 /*!> The number of frames queued over all classes */
+            };
+
+            /**
+             * @brief Select the next frame of a connection by deficit round robin over its classes, leaving it in its queue
+             *
+             * @param classes The classes of the connection
+             * @param now The current time
+             * @return Outbound* The frame at the head of the selected class, nullptr if the connection has nothing left
+             */
+            Outbound *selectClass(Classes& classes, Clock::time_point now);
+
+            std::unordered_map<std::uint32_t, Classes> connections_; /*!> The connections with queued frames */
+            std::deque<std::uint32_t> active_;                       /*!> The unblocked connections with queued frames, in turn order */
+            std::unordered_set<std::uint32_t> blocked_;              /*!> The connections whose socket cannot take more data */
+            std::function<void(const Outbound&)> onDiscard_;         /*!> The function called with the dropped frames */
+            std::size_t size_ = 0;                                   /*!> The number of frames queued over all connections */
+            std::uint64_t expired_ = 0;                              /*!> The number of frames dropped because their deadline was over */
+    };
+}
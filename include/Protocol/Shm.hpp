@@ -0,0 +1,205 @@
+
+#pragma once
+
+#include "Enum/Connection.hpp"
+#include "Data/Endpoint.hpp"
+#include "Data/ShmOptions.hpp"
+#include "Data/Outbound.hpp"
+#include "Data/Metrics.hpp"
+#include "Data/Packet.hpp"
+#include "Utils/ShmRing.hpp"
+#include "Utils/Wakeup.hpp"
+#include "Protocol/Meter.hpp"
+#include "Socket.hpp"
+
+#include <unordered_map>
+#include <shared_mutex>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace glnet
+{
+    class Manager;
+
+    class Shm
+    {
+        public:
+            /**
+             * @brief Construct a new Shm object
+             *
+             * @param manager The manager owning the shm instance
+             * @param endpoint The endpoint on which to create the object, its address being the path of the unix socket of the handshake (server side)
+             * @param side The side of the connection (client or server)
+             * @param options The size of the rings and the spin time
+             */
+            Shm(Manager& manager, Endpoint endpoint, connection::Side side, ShmOptions options);
+
+            /**
+             * @brief Stop the shm instance
+             */
+            void stop();
+
+            /**
+             * @brief Main loop of the shm instance (threaded mode)
+             */
+            void run();
+
+            /**
+             * @brief Handle the events reported on the pollfd array and read the frames of the rings
+             */
+            void process();
+
+            /**
+             * @brief Get the pollfd array of the shm instance, to poll it along with other instances
+             *
+             * @return std::vector<Socket::PollFd>& The pollfd array
+             */
+            std::vector<Socket::PollFd>& getPollFds();
+
+            /**
+             * @brief Arm the doorbells of the rings before the caller sleeps in poll
+             *
+             * @return std::int32_t 0 if a ring already holds frames, -1 otherwise
+             */
+            std::int32_t getTimeout();
+
+            /**
+             * @brief Create the shared memory, connect to the server and hand it the memory (only for client side)
+             *
+             * @param path The path of the unix socket of the server
+             */
+            void connectToServer(const std::string& path);
+
+            /**
+             * @brief Write a frame into the ring of its destination, ringing the doorbell only if the reader sleeps (safe to call from any thread)
+             *
+             * @param outbound The frame and its destination, the delivery, priority and lifetime being ignored
+             * @return connection::SendResult QUEUED, FAILED if the client is unknown, the ring full or the frame larger than half of the ring
+             */
+            connection::SendResult enqueue(Outbound outbound);
+
+            /**
+             * @brief Bind the connection being registered to its client id, before its connection callback lets producers send to it
+             *
+             * @param clientId The id of the client
+             */
+            void track(std::uint32_t clientId);
+
+            /**
+             * @brief Aggregate the counters of the shm instance and of its connections (safe to call from any thread)
+             *
+             * @return TransportMetrics The counters, with the bytes waiting in the ring of each connection
+             */
+            TransportMetrics getMetrics();
+
+        private:
+            static constexpr char MAGIC[8] = {'G', 'L', 'N', 'E', 'T', 'S', 'H', 'M'}; /*!> The first bytes of the shared memory */
+            static constexpr std::uint32_t VERSION = 1;                                /*!> The version of the memory layout */
+            static constexpr std::size_t WAKEUP_POLL_INDEX = 1;                        /*!> The index of the wakeup fd in the pollfd array */
+            static constexpr std::size_t FIRST_CLIENT_POLL_INDEX = 2;                  /*!> The index of the first client in the pollfd array */
+            static constexpr std::size_t MAX_READ_BATCH = 64;                          /*!> The maximum number of frames read from a ring per loop iteration */
+            static constexpr std::chrono::milliseconds SPIN_POLL_INTERVAL{1};          /*!> The time between two polls of the sockets while spinning */
+
+            /**
+             * @struct Header
+             * @brief The header at the start of the shared memory, followed by the ring to the server and the ring to the client
+             */
+            struct alignas(utils::CACHE_LINE_SIZE) Header {
+                    char magic[8];          /*!> MAGIC */
+                    std::uint32_t version;  /*!> VERSION */
+                    std::uint32_t capacity; /*!> The size of the data of each ring */
+            };
+
+            /**
+             * @struct Link
+             * @brief A connection: its mapped memory, its rings and its unix socket, which carries the doorbells and reports the hangup of the peer
+             */
+            struct Link {
+                    std::mutex mutex;                    /*!> Guard of the outbound ring against concurrent producers, and of the socket against its closing */
+                    std::uint32_t clientId = 0;          /*!> The id of the connection (0 for the server on client side) */
+                    void *memory = nullptr;              /*!> The mapping of the shared memory */
+                    std::size_t size = 0;                /*!> The size of the mapping */
+                    utils::ShmRing inbound;              /*!> The ring read by this side */
+                    utils::ShmRing outbound;             /*!> The ring written by this side */
+                    Socket::Fd doorbell = INVALID_FD;    /*!> The unix socket of the connection */
+                    bool closed = false;                 /*!> If the connection is closed, the producers failing from then on */
+                    Meter::Counters *counters = nullptr; /*!> The traffic counters of the connection */
+
+                    /**
+                     * @brief Destroy the Link object, unmapping its memory once the last producer let it go
+                     */
+                    ~Link();
+            };
+
+            Manager& manager_;          /*!> The manager owning the shm instance */
+            connection::Side side_;     /*!> The side of the connection (client or server) */
+            ShmOptions options_;        /*!> The size of the rings and the spin time */
+            std::atomic<bool> running_; /*!> If the shm instance should run */
+
+            Socket socket_;                                   /*!> The listening socket (server side) or the socket of the connection (client side) */
+            std::vector<Socket::PollFd> pollFds_;             /*!> The pollfd array for the shm instance */
+            std::vector<std::shared_ptr<Link>> polled_;       /*!> The connection of each pollfd, nullptr for the others and for the clients not registered yet */
+            utils::Wakeup wakeup_;                            /*!> The wakeup signaled to stop the instance */
+            Meter meter_;                                     /*!> The traffic counters of the connections */
+            std::shared_ptr<Link> registering_;               /*!> The connection whose connection callback is running, bound to its id by track */
+            std::chrono::steady_clock::time_point lastFrame_; /*!> The time the last frame was read, to spin after it */
+
+            std::unordered_map<std::uint32_t, std::shared_ptr<Link>> links_; /*!> The registered connections, modified by the shm thread only */
+            std::shared_mutex linksMutex_;                                   /*!> Guard of the links map against the producers */
+
+            /**
+             * @brief Read the frames of every ring, up to MAX_READ_BATCH each
+             *
+             * @return true if a frame was read, false otherwise
+             */
+            bool drain();
+
+            /**
+             * @brief Accept the pending connections, which register once their memory arrives
+             */
+            void acceptSockets();
+
+            /**
+             * @brief Map the shared memory sent by a new client and register it
+             *
+             * @param pollIndex The index of the socket of the client in the pollfd array
+             * @return false if the handshake failed, true if it succeeded or is still pending
+             */
+            bool registerClient(std::size_t pollIndex);
+
+            /**
+             * @brief Read the doorbells pending on a socket
+             *
+             * @param fd The socket
+             * @return false if the peer closed the connection, true otherwise
+             */
+            bool readDoorbells(Socket::Fd fd);
+
+            /**
+             * @brief Close a connection and forget it
+             *
+             * @param pollIndex The index of the socket of the connection in the pollfd array
+             */
+            void disconnect(std::size_t pollIndex);
+
+            /**
+             * @brief Find a registered connection (safe to call from any thread)
+             *
+             * @param clientId The id of the connection
+             * @return std::shared_ptr<Link> The connection, nullptr if it is unknown
+             */
+            std::shared_ptr<Link> findLink(std::uint32_t clientId);
+
+            /**
+             * @brief Get the size of the shared memory of a connection
+             *
+             * @param capacity The size of the data of each ring
+             * @return std::size_t The size of the header and of both rings
+             */
+            static std::size_t getMemorySize(std::size_t capacity);
+    };
+}
@@ -3,24 +3,48 @@
 
 #include "Enum/Connection.hpp"
 #include "Data/Endpoint.hpp"
+#include "Data/Watermarks.hpp"
+#include "Data/ConnectionLimits.hpp"
+#include "Data/Timeouts.hpp"
+#include "Data/Outbound.hpp"
 #include "Data/Packet.hpp"
+#include "Utils/Wakeup.hpp"
+#include "Utils/Ring.hpp"
+#include "Utils/TimingWheel.hpp"
+#include "Utils/DelayQueue.hpp"
+#include "Protocol/Scheduler.hpp"
+#include "Protocol/Meter.hpp"
+#include "Protocol/Tracer.hpp"
+#include "Protocol/Impairer.hpp"
 #include "Socket.hpp"
 
+#include <unordered_map>
+#include <unordered_set>
+#include <shared_mutex>
 #include <iostream>
 #include <cstdint>
+#include <atomic>
+#include <utility>
+#include <memory>
+#include <vector>
 
 namespace glnet
 {
+    class Manager;
+
     class Tcp
     {
         public:
             /**
              * @brief Construct a new Tcp object
              *
-             * @param endpoint The endpoint on which to create the object
+             * @param manager The manager owning the tcp instance
+             * @param endpoint The endpoint on which to create the object (the socket path as address for a local server)
              * @param type The side of the connection (client or server)
+             * @param type The transport served: TCP, or LOCAL for the same framing over unix domain sockets
+             * @param localMode The socket type of the local connections
              */
-            Tcp(Endpoint endpoint, connection::Side side);
+            Tcp(Manager& manager, Endpoint endpoint, connection::Side side, connection::Type type = connection::Type::TCP, connection::LocalMode localMode = connection::LocalMode::STREAM);
 
             /**
              * @brief Stop the tcp instance
@@ -28,37 +52,376 @@ namespace glnet
             void stop();
 
             /**
-             * @brief Main loop of the tcp instance
+             * @brief Main loop of the tcp instance (threaded mode)
              */
             void run();
 
             /**
-             * @brief Connect to a server
+             * @brief Handle the events reported on the pollfd array and write the queued frames
+             */
+            void process();
+
+            /**
+             * @brief Get the pollfd array of the tcp instance, to poll it along with other instances
+             *
+             * @return std::vector<Socket::PollFd>& The pollfd array
+             */
+            std::vector<Socket::PollFd>& getPollFds();
+
+            /**
+             * @brief Get the time left before a frame held back by the rate limits can be written or a connection exceeds its hard limit timeout
+             *
+             * @return std::int32_t The timeout in milliseconds, -1 if no frame is held back and no connection is above the hard limit
+             */
+            std::int32_t getTimeout() const;
+
+            /**
+             * @brief Get the rate limiter of the outbound frames
+             *
+             * @return RateLimiter& The rate limiter, whose setters are safe to call from any thread
+             */
+            RateLimiter& getRateLimiter();
+
+            /**
+             * @brief Get the network impairment applied to the frames in both directions (latency, jitter and bandwidth, a stream never losing or reordering its frames)
+             *
+             * @return Impairer& The impairer, whose setters are safe to call from any thread
+             */
+            Impairer& getImpairer();
+
+            /**
+             * @brief Start connecting to a server, the connection completes on the tcp thread
              *
-             * @param host The host to connect to
-             * @param port The port to connect to
+             * @param host The host to connect to (the socket path for a local connection)
+             * @param port The port to connect to (ignored for a local connection)
              */
             void connectToServer(const std::string& host, std::uint16_t port);
 
             /**
-             * @brief Send a packet to a given socket
+             * @brief Serve an already connected socket as a new client on the next loop iteration, like an accepted one (only for server side, safe to call from any thread)
+             *
+             * @param fd The socket, owned by the tcp instance from now on
+             * @return true if the socket was queued, false if the queue is full
+             */
+            bool adopt(Socket::Fd fd);
+
+            /**
+             * @brief Queue a frame to be written by the tcp thread (safe to call from any thread)
+             *
+             * @param outbound The frame and its destination
+             * @return connection::SendResult QUEUED, CONGESTED if the connection is above its high watermark, FAILED if the client is unknown or the outbound queue is full
+             */
+            connection::SendResult enqueue(Outbound outbound);
+
+            /**
+             * @brief Set the outbound byte thresholds of the connections (safe to call from any thread)
+             *
+             * @param watermarks The thresholds
+             */
+            void setWatermarks(Watermarks watermarks);
+
+            /**
+             * @brief Start counting the outbound bytes of a new client, before its connection callback lets producers send to it
+             *
+             * @param clientId The id of the client
+             */
+            void track(std::uint32_t clientId);
+
+            /**
+             * @brief Set the admission control of the server (safe to call from any thread)
+             *
+             * @param limits The connection limit and the accept budget of each loop iteration
+             */
+            void setConnectionLimits(ConnectionLimits limits);
+
+            /**
+             * @brief Get the number of connections closed because the server was full (safe to call from any thread)
              *
-             * @param socket The socket to send to
-             * @param packet The packet to send
+             * @return std::uint64_t The number of rejected connections
              */
-            void sendToSocket(Socket& socket, Packet& packet);
+            std::uint64_t getRejectedCount() const;
+
+            /**
+             * @brief Aggregate the counters of the tcp instance and of its connections (safe to call from any thread)
+             *
+             * @return TransportMetrics The counters, with the bytes queued on each connection
+             */
+            TransportMetrics getMetrics();
+
+            /**
+             * @brief Enable the latency tracing: kernel timestamps on the sockets and glnet timestamps at each stage (safe to call from any thread)
+             *
+             * @param enable If the latency should be traced
+             */
+            void setTracing(bool enable);
+
+            /**
+             * @brief Get the latency of each stage traced so far (safe to call from any thread)
+             *
+             * @return Latency The latency of each stage
+             */
+            Latency getLatency() const;
+
+            /**
+             * @brief Set the idle, heartbeat and connect deadlines (safe to call from any thread, applied when each timer is next armed)
+             *
+             * @param timeouts The deadlines, each one disabled at 0
+             */
+            void setTimeouts(Timeouts timeouts);
 
         private:
-            connection::Side side_; /*!> The side of the connection (client or server) */
-            bool running_;          /*!> If the tcp instance should run */
+            static constexpr std::size_t WAKEUP_POLL_INDEX = 1;              /*!> The index of the wakeup fd in the pollfd array */
+            static constexpr std::size_t FIRST_CLIENT_POLL_INDEX = 2;        /*!> The index of the first client in the pollfd array */
+            static constexpr std::size_t MAX_FLUSH_BATCH = 256;              /*!> The maximum number of frames written per loop iteration */
+            static constexpr std::size_t MAX_READ_BATCH = 64;                /*!> The maximum number of frames read from a socket per loop iteration */
+            static constexpr std::chrono::milliseconds TIMER_RESOLUTION{10}; /*!> The tick of the timing wheel */
+            static constexpr std::size_t MAX_RECORD_SIZE = 1024 * 1024;      /*!> The size of the receive buffer of the seqpacket records */
+
+            /**
+             * @enum TimerKind
+             * @brief What a timer of the timing wheel stands for
+             */
+            enum class TimerKind : std::uint8_t {
+                IDLE,      /*!> Nothing was received from the client for the idle timeout */
+                HEARTBEAT, /*!> Nothing was sent to the peer for the heartbeat interval */
+                CONNECT,   /*!> The connection to the server took longer than the connect timeout */
+            };
+
+            /**
+             * @struct Timers
+             * @brief The timers of a connection, linked in the timing wheel while armed
+             */
+            struct Timers {
+                    utils::TimingWheel::Timer idle;      /*!> The idle timer, rearmed by every read */
+                    utils::TimingWheel::Timer heartbeat; /*!> The heartbeat timer, rearmed by every write */
+            };
+
+            /**
+             * @struct Inbound
+             * @brief The frame being read from a connection
+             */
+            struct Inbound {
+                    Packet packet;                      /*!> The packet being read, its length first */
+                    std::size_t received = 0;           /*!> The number of bytes of the frame read so far, length included */
+                    Socket::Fd descriptor = INVALID_FD; /*!> The file descriptor received with the frame (local only) */
+            };
+
+            /**
+             * @struct Received
+             * @brief A complete frame held by the impairer
+             */
+            struct Received {
+                    std::uint32_t clientId;             /*!> The id of the sender */
+                    Packet packet;                      /*!> The received message */
+                    Socket::Fd descriptor = INVALID_FD; /*!> The file descriptor received with the message (local only) */
+            };
+
+            /**
+             * @struct Polled
+             * @brief The connection behind a pollfd, so that a ready pollfd needs no lookup
+             */
+            struct Polled {
+                    std::uint32_t clientId = 0;     /*!> The id of the connection */
+                    std::shared_ptr<Socket> socket; /*!> The socket of the connection, nullptr for the listening and wakeup fds and until the connection is registered */
+            };
+
+            /**
+             * @struct Backlog
+             * @brief The outbound state of a connection
+             */
+            struct Backlog {
+                    std::atomic<std::size_t> bytes{0};                    /*!> The bytes queued and not written yet, updated by the producers and the tcp thread */
+                    Frame partial;                                        /*!> The frame being written, when the socket could not take all of it */
+                    std::size_t offset = 0;                               /*!> The number of bytes of the partial frame already written */
+                    bool congested = false;                               /*!> If the connection went above the high watermark and not back below the low one */
+                    std::chrono::steady_clock::time_point overLimitSince; /*!> The time the connection went above the hard limit (epoch if below) */
+                    Tracer::SendLog sendLog;                              /*!> The writes waiting for their kernel send timestamp */
+                    std::shared_ptr<Socket> descriptor;                   /*!> The file descriptor passed with the partial frame, until its first byte is written (local only) */
+            };
+
+            Manager& manager_;                /*!> The manager owning the tcp instance */
+            connection::Side side_;           /*!> The side of the connection (client or server) */
+            connection::Type type_;           /*!> The transport served (tcp or local) */
+            connection::LocalMode localMode_; /*!> The socket type of the local connections */
+            std::atomic<bool> running_;       /*!> If the tcp instance should run */
+            bool connecting_;                 /*!> If a non-blocking connection to the server is in progress (only for client side) */
 
             Socket socket_;                       /*!> The tcp instance socket */
             std::vector<Socket::PollFd> pollFds_; /*!> The pollfd array for the tcp instance */
+            std::vector<Polled> polled_;          /*!> The connection of each pollfd, by index */
+            utils::Ring<Socket::Fd> adopted_;     /*!> The connected sockets waiting to be served as clients */
+            std::vector<std::uint8_t> record_;    /*!> The receive buffer of the seqpacket records */
+
+            utils::Ring<Outbound> outbound_;   /*!> The frames waiting to be written */
+            Scheduler scheduler_;              /*!> The frames taken from the ring, ordered by connection and priority */
+            RateLimiter limiter_;              /*!> The bandwidth limits of the connections */
+            utils::Wakeup wakeup_;             /*!> The wakeup signaled when frames are queued */
+            Meter meter_;                      /*!> The traffic counters of the connections */
+            Tracer tracer_;                    /*!> The latency histograms of the stages */
+            bool tracingApplied_ = false;      /*!> If the sockets have their kernel timestamps enabled */
+            Tracer::Clock::time_point readAt_; /*!> The time of the last read, while the latency is traced */
+
+            Impairer impairer_;                      /*!> The simulated network conditions */
+            utils::DelayQueue<Received> delayedIn_;  /*!> The received frames held by the impairer */
+            utils::DelayQueue<Outbound> delayedOut_; /*!> The frames held by the impairer before the scheduler */
+
+            std::unordered_map<std::uint32_t, std::shared_ptr<Backlog>> backlogs_; /*!> The outbound state of the connections, modified by the tcp thread only */
+            std::shared_mutex backlogsMutex_;                                      /*!> Guard of the backlogs map against the producers */
+            std::unordered_set<std::uint32_t> congested_;                          /*!> The connections above their high watermark */
+            std::vector<std::uint32_t> broken_;                                    /*!> The connections whose write failed, disconnected after the flush */
+            std::chrono::steady_clock::time_point hardLimitDeadline_;              /*!> The earliest time a connection exceeds its hard limit timeout */
+
+            std::unordered_map<std::uint32_t, Inbound> inbound_; /*!> The frames being read, by connection */
+
+            utils::TimingWheel wheel_;                                      /*!> The idle, heartbeat and connect timers */
+            std::unordered_map<std::uint32_t, Timers> timers_;              /*!> The timers of the connections, at a stable address */
+            utils::TimingWheel::Timer connectTimer_;                        /*!> The connect timer (only for client side) */
+            std::vector<utils::TimingWheel::Timer *> expiredTimers_;        /*!> Scratch list of the timers expired by the wheel */
+            std::vector<std::pair<std::uint32_t, TimerKind>> expiredKinds_; /*!> Scratch list of the owners and kinds of the expired timers */
+            std::chrono::steady_clock::time_point now_;                     /*!> The time of the current loop iteration, used to arm the timers */
+            Frame heartbeatFrame_;                                          /*!> The empty frame sent as a heartbeat */
+            std::atomic<std::int64_t> idleTimeout_{0};                      /*!> The idle timeout in milliseconds (0 for none) */
+            std::atomic<std::int64_t> heartbeatInterval_{0};                /*!> The heartbeat interval in milliseconds (0 for none) */
+            std::atomic<std::int64_t> connectTimeout_{0};                   /*!> The connect timeout in milliseconds (0 for none) */
+
+            std::atomic<std::size_t> maxConnections_{ConnectionLimits{}.maxConnections}; /*!> The highest number of clients connected at once (0 for none) */
+            std::atomic<std::size_t> acceptsPerTick_{ConnectionLimits{}.acceptsPerTick}; /*!> The highest number of connections accepted per loop iteration (0 for none) */
+            std::atomic<std::uint64_t> rejected_{0};                                     /*!> The number of connections closed because the server was full */
+
+            std::atomic<std::size_t> lowWatermark_{Watermarks{}.low};                           /*!> The low watermark of the connections */
+            std::atomic<std::size_t> highWatermark_{Watermarks{}.high};                         /*!> The high watermark of the connections */
+            std::atomic<std::size_t> hardLimit_{Watermarks{}.hardLimit};                        /*!> The hard limit of the connections (0 for none) */
+            std::atomic<std::int64_t> hardLimitTimeout_{Watermarks{}.hardLimitTimeout.count()}; /*!> The time in milliseconds a connection may stay above the hard limit */
+
+            /**
+             * @brief Write the queued frames on their sockets
+             */
+            void flushOutbound();
+
+            /**
+             * @brief Write the partial frame of a connection without blocking
+             *
+             * @param socket The socket of the connection
+             * @param clientId The id of the connection
+             * @param backlog The outbound state of the connection
+             * @return true if the frame was written, false if the socket buffer is full or the write failed (the connection being disconnected after the flush)
+             */
+            bool writeBacklog(Socket& socket, std::uint32_t clientId, Backlog& backlog);
+
+            /**
+             * @brief Resume writing to a blocked connection once its socket is writable
+             *
+             * @param socket The socket of the connection
+             * @param clientId The id of the connection
+             * @param pollIndex The index of the socket in the pollfd array
+             */
+            void resumeWrite(Socket& socket, std::uint32_t clientId, std::size_t pollIndex);
+
+            /**
+             * @brief Watch a socket for writability, or stop watching it
+             *
+             * @param fd The file descriptor of the socket
+             * @param enable Whether to poll for POLLOUT
+             */
+            void setWriteInterest(Socket::Fd fd, bool enable);
+
+            /**
+             * @brief Count bytes written or dropped, firing the writable callback when a congested connection goes below the low watermark
+             *
+             * @param clientId The id of the connection
+             * @param backlog The outbound state of the connection
+             * @param size The number of bytes
+             */
+            void release(std::uint32_t clientId, Backlog& backlog, std::size_t size);
+
+            /**
+             * @brief Fire the backpressure callback when a connection goes above the high watermark
+             *
+             * @param clientId The id of the connection
+             */
+            void checkCongestion(std::uint32_t clientId);
+
+            /**
+             * @brief Disconnect the clients that stayed above the hard limit for too long
+             *
+             * @param now The current time
+             */
+            void enforceHardLimit(std::chrono::steady_clock::time_point now);
+
+            /**
+             * @brief Rearm the idle timer of a client, or disarm it if the idle timeout is disabled
+             *
+             * @param clientId The id of the client
+             */
+            void touchIdle(std::uint32_t clientId);
+
+            /**
+             * @brief Rearm the heartbeat timer of a connection, or disarm it if the heartbeats are disabled
+             *
+             * @param clientId The id of the connection (0 for the server on client side)
+             */
+            void touchHeartbeat(std::uint32_t clientId);
+
+            /**
+             * @brief Advance the timing wheel and handle the expired timers: disconnect the idle clients, send the heartbeats and fail the slow connection
+             */
+            void processTimers();
 
             /**
-             * @brief Accept a socket on the tcp instance
+             * @brief Enable or disable the kernel timestamps of every socket to match the tracer, and restart the send logs
              */
-            void acceptSocket();
+            void applyTracing();
+
+            /**
+             * @brief Read the kernel send timestamps queued on a socket and match them with its writes
+             *
+             * @param socket The socket
+             * @param clientId The id of the client (0 for the server on client side)
+             */
+            void readSendTimestamps(Socket& socket, std::uint32_t clientId);
+
+            /**
+             * @brief Disconnect a client by id (only for server side)
+             *
+             * @param clientId The id of the client
+             */
+            void disconnectClient(std::uint32_t clientId);
+
+            /**
+             * @brief Disconnect the connections whose write failed, once no pollfd index is in use
+             */
+            void disconnectBroken();
+
+            /**
+             * @brief Find the outbound state of a connection (safe to call from any thread)
+             *
+             * @param clientId The id of the connection
+             * @return std::shared_ptr<Backlog> The outbound state, nullptr if the connection is unknown
+             */
+            std::shared_ptr<Backlog> findBacklog(std::uint32_t clientId);
+
+            /**
+             * @brief Complete the non-blocking connection to the server once the socket is writable
+             */
+            void finishConnect();
+
+            /**
+             * @brief Accept the pending connections until none is left or the accept budget is spent, closing those above the connection limit
+             */
+            void acceptSockets();
+
+            /**
+             * @brief Serve the sockets queued by adopt
+             */
+            void adoptSockets();
+
+            /**
+             * @brief Serve a connected socket as a new client, or close it if the server is full
+             *
+             * @param fd The non-blocking socket
+             * @param endpoint The endpoint of the client
+             */
+            void addClient(Socket::Fd fd, Endpoint endpoint);
 
             /**
              * @brief Disconnect a socket from the tcp instance
@@ -66,29 +429,51 @@ namespace glnet
             void disconnectSocket(std::size_t id);
 
             /**
-             * @brief Read the header of the segment issued to the server
+             * @brief Hand a complete frame to the impairer, or deliver it at once
+             *
+             * @param clientId The id of the sender
+             * @param packet The received message
+             * @param descriptor The file descriptor received with the message, INVALID_FD if none
+             */
+            void receive(std::uint32_t clientId, Packet& packet, Socket::Fd descriptor);
+
+            /**
+             * @brief Call the message callback, or the descriptor callback for a message carrying a file descriptor, timing it
+             *
+             * @param clientId The id of the sender
+             * @param packet The received message
+             * @param descriptor The file descriptor received with the message, INVALID_FD if none
+             */
+            void deliver(std::uint32_t clientId, Packet& packet, Socket::Fd descriptor);
+
+            /**
+             * @brief Deliver the received frames held by the impairer that are due, or all of them if the inbound impairment was removed
+             */
+            void releaseInbound();
+
+            /**
+             * @brief Move the frames held by the impairer that are due to the scheduler, or all of them if the outbound impairment was removed
              *
-             * @param socket The socket to read on
-             * @param packet The packet to store the information in
-             * @return std::size_t The number of bytes read
+             * @param now The current time
              */
-            std::size_t readHeader(Socket& socket, Packet& packet);
+            void releaseOutbound(Scheduler::Clock::time_point now);
 
             /**
-             * @brief Read the body of the segment issued to the server
+             * @brief Read the frames available on a socket without blocking, keeping an incomplete frame for the next call
              *
-             * @param socket The socket to read on
-             * @param packet The packet to store the information in
-             * @return std::size_t The number of bytes read
+             * @param socket The socket to read from
+             * @param clientId The id of the client (0 for the server on client side)
+             * @return false if the connection was closed or broken, true otherwise
              */
-            std::size_t readBody(Socket& socket, Packet& packet);
+            bool readFromSocket(Socket& socket, std::uint32_t clientId);
 
             /**
-             * @brief Read from a given socket
+             * @brief Read the seqpacket records available on a socket without blocking, each record holding a whole frame
              *
              * @param socket The socket to read from
-             * @param id The id of the client (for disconnection purpose)
+             * @param clientId The id of the client (0 for the server on client side)
+             * @return false if the connection was closed or broken, true otherwise
              */
-            bool readFromSocket(Socket& socket);
+            bool readRecords(Socket& socket, std::uint32_t clientId);
     };
 }
@@ -0,0 +1,108 @@
+
+#pragma once
+
+#include "Utils/Histogram.hpp"
+#include "Data/Latency.hpp"
+#include "Socket.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <atomic>
+#include <chrono>
+#include <array>
+#include <deque>
+
+namespace glnet
+{
+    class Tracer
+    {
+        public:
+            /**
+             * @brief Clock of the stages measured by glnet
+             */
+            using Clock = std::chrono::steady_clock;
+
+            static constexpr std::size_t MAX_PENDING_SENDS = 1024; /*!> The number of writes of a socket waiting for their send timestamp, the oldest ones are forgotten */
+
+            /**
+             * @enum Stage
+             * @brief The stages a message goes through, in the order of Latency
+             */
+            enum class Stage : std::size_t {
+                KERNEL_RECEIVE, /*!> From the kernel receive timestamp to the read */
+                DISPATCH,       /*!> From the read to the message callback */
+                CALLBACK,       /*!> The message callback */
+                QUEUE,          /*!> From the send call to the I/O thread taking the frame */
+                KERNEL_SEND,    /*!> From the write to the kernel send timestamp */
+                COUNT,          /*!> The number of stages */
+            };
+
+            /**
+             * @struct SendLog
+             * @brief The writes of a socket waiting for their send timestamp
+             */
+            struct SendLog {
+                    std::deque<std::pair<std::uint32_t, Socket::Timestamp>> pending; /*!> The key and time of each write, oldest first */
+                    std::uint32_t next = 0;                                          /*!> The key of the next datagram, or the index of the next byte */
+            };
+
+            /**
+             * @brief Enable or disable the tracing (safe to call from any thread)
+             *
+             * @param enable If the stages should be measured
+             */
+            void setEnabled(bool enable);
+
+            /**
+             * @brief Check whether the tracing is enabled (safe to call from any thread)
+             *
+             * @return true if the stages are measured, false otherwise
+             */
+            bool isEnabled() const;
+
+            /**
+             * @brief Record the latency of a stage (I/O thread only)
+             *
+             * @param stage The stage
+             * @param latency The time the stage took
+             */
+            void record(Stage stage, std::chrono::nanoseconds latency);
+
+            /**
+             * @brief Record the time between the kernel receiving data and its read, now (I/O thread only)
+             *
+             * @param kernelTime The kernel receive timestamp, ignored if epoch
+             */
+            void onReceive(Socket::Timestamp kernelTime);
+
+            /**
+             * @brief Remember a write waiting for its send timestamp (I/O thread only)
+             *
+             * @param log The writes of the socket
+             * @param bytes The number of bytes written
+             * @param stream If the socket is a stream socket, keying its timestamps by byte instead of by datagram
+             * @param writeTime The time the write started
+             */
+            void onSent(SendLog& log, std::size_t bytes, bool stream, Socket::Timestamp writeTime);
+
+            /**
+             * @brief Match a send timestamp with its write and record the time between them (I/O thread only)
+             *
+             * @param log The writes of the socket
+             * @param key The key of the timestamp
+             * @param kernelTime The kernel send timestamp
+             */
+            void onSendTimestamp(SendLog& log, std::uint32_t key, Socket::Timestamp kernelTime);
+
+            /**
+             * @brief Compute the distribution of each stage (safe to call from any thread)
+             *
+             * @return Latency The latency of each stage
+             */
+            Latency getLatency() const;
+
+        private:
+            std::array<utils::Histogram, static_cast<std::size_t>(Stage::COUNT)> histograms_; /*!> The latencies of each stage, in nanoseconds */
+            std::atomic<bool> enabled_{false};                                                /*!> If the stages are measured */
+    };
+}
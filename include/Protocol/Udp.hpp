@@ -2,28 +2,67 @@
 #pragma once
 
 #include "Enum/Connection.hpp"
+#include "Data/Outbound.hpp"
 #include "Data/Endpoint.hpp"
+#include "Data/Packet.hpp"
+#include "Utils/Wakeup.hpp"
+#include "Utils/Ring.hpp"
+#include "Utils/DelayQueue.hpp"
+#include "Protocol/Scheduler.hpp"
+#include "Protocol/Reliability.hpp"
+#include "Protocol/CongestionControl.hpp"
+#include "Protocol/Meter.hpp"
+#include "Protocol/Tracer.hpp"
+#include "Protocol/Impairer.hpp"
+#include "Data/PathStats.hpp"
 #include "Socket.hpp"
 
+#include <unordered_map>
+#include <unordered_set>
+#include <shared_mutex>
+#include <optional>
 #include <cstdint>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <thread>
 
 namespace glnet
 {
+    class Manager;
+
     class Udp
     {
         public:
             /**
-             * @brief Construct a new Udp object
-             *
-             * @param endpoint The endpoint on which to create the object
+             * @struct Header
+             * @brief The header written before the frame of every datagram (shared with the other writers of the wire format, such as ClientPool)
              */
-            Udp(Endpoint endpoint, connection::Side side);
+            struct Header {
+                    std::uint8_t delivery;  /*!> The delivery mode of the datagram */
+                    std::uint8_t channel;   /*!> The channel of the datagram */
+                    std::uint16_t sequence; /*!> The sequence number of the datagram on a reliable channel */
+                    std::uint16_t ack;      /*!> The most recent sequence received on the channel */
+                    std::uint8_t flags;     /*!> The FLAG_* bits of the datagram */
+                    std::uint8_t reserved;  /*!> Padding, always zero */
+                    std::uint32_t ackBits;  /*!> The 32 sequences preceding ack that were received */
+            };
+
+            static constexpr std::uint8_t FLAG_ACK = 0x1;      /*!> The ack fields of the header are set */
+            static constexpr std::uint8_t FLAG_ACK_ONLY = 0x2; /*!> The datagram only carries acknowledgements */
+            static constexpr std::uint8_t FLAG_FRAGMENT = 0x4; /*!> The datagram carries a fragment header and a part of the frame */
+
+            static constexpr std::size_t MAX_DATAGRAM_SIZE = 1200; /*!> The largest datagram written, below the path mtu of common networks */
+            static constexpr std::size_t MAX_RECEIVE_SIZE = 65536; /*!> The largest datagram read, so that no datagram is truncated */
 
             /**
              * @brief Construct a new Udp object
+             *
+             * @param manager The manager owning the udp instance
+             * @param endpoint The endpoint on which to create the object
+             * @param side The side of the connection (client or server)
              */
-            Udp();
+            Udp(Manager& manager, Endpoint endpoint, connection::Side side);
 
             /**
              * @brief Stop the udp instance
@@ -31,37 +70,411 @@ namespace glnet
             void stop();
 
             /**
-             * @brief Main loop of the udp instance
+             * @brief Main loop of the udp instance (threaded mode)
              */
             void run();
 
+            /**
+             * @brief Handle the events reported on the pollfd array and write the queued frames
+             */
+            void process();
+
+            /**
+             * @brief Get the pollfd array of the udp instance, to poll it along with other instances
+             *
+             * @return std::vector<Socket::PollFd>& The pollfd array
+             */
+            std::vector<Socket::PollFd>& getPollFds();
+
             /**
              * @brief Read from the udp socket
              */
             void readFromSocket();
 
             /**
-             * @brief Send a message to a given socket
+             * @brief Queue a frame to be written by the udp thread (safe to call from any thread)
+             *
+             * @param outbound The frame and its destination
+             * @return true if the frame was queued, false if the outbound queue is full, the frame is missing or too large to be fragmented, or its reliable channel holds Reliability::MAX_PENDING messages
+             */
+            bool enqueue(Outbound outbound);
+
+            /**
+             * @brief Get the time left before the next retransmission is due or a datagram held back by the rate limits can be written
+             *
+             * @return std::int32_t The timeout in milliseconds, -1 if nothing is waiting for an acknowledgement or held back by the rate limits
+             */
+            std::int32_t getTimeout() const;
+
+            /**
+             * @brief Get the rate limiter of the outbound datagrams
+             *
+             * @return RateLimiter& The rate limiter, whose setters are safe to call from any thread
+             */
+            RateLimiter& getRateLimiter();
+
+            /**
+             * @brief Get the network impairment applied to the datagrams in both directions
+             *
+             * @return Impairer& The impairer, whose setters are safe to call from any thread
+             */
+            Impairer& getImpairer();
+
+            /**
+             * @brief Cap the send rate of each peer at the target rate of its congestion controller (safe to call from any thread)
+             *
+             * @param enable If the target rates are enforced
+             */
+            void setAdaptiveRate(bool enable);
+
+            /**
+             * @brief Get what the congestion controller measured on the path to a peer (safe to call from any thread)
+             *
+             * @param clientId The id of the peer (0 for the server on client side)
+             * @return std::optional<PathStats> The statistics of the path, std::nullopt before the first update of its congestion controller
+             */
+            std::optional<PathStats> getPathStats(std::uint32_t clientId);
+
+            /**
+             * @brief Aggregate the counters of the udp instance and of its peers (safe to call from any thread)
+             *
+             * @return TransportMetrics The counters
+             */
+            TransportMetrics getMetrics() const;
+
+            /**
+             * @brief Enable the latency tracing: kernel timestamps on the socket and glnet timestamps at each stage (safe to call from any thread)
              *
-             * @param endpoint The endpoint where to send the message
-             * @param packet The packet to send
+             * @param enable If the latency should be traced
              */
-            void sendToEndpoint(Endpoint endpoint, Packet& packet);
+            void setTracing(bool enable);
+
+            /**
+             * @brief Get the latency of each stage traced so far (safe to call from any thread)
+             *
+             * @return Latency The latency of each stage
+             */
+            Latency getLatency() const;
+
+            /**
+             * @brief Drop the channel state of a disconnected peer (safe to call from any thread, never lost to a full outbound queue)
+             *
+             * @param clientId The id of the peer
+             */
+            void forget(std::uint32_t clientId);
 
         private:
             /**
-             * @brief Read the header of the datagram issued to the server
+             * @struct FragmentHeader
+             * @brief The header written after the datagram header when a frame is split over several datagrams
+             */
+            struct FragmentHeader {
+                    std::uint16_t messageId; /*!> The id shared by the fragments of a frame */
+                    std::uint16_t index;     /*!> The position of the fragment in the frame */
+                    std::uint16_t count;     /*!> The number of fragments of the frame */
+                    std::uint16_t reserved;  /*!> Padding, always zero */
+            };
+
+            /**
+             * @struct Reassembly
+             * @brief A fragmented frame being received
+             */
+            struct Reassembly {
+                    std::vector<std::uint8_t> bytes;          /*!> The bytes of the frame, each fragment at its offset */
+                    std::vector<bool> received;               /*!> The fragments received so far */
+                    std::uint16_t count;                      /*!> The number of fragments of the frame */
+                    std::uint16_t receivedCount;              /*!> The number of fragments received */
+                    std::size_t size;                         /*!> The size of the frame, known once the last fragment is received */
+                    Reliability::Clock::time_point updatedAt; /*!> The time the last new fragment was received */
+            };
+
+            /**
+             * @struct Delayed
+             * @brief A datagram held back by the impairer
+             */
+            struct Delayed {
+                    std::uint32_t clientId;          /*!> The id of the peer */
+                    Endpoint endpoint;               /*!> The endpoint of the peer (outbound only) */
+                    std::vector<std::uint8_t> bytes; /*!> The datagram */
+            };
+
+            /**
+             * @struct Sequenced
+             * @brief The state of an unreliable-sequenced channel
+             */
+            struct Sequenced {
+                    std::uint16_t nextSequence = 0; /*!> The sequence number of the next message to send */
+                    std::uint16_t lastReceived = 0; /*!> The most recent sequence received */
+                    bool received = false;          /*!> If a message was received */
+            };
+
+            static constexpr std::size_t MAX_FRAGMENT_PAYLOAD = MAX_DATAGRAM_SIZE - sizeof(Header) - sizeof(FragmentHeader); /*!> The part of the frame carried by each fragment */
+            static constexpr std::size_t MAX_FRAGMENTS = 256;                                                                /*!> The highest number of fragments of a frame */
+            static constexpr std::size_t MAX_MESSAGE_SIZE = MAX_FRAGMENTS * MAX_FRAGMENT_PAYLOAD;                            /*!> The largest frame that can be sent */
+            static constexpr std::size_t MAX_REASSEMBLIES_PER_PEER = 8;                                                      /*!> The highest number of frames reassembled at once for a peer */
+            static constexpr std::size_t MAX_REASSEMBLIES = 64;                                                              /*!> The highest number of frames reassembled at once for all the peers, bounding the memory */
+            static constexpr std::chrono::milliseconds REASSEMBLY_TIMEOUT{2000};                                             /*!> The time without a new fragment after which an incomplete frame is dropped, above Reliability::MAX_RTO for the retransmissions to complete it */
+
+            static constexpr std::size_t WAKEUP_POLL_INDEX = 1; /*!> The index of the wakeup fd in the pollfd array */
+            static constexpr std::size_t MAX_FLUSH_BATCH = 256; /*!> The maximum number of datagrams written per loop iteration */
+
+            /**
+             * @brief Write the queued frames to their endpoints
+             */
+            void flushOutbound();
+
+            /**
+             * @brief Send the reliable frames that fit in their send window, and resend those whose retransmission timeout expired
+             */
+            void transmit();
+
+            /**
+             * @brief Send a standalone acknowledgement on the channels that received data but had nothing to send back
+             */
+            void sendAcks();
+
+            /**
+             * @brief Get the congestion controller of a peer, creating it if needed
+             *
+             * @param clientId The id of the peer
+             * @return CongestionControl& The congestion controller
+             */
+            CongestionControl& getCongestion(std::uint32_t clientId);
+
+            /**
+             * @brief Update the target rates whose interval elapsed, publish them and apply them to the rate limiter if enabled
+             *
+             * @param now The current time
+             */
+            void updateCongestion(Reliability::Clock::time_point now);
+
+            /**
+             * @brief Drop the state of the peers forgotten since the last call, with their scheduled frames
+             */
+            void dropForgotten();
+
+            /**
+             * @brief Drop the reliable and sequenced channels and the congestion controller of a peer
+             *
+             * @param clientId The id of the peer
+             */
+            void dropPeer(std::uint32_t clientId);
+
+            /**
+             * @brief Count a reliable message in the backlog of its channel (safe to call from any thread)
+             *
+             * @param key The key of the channel
+             * @return true if the message was counted, false if the channel already holds Reliability::MAX_PENDING messages or its peer is unknown
+             */
+            bool reserve(std::uint64_t key);
+
+            /**
+             * @brief Forget the backlog of a channel whose peer is gone
+             *
+             * @param key The key of the channel
+             */
+            void dropBacklog(std::uint64_t key);
+
+            /**
+             * @brief Remove acknowledged or dropped reliable messages from the backlog of their channel
+             *
+             * @param key The key of the channel
+             * @param count The number of messages
+             */
+            void release(std::uint64_t key, std::size_t count);
+
+            /**
+             * @brief Get the key of a channel in the channel map
+             *
+             * @param clientId The id of the peer
+             * @param channel The channel number
+             * @return std::uint64_t The key of the channel
+             */
+            static std::uint64_t channelKey(std::uint32_t clientId, std::uint8_t channel);
+
+            /**
+             * @brief Get the reliability state of a channel, creating it if needed
+             *
+             * @param clientId The id of the peer
+             * @param channel The channel number
+             * @return Reliability& The state of the channel
+             */
+            Reliability& getChannel(std::uint32_t clientId, std::uint8_t channel);
+
+            /**
+             * @brief Get the endpoint of a peer
+             *
+             * @param clientId The id of the peer (ignored on the client side)
+             * @param endpoint The endpoint to fill
+             * @return true if the peer is known, false otherwise
+             */
+            bool resolveEndpoint(std::uint32_t clientId, Endpoint& endpoint);
+
+            /**
+             * @brief Prefix a frame with its header, piggybacking the acknowledgements of the channel, and send it
+             *
+             * @param clientId The id of the peer
+             * @param endpoint The endpoint of the peer
+             * @param header The header of the datagram, without the ack fields
+             * @param frame The frame to send, nullptr for an acknowledgement alone
+             * @param messageId The id of the fragments, if the frame is fragmented
+             */
+            void sendDatagram(std::uint32_t clientId, const Endpoint& endpoint, Header header, const Frame& frame, std::uint16_t messageId = 0);
+
+            /**
+             * @brief Take a message id for a frame that is fragmented
+             *
+             * @param frame The frame to send
+             * @return std::uint16_t A new id if the frame does not fit in a datagram, 0 otherwise
+             */
+            std::uint16_t takeMessageId(const Frame& frame);
+
+            /**
+             * @brief Send a datagram to a given endpoint, through the impairer if it is active
+             *
+             * @param clientId The id of the peer
+             * @param endpoint The endpoint where to send the datagram
+             * @param datagram The datagram to send
+             * @param counters The counters of the peer
+             */
+            void sendToEndpoint(std::uint32_t clientId, const Endpoint& endpoint, const std::vector<std::uint8_t>& datagram, Meter::Counters& counters);
+
+            /**
+             * @brief Write a datagram to the socket
+             *
+             * @param endpoint The endpoint where to send the datagram
+             * @param datagram The datagram to send
+             * @param counters The counters of the peer
+             */
+            void writeDatagram(const Endpoint& endpoint, const std::vector<std::uint8_t>& datagram, Meter::Counters& counters);
+
+            /**
+             * @brief Handle a received datagram: acknowledgements, reassembly, sequencing and delivery
              *
-             * @param endpoint The endpoint to read from
+             * @param clientId The id of the sender
+             * @param data The datagram, starting with its header
+             * @param size The size of the datagram, at least the size of a header
+             */
+            void handleDatagram(std::uint32_t clientId, const std::uint8_t *data, std::size_t size);
+
+            /**
+             * @brief Release the datagrams held by the impairer that are due, or all of them if the impairment of their direction was removed
+             */
+            void releaseDelayed();
+
+            /**
+             * @brief Call the message callback, timing it
+             *
+             * @param clientId The id of the sender
+             * @param packet The received message
+             */
+            void deliver(std::uint32_t clientId, Packet& packet);
+
+            /**
+             * @brief Enable or disable the kernel timestamps of the socket to match the tracer, and restart the send log
+             */
+            void applyTracing();
+
+            /**
+             * @brief Read the kernel send timestamps queued on the socket and match them with its datagrams
+             */
+            void readSendTimestamps();
+
+            /**
+             * @brief Read a datagram issued to the socket into the receive buffer
+             *
+             * @param addr The address of the sender
+             * @param len The length of the address
+             * @return std::size_t The number of bytes read, 0 if the datagram is too short to hold a header
+             */
+            std::size_t readDatagram(Socket::Address& addr, Socket::AddressLength& len);
+
+            /**
+             * @brief Parse a frame into a packet, checking its length header against the received size
+             *
+             * @param data The frame
+             * @param size The size of the frame
              * @param packet The packet to store the information in
-             * @return std::size_t The number of bytes read
+             * @return true if the frame is well formed, false otherwise
              */
-            std::size_t readDatagram(Socket::Address& addr, Socket::AddressLength& len, Packet& packet);
+            static bool readPacket(const std::uint8_t *data, std::size_t size, Packet& packet);
 
-            connection::Side side_; /*!> The side of the connection (client or server) */
-            bool running_;                /*!> If the tcp instance should run */
+            /**
+             * @brief Store a fragment in the reassembly table
+             *
+             * @param clientId The id of the sender
+             * @param data The fragment, starting with its fragment header
+             * @param size The size of the fragment
+             * @param message Filled with the frame when the fragment completes it
+             * @return true if the frame is complete, false otherwise
+             */
+            bool reassemble(std::uint32_t clientId, const std::uint8_t *data, std::size_t size, std::vector<std::uint8_t>& message);
+
+            /**
+             * @brief Drop the frame of a peer that received no new fragment for the longest time
+             *
+             * @param clientId The id of the peer
+             */
+            void evictReassembly(std::uint32_t clientId);
+
+            /**
+             * @brief Release the slot of a frame leaving the reassembly table
+             *
+             * @param key The key of the frame, holding the id of its sender
+             */
+            void releaseReassembly(std::uint64_t key);
+
+            /**
+             * @brief Drop the frames whose fragments did not all arrive in time
+             *
+             * @param now The current time
+             */
+            void expireReassemblies(Reliability::Clock::time_point now);
+
+            Manager& manager_;          /*!> The manager owning the udp instance */
+            connection::Side side_;     /*!> The side of the connection (client or server) */
+            std::atomic<bool> running_; /*!> If the udp instance should run */
 
             Socket socket_;                       /*!> The udp socket */
-            std::vector<Socket::PollFd> pollFds_; /*!> The pollfd array for the tcp instance */
+            std::vector<Socket::PollFd> pollFds_; /*!> The pollfd array for the udp instance */
+
+            utils::Ring<Outbound> outbound_;       /*!> The datagrams waiting to be written */
+            std::vector<std::uint32_t> forgotten_; /*!> The peers disconnected since the last flush, kept out of the ring so a full ring cannot lose them */
+            std::vector<std::uint32_t> dropping_;  /*!> The forgotten peers being dropped, swapped with the list */
+            std::mutex forgottenMutex_;            /*!> Guard of the forgotten peers against the producers */
+            Scheduler scheduler_;                  /*!> The datagrams taken from the ring, ordered by peer and priority */
+            RateLimiter limiter_;                  /*!> The bandwidth limits of the peers */
+            utils::Wakeup wakeup_;                 /*!> The wakeup signaled when datagrams are queued */
+            Meter meter_;                          /*!> The traffic counters of the peers */
+            Tracer tracer_;                        /*!> The latency histograms of the stages */
+            bool tracingApplied_ = false;          /*!> If the socket has its kernel timestamps enabled */
+            Tracer::SendLog sendLog_;              /*!> The datagrams waiting for their kernel send timestamp */
+            Tracer::Clock::time_point readAt_;     /*!> The time of the last read, while the latency is traced */
+
+            std::unordered_map<std::uint64_t, Reliability> channels_; /*!> The reliable channels, keyed by peer and channel number */
+            std::unordered_map<std::uint64_t, Sequenced> sequenced_;  /*!> The unreliable-sequenced channels, keyed by peer and channel number */
+            std::unordered_set<std::uint64_t> ackPending_;            /*!> The channels owing an acknowledgement to their peer */
+            std::vector<const Reliability::Pending *> transmitted_;   /*!> Scratch list of the reliable frames to send */
+            std::vector<Packet> delivered_;                           /*!> Scratch list of the packets released by a reliable channel */
+
+            std::unordered_map<std::uint64_t, std::unique_ptr<std::atomic<std::size_t>>> backlogs_; /*!> The reliable messages queued and not acknowledged yet, by channel, counted by the producers */
+            std::shared_mutex backlogsMutex_;                                                       /*!> Guard of the backlogs map against the producers */
+            std::vector<std::uint8_t> sendBuffer_;                                                  /*!> The buffer the datagrams are assembled in */
+            std::vector<std::uint8_t> receiveBuffer_;                                               /*!> The buffer the datagrams are read in */
+
+            std::unordered_map<std::uint64_t, Reassembly> reassemblies_;      /*!> The fragmented frames being received, keyed by sender and message id */
+            std::unordered_map<std::uint32_t, std::size_t> reassemblyCounts_; /*!> The number of frames being reassembled, by sender */
+            std::vector<std::uint8_t> reassembled_;                           /*!> The last frame completed by the reassembly table */
+            std::uint16_t nextMessageId_ = 0;                                 /*!> The message id of the next fragmented frame */
+
+            std::unordered_map<std::uint32_t, CongestionControl> congestion_; /*!> The congestion controllers of the peers */
+            std::atomic<bool> adaptiveRate_{false};                           /*!> If the target rates should be enforced */
+            bool adaptiveApplied_ = false;                                    /*!> If the target rates are enforced by the rate limiter */
+            std::mutex statsMutex_;                                           /*!> Guard of the published statistics */
+            std::unordered_map<std::uint32_t, PathStats> stats_;              /*!> The statistics of the paths, published at each update */
+
+            Impairer impairer_;                     /*!> The simulated network conditions */
+            utils::DelayQueue<Delayed> delayedIn_;  /*!> The received datagrams held by the impairer */
+            utils::DelayQueue<Delayed> delayedOut_; /*!> The sent datagrams held by the impairer */
     };
 }
@@ -7,10 +7,12 @@
 #ifdef _WIN32
 #include <winsock2.h>
 #include <ws2tcpip.h>
+#include <afunix.h>
 #pragma comment(lib, "ws2_32.lib")
 #else
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <poll.h>
@@ -18,6 +20,7 @@
 
 #include <optional>
 #include <cstdint>
+#include <chrono>
 #include <vector>
 #include <any>
 
@@ -67,6 +70,11 @@ namespace glnet
              */
             using Address_in = struct sockaddr_in;
 
+            /**
+             * @brief Socket address, unix domain style
+             */
+            using Address_un = struct sockaddr_un;
+
 #ifdef _WIN32
             /**
              * @brief Length type for addresses on Windows
@@ -147,12 +155,18 @@ namespace glnet
              */
             using Buffer = void *;
 
+            /**
+             * @brief Kernel timestamp type, on the realtime clock (epoch when the kernel gave none)
+             */
+            using Timestamp = std::chrono::system_clock::time_point;
+
             /**
              * @brief Construct a new Socket object
              *
-             * @param type The type of the socket (TCP or UDP)
+             * @param type The type of the socket (TCP, UDP or LOCAL)
+             * @param localMode The socket type of a LOCAL socket (stream or seqpacket)
              */
-            Socket(connection::Type type, Endpoint endpoint);
+            Socket(connection::Type type, Endpoint endpoint, connection::LocalMode localMode = connection::LocalMode::STREAM);
 
             /**
              * @brief Construct a new Socket object from an existing file descriptor
@@ -212,6 +226,15 @@ namespace glnet
              */
             Socket accept(OptionalReference<Address> addr = std::nullopt, OptionalReference<AddressLength> addrLen = std::nullopt);
 
+            /**
+             * @brief Accept a pending connection without blocking, the accepted socket is non-blocking and closed on exec (accept4 on Linux)
+             *
+             * @param addr The address of the connecting entity
+             * @param addrLen The length of the address
+             * @return Fd The file descriptor of the accepted socket, INVALID_FD if no connection is pending
+             */
+            Fd tryAccept(Address& addr, AddressLength& addrLen);
+
             /**
              * @brief Connect to a remote address
              *
@@ -221,6 +244,34 @@ namespace glnet
              */
             void connect(const Address& addr, AddressLength addrLen);
 
+            /**
+             * @brief Start connecting to a remote address without blocking (the socket must be non-blocking)
+             *
+             * @param addr The address to connect to
+             * @param addrLen The length of the address
+             * @return true if the connection is established, false if it is in progress
+             */
+            bool tryConnect(const Address& addr, AddressLength addrLen);
+
+            /**
+             * @brief Set the blocking mode of the socket
+             *
+             * @param blocking Whether the socket operations should block
+             */
+            void setBlocking(bool blocking);
+
+            /**
+             * @brief Close the file descriptor, even if the socket doesn't own it (used to drop a client from the server side)
+             */
+            void close();
+
+            /**
+             * @brief Get and clear the pending error of the socket (used to check a non-blocking connect)
+             *
+             * @return std::int32_t The pending error code, 0 if none
+             */
+            std::int32_t getPendingError();
+
             /**
              * @brief Polls the socket for events
              *
@@ -229,7 +280,7 @@ namespace glnet
              * @param timeout The timeout in milliseconds (-1 for infinite)
              * @return std::int32_t The number of file descriptors with events, 0 on timeout, or -1 on error
              */
-            std::int32_t poll(std::vector<PollFd>& fds, NFDS nfds, std::int32_t timeout);
+            static std::int32_t poll(std::vector<PollFd>& fds, NFDS nfds, std::int32_t timeout);
 
             /**
              * @brief Sends data over the socket (for TCP sockets)
@@ -241,6 +292,25 @@ namespace glnet
              */
             BytesSent send(const Buffer& buffer, BufferLength length, std::int32_t flags);
 
+            /**
+             * @brief Sends as much data as the socket buffer accepts without blocking (the socket must be non-blocking on Windows)
+             *
+             * @param buffer The data to send
+             * @param length The length of the data to send
+             * @return BytesSent The number of bytes sent, 0 if the socket buffer is full
+             */
+            BytesSent trySend(const Buffer& buffer, BufferLength length);
+
+            /**
+             * @brief Sends data along with a file descriptor (SCM_RIGHTS) without blocking (for LOCAL sockets, Unix only)
+             *
+             * @param buffer The data to send, at least one byte for the descriptor to travel
+             * @param length The length of the data to send
+             * @param descriptor The file descriptor to pass, duplicated in the receiving process
+             * @return BytesSent The number of bytes sent, 0 if the socket buffer is full (the descriptor was not sent then)
+             */
+            BytesSent trySend(const Buffer& buffer, BufferLength length, Fd descriptor);
+
             /**
              * @brief Receives data from the socket (for TCP sockets)
              *
@@ -251,6 +321,35 @@ namespace glnet
              */
             BytesReceived recv(Buffer buffer, BufferLength length, std::int32_t flags);
 
+            /**
+             * @brief Receives the data available on the socket without blocking (the socket must be non-blocking on Windows)
+             *
+             * @param buffer The buffer to store the received data
+             * @param length The maximum length of data to receive
+             * @return std::optional<BytesReceived> The number of bytes received (0 if the peer closed the connection), std::nullopt if no data is available
+             */
+            std::optional<BytesReceived> tryRecv(Buffer buffer, BufferLength length);
+
+            /**
+             * @brief Receives the data available on the socket without blocking, with the time the kernel received it (see setTimestamping)
+             *
+             * @param buffer The buffer to store the received data
+             * @param length The maximum length of data to receive
+             * @param kernelTime Filled with the receive timestamp of the kernel, epoch if it gave none
+             * @return std::optional<BytesReceived> The number of bytes received (0 if the peer closed the connection), std::nullopt if no data is available
+             */
+            std::optional<BytesReceived> tryRecv(Buffer buffer, BufferLength length, Timestamp& kernelTime);
+
+            /**
+             * @brief Receives the data available on the socket without blocking, with the file descriptor passed along with it (for LOCAL sockets, Unix only)
+             *
+             * @param buffer The buffer to store the received data
+             * @param length The maximum length of data to receive, a seqpacket record longer than it being an error
+             * @param descriptor Filled with the received file descriptor, owned by the caller and closed on exec, INVALID_FD if none came with the data
+             * @return std::optional<BytesReceived> The number of bytes received (0 if the peer closed the connection), std::nullopt if no data is available
+             */
+            std::optional<BytesReceived> tryRecv(Buffer buffer, BufferLength length, Fd& descriptor);
+
             /**
              * @brief Sends data to a specific address (for UDP sockets)
              *
@@ -276,6 +375,35 @@ namespace glnet
             BytesReceived recvFrom(
                 Buffer buffer, BufferLength length, std::int32_t flags, OptionalReference<Address> srcAddr = std::nullopt, OptionalReference<AddressLength> srcAddrLen = std::nullopt);
 
+            /**
+             * @brief Receives data from a specific address, with the time the kernel received it (see setTimestamping)
+             *
+             * @param buffer The buffer to store the received data
+             * @param length The maximum length of data to receive
+             * @param srcAddr The source address
+             * @param srcAddrLen The length of the source address
+             * @param kernelTime Filled with the receive timestamp of the kernel, epoch if it gave none
+             * @return BytesReceived The number of bytes received
+             */
+            BytesReceived recvFrom(Buffer buffer, BufferLength length, Address& srcAddr, AddressLength& srcAddrLen, Timestamp& kernelTime);
+
+            /**
+             * @brief Enable the software receive and send timestamps of the kernel (SO_TIMESTAMPING), the send timestamps are keyed by datagram (udp) or by byte (tcp) from 0 when enabled
+             *
+             * @param enable Whether to enable or disable the timestamps
+             * @return true if the platform supports them, false otherwise
+             */
+            bool setTimestamping(bool enable);
+
+            /**
+             * @brief Read a send timestamp from the error queue of the socket without blocking (the queue makes the socket poll with POLLERR)
+             *
+             * @param key Filled with the key of the timestamped send: its datagram index (udp) or the index of its last byte (tcp)
+             * @param kernelTime Filled with the time the kernel handed the data to the device
+             * @return true if a timestamp was read, false if the queue holds none
+             */
+            bool readSendTimestamp(std::uint32_t& key, Timestamp& kernelTime);
+
             /**
              * @brief Get the socket name (local address)
              *
@@ -285,6 +413,15 @@ namespace glnet
              */
             std::int32_t getSockName(Address& addr, AddressLength& addrLen);
 
+            /**
+             * @brief Get the peer name (remote address)
+             *
+             * @param addr Reference to an Address structure to store the remote address
+             * @param addrLen Reference to an AddressLength variable to store the length of the remote address
+             * @return std::int32_t 0 on success, -1 on failure
+             */
+            std::int32_t getPeerName(Address& addr, AddressLength& addrLen);
+
             /**
              * @brief Get the Fd object
              *
@@ -314,7 +451,37 @@ namespace glnet
              */
             static InAddr inetAddr(std::string ip);
 
+            /**
+             * @brief Fill a unix domain address from a path, a leading '@' naming an abstract socket (Linux only)
+             *
+             * @param path The path of the socket
+             * @param addr The address to fill
+             * @return AddressLength The length of the address
+             */
+            static AddressLength localAddress(const std::string& path, Address_un& addr);
+
+            /**
+             * @brief Duplicate a file descriptor, closed on exec
+             *
+             * @param fd The file descriptor to duplicate
+             * @return Fd The new file descriptor
+             */
+            static Fd duplicate(Fd fd);
+
         private:
+            /**
+             * @brief Receive a message and its receive timestamp with recvmsg
+             *
+             * @param buffer The buffer to store the received data
+             * @param length The maximum length of data to receive
+             * @param flags Flags for receiving the data
+             * @param srcAddr The source address, nullptr if not wanted
+             * @param srcAddrLen The length of the source address, nullptr if not wanted
+             * @param kernelTime Filled with the receive timestamp of the kernel, epoch if it gave none
+             * @return BytesReceived The number of bytes received, or -1 on error
+             */
+            BytesReceived recvTimestamped(Buffer buffer, BufferLength length, std::int32_t flags, Address *srcAddr, AddressLength *srcAddrLen, Timestamp& kernelTime);
+
             /**
              * @brief Get the Last Error object
              *
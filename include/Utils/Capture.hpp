@@ -0,0 +1,165 @@
+
+#pragma once
+
+#include "Enum/Connection.hpp"
+
+#include <cstdint>
+#include <atomic>
+#include <string>
+
+namespace glnet::utils
+{
+    class Capture
+    {
+        public:
+            /**
+             * @enum Direction
+             * @brief The direction of a captured frame
+             */
+            enum class Direction : std::uint8_t {
+                IN,  /*!> Received from a peer */
+                OUT, /*!> Sent to a peer */
+            };
+
+            /**
+             * @struct FileHeader
+             * @brief The header at the start of a capture file
+             */
+            struct FileHeader {
+                    char magic[8];          /*!> MAGIC */
+                    std::uint32_t version;  /*!> VERSION */
+                    std::uint32_t reserved; /*!> Padding, always zero */
+            };
+
+            /**
+             * @struct RecordHeader
+             * @brief The header written before the payload of each frame, records being aligned on RECORD_ALIGNMENT
+             */
+            struct RecordHeader {
+                    std::int64_t timestamp;  /*!> The wall time of the frame in nanoseconds since the epoch, 0 for the end of the capture */
+                    std::uint32_t clientId;  /*!> The id of the peer (0 for the server on the client side) */
+                    std::uint32_t length;    /*!> The size of the payload */
+                    std::uint8_t direction;  /*!> The Direction of the frame */
+                    std::uint8_t transport;  /*!> The connection::Type of the frame */
+                    std::uint16_t reserved;  /*!> Padding, always zero */
+                    std::uint32_t reserved2; /*!> Padding, always zero */
+            };
+
+            static constexpr char MAGIC[8] = {'G', 'L', 'N', 'E', 'T', 'C', 'A', 'P'}; /*!> The first bytes of a capture file */
+            static constexpr std::uint32_t VERSION = 1;                                /*!> The version of the record format */
+            static constexpr std::size_t RECORD_ALIGNMENT = 8;                         /*!> The alignment of every record in the file */
+
+            /**
+             * @brief Construct a new Capture object, closed
+             */
+            Capture();
+
+            /**
+             * @brief Destroy the Capture object, closing the file
+             */
+            ~Capture();
+
+            /**
+             * @brief Delete the copy constructor of the Capture class
+             */
+            Capture(const Capture&) = delete;
+
+            /**
+             * @brief Delete the assignement operator of the Capture class
+             */
+            Capture& operator=(const Capture&) = delete;
+
+            /**
+             * @brief Create the capture file with a fixed capacity and map it, closing the previous one
+             *
+             * @param path The path of the file, truncated if it exists
+             * @param capacity The size of the file, frames that do not fit are dropped
+             */
+            void open(const std::string& path, std::size_t capacity);
+
+            /**
+             * @brief Wait for the frames being written, unmap the file and truncate it to the bytes written
+             */
+            void close();
+
+            /**
+             * @brief Check if frames are being captured (a relaxed load, cheap enough for every frame)
+             *
+             * @return true if the capture is open, false otherwise
+             */
+            bool isOpen() const;
+
+            /**
+             * @brief Append a frame (safe to call from any number of threads, lock-free)
+             *
+             * @param direction The direction of the frame
+             * @param type The transport of the frame
+             * @param clientId The id of the peer
+             * @param data The payload of the frame
+             * @param size The size of the payload
+             * @return true if the frame was written, false if the capture is closed or full
+             */
+            bool record(Direction direction, connection::Type type, std::uint32_t clientId, const std::uint8_t *data, std::size_t size);
+
+            /**
+             * @brief Get the number of frames dropped because the file was full
+             *
+             * @return std::uint64_t The number of frames
+             */
+            std::uint64_t getDropped() const;
+
+        private:
+            std::atomic<bool> open_;             /*!> If frames are accepted */
+            std::atomic<std::uint32_t> writers_; /*!> The number of frames being written, waited for by close */
+            std::atomic<std::size_t> offset_;    /*!> The offset of the next record, reserved by fetch_add */
+            std::atomic<std::uint64_t> dropped_; /*!> The number of frames dropped because the file was full */
+            std::uint8_t *base_;                 /*!> The mapping of the file */
+            std::size_t capacity_;               /*!> The size of the file and of the mapping */
+            int fd_;                             /*!> The file */
+    };
+
+    class CaptureReader
+    {
+        public:
+            /**
+             * @brief Map a capture file for reading
+             *
+             * @param path The path of the file
+             */
+            CaptureReader(const std::string& path);
+
+            /**
+             * @brief Destroy the CaptureReader object, unmapping the file
+             */
+            ~CaptureReader();
+
+            /**
+             * @brief Delete the copy constructor of the CaptureReader class
+             */
+            CaptureReader(const CaptureReader&) = delete;
+
+            /**
+             * @brief Delete the assignement operator of the CaptureReader class
+             */
+            CaptureReader& operator=(const CaptureReader&) = delete;
+
+            /**
+             * @brief Read the next frame, in the order the frames were reserved (close to, but not strictly, timestamp order)
+             *
+             * @param header The header of the frame
+             * @param data Set to the payload of the frame, valid until the reader is destroyed
+             * @return true if a frame was read, false at the end of the capture
+             */
+            bool next(Capture::RecordHeader& header, const std::uint8_t *& data);
+
+            /**
+             * @brief Go back to the first frame
+             */
+            void rewind();
+
+        private:
+            const std::uint8_t *base_; /*!> The mapping of the file */
+            std::size_t size_;         /*!> The size of the file */
+            std::size_t offset_;       /*!> The offset of the next record */
+    };
+}
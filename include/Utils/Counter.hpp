@@ -0,0 +1,77 @@
+
+#pragma once
+
+#include "Utils/Ring.hpp"
+
+#include <cstdint>
+#include <atomic>
+#include <array>
+
+namespace glnet::utils
+{
+    class Counter
+    {
+        public:
+            /**
+             * @brief Add to the counter, must only be called by the thread owning it (a plain load and store, no locked instruction)
+             *
+             * @param value The value to add
+             */
+            void add(std::uint64_t value = 1);
+
+            /**
+             * @brief Set the counter, used as a gauge (must only be called by the thread owning it)
+             *
+             * @param value The new value
+             */
+            void set(std::uint64_t value);
+
+            /**
+             * @brief Read the counter (safe to call from any thread)
+             *
+             * @return std::uint64_t The value of the counter
+             */
+            std::uint64_t get() const;
+
+        private:
+            std::atomic<std::uint64_t> value_{0}; /*!> The value of the counter */
+    };
+
+    class SharedCounter
+    {
+        public:
+            static constexpr std::size_t SHARD_COUNT = 16; /*!> The number of shards the writing threads are spread over */
+
+            /**
+             * @brief Add to the shard of the calling thread (safe to call from any number of threads)
+             *
+             * @param value The value to add
+             */
+            void add(std::uint64_t value = 1);
+
+            /**
+             * @brief Sum the shards (safe to call from any thread)
+             *
+             * @return std::uint64_t The value of the counter
+             */
+            std::uint64_t get() const;
+
+        private:
+            /**
+             * @struct Shard
+             * @brief A part of the counter alone on its cache line
+             */
+            struct alignas(CACHE_LINE_SIZE) Shard {
+                    std::atomic<std::uint64_t> value{0}; /*!> The part of the counter written by the threads mapped to this shard */
+            };
+
+            /**
+             * @brief Get the shard of the calling thread, given in turn to the threads on their first use
+             *
+             * @return std::size_t The index of the shard
+             */
+            static std::size_t getShard();
+
+            std::array<Shard, SHARD_COUNT> shards_; /*!> The shards of the counter */
+    };
+}
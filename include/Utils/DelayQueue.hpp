@@ -0,0 +1,95 @@
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <vector>
+
+namespace glnet::utils
+{
+    template <typename T>
+    class DelayQueue
+    {
+        public:
+            /**
+             * @brief Clock of the release times
+             */
+            using Clock = std::chrono::steady_clock;
+
+            /**
+             * @brief Hold a value until a given time
+             *
+             * @param at The time the value is released
+             * @param value The value to hold
+             */
+            void push(Clock::time_point at, T&& value)
+            {
+                entries_.push_back({at, nextSequence_++, std::move(value)});
+                std::push_heap(entries_.begin(), entries_.end(), Later());
+            }
+
+            /**
+             * @brief Release the earliest value due, the values due at the same time in the order they were pushed
+             *
+             * @param now The current time
+             * @param value The value to fill
+             * @return true if a value was released, false if none is due
+             */
+            bool pop(Clock::time_point now, T& value)
+            {
+                if (entries_.empty() || entries_.front().at > now) {
+                    return false;
+                }
+                std::pop_heap(entries_.begin(), entries_.end(), Later());
+                value = std::move(entries_.back().value);
+                entries_.pop_back();
+                return true;
+            }
+
+            /**
+             * @brief Get the time the earliest value is due
+             *
+             * @return Clock::time_point The release time, Clock::time_point::max() if the queue is empty
+             */
+            Clock::time_point getNextDeadline() const
+            {
+                return entries_.empty() ? Clock::time_point::max() : entries_.front().at;
+            }
+
+            /**
+             * @brief Check if the queue holds no value
+             *
+             * @return true if the queue is empty, false otherwise
+             */
+            bool empty() const
+            {
+                return entries_.empty();
+            }
+
+        private:
+            /**
+             * @struct Entry
+             * @brief A value and its release time
+             */
+            struct Entry {
+                    Clock::time_point at;   /*!> The time the value is released */
+                    std::uint64_t sequence; /*!> The order of the push, to release the values due at the same time in order */
+                    T value;                /*!> The value held */
+            };
+
+            /**
+             * @struct Later
+             * @brief Order the heap by release time then push order, earliest on top
+             */
+            struct Later {
+                    bool operator()(const Entry& a, const Entry& b) const
+                    {
+                        return a.at != b.at ? a.at > b.at : a.sequence > b.sequence;
+                    }
+            };
+
+            std::vector<Entry> entries_;     /*!> The values held, as a heap */
+            std::uint64_t nextSequence_ = 0; /*!> The sequence of the next push */
+    };
+}
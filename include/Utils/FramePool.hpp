@@ -0,0 +1,31 @@
+
+#pragma once
+
+#include <cstddef>
+
+namespace glnet::utils
+{
+    class FramePool
+    {
+        public:
+            static constexpr std::size_t BLOCK_GRANULARITY = 64;      /*!> The size step between two size classes */
+            static constexpr std::size_t MAX_POOLED_SIZE = 4096;      /*!> The largest frame served by the pool, larger ones use the global allocator */
+            static constexpr std::size_t MAX_BLOCKS_PER_CLASS = 4096; /*!> The maximum number of free blocks kept per size class */
+
+            /**
+             * @brief Allocate a coroutine frame from the free lists of the calling thread
+             *
+             * @param size The size of the frame
+             * @return void* The allocated frame
+             */
+            static void *allocate(std::size_t size);
+
+            /**
+             * @brief Give a coroutine frame back to the free lists of the calling thread
+             *
+             * @param ptr The frame to release
+             * @param size The size of the frame, as given to allocate
+             */
+            static void deallocate(void *ptr, std::size_t size);
+    };
+}
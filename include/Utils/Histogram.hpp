@@ -0,0 +1,58 @@
+
+#pragma once
+
+#include "Utils/Counter.hpp"
+#include "Data/Latency.hpp"
+
+#include <cstdint>
+#include <chrono>
+#include <array>
+
+namespace glnet::utils
+{
+    class Histogram
+    {
+        public:
+            static constexpr std::size_t SUB_BUCKET_BITS = 4;                                                /*!> The number of bits of precision kept, bounding the relative error at 1 / 2^SUB_BUCKET_BITS */
+            static constexpr std::size_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;                            /*!> The number of buckets per power of two */
+            static constexpr std::size_t MAX_BITS = 40;                                                      /*!> The number of bits of the highest value told apart (about 18 minutes in nanoseconds) */
+            static constexpr std::size_t BUCKET_COUNT = (MAX_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT; /*!> The number of buckets */
+
+            /**
+             * @brief Record a value, must only be called by the thread owning the histogram
+             *
+             * @param value The value, the values above 2^MAX_BITS fall in the last bucket
+             */
+            void record(std::uint64_t value);
+
+            /**
+             * @brief Compute the count, extremes, mean and percentiles of the values, in nanoseconds (safe to call from any thread)
+             *
+             * @return LatencyStats The distribution of the values
+             */
+            LatencyStats getStats() const;
+
+        private:
+            /**
+             * @brief Get the bucket of a value: exact below SUB_BUCKET_COUNT, then SUB_BUCKET_COUNT linear buckets per power of two
+             *
+             * @param value The value
+             * @return std::size_t The index of the bucket
+             */
+            static std::size_t getBucket(std::uint64_t value);
+
+            /**
+             * @brief Get the middle of the values of a bucket
+             *
+             * @param bucket The index of the bucket
+             * @return std::uint64_t The middle value
+             */
+            static std::uint64_t getValue(std::size_t bucket);
+
+            std::array<Counter, BUCKET_COUNT> buckets_; /*!> The number of values in each bucket */
+            Counter count_;                             /*!> The number of values */
+            Counter sum_;                               /*!> The sum of the values */
+            Counter min_;                               /*!> The lowest value */
+            Counter max_;                               /*!> The highest value */
+    };
+}
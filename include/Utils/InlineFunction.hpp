@@ -0,0 +1,152 @@
+
+#pragma once
+
+#include <type_traits>
+#include <cstddef>
+#include <utility>
+#include <new>
+
+namespace glnet::utils
+{
+    template <typename Signature, std::size_t Size = 48>
+    class InlineFunction;
+
+    template <typename R, typename... Args, std::size_t Size>
+    class InlineFunction<R(Args...), Size>
+    {
+        public:
+            /**
+             * @brief Construct an empty InlineFunction object
+             */
+            InlineFunction() = default;
+
+            /**
+             * @brief Construct a new InlineFunction object storing the callable in place (no allocation)
+             *
+             * @tparam F The type of the callable, which must fit in the inline storage
+             * @param func The callable to store
+             */
+            template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InlineFunction>>>
+            InlineFunction(F&& func)
+            {
+                using Callable = std::decay_t<F>;
+
+                static_assert(sizeof(Callable) <= Size, "Callable is too large for the inline storage");
+                static_assert(alignof(Callable) <= alignof(std::max_align_t), "Callable is over-aligned for the inline storage");
+                static_assert(std::is_invocable_r_v<R, Callable&, Args...>, "Callable does not match the signature");
+
+                ::new (storage_) Callable(std::forward<F>(func));
+                invoke_ = [](void *storage, Args... args) -> R {
+                    return (*static_cast<Callable *>(storage))(std::forward<Args>(args)...);
+                };
+                manage_ = [](Operation operation, void *dst, void *src) {
+                    switch (operation) {
+                        case Operation::COPY:
+                            ::new (dst) Callable(*static_cast<const Callable *>(src));
+                            break;
+                        case Operation::MOVE:
+                            ::new (dst) Callable(std::move(*static_cast<Callable *>(src)));
+                            static_cast<Callable *>(src)->~Callable();
+                            break;
+                        case Operation::DESTROY:
+                            static_cast<Callable *>(dst)->~Callable();
+                            break;
+                    }
+                };
+            }
+
+            /**
+             * @brief Copy constructor of the InlineFunction class
+             */
+            InlineFunction(const InlineFunction& other) : invoke_(other.invoke_), manage_(other.manage_)
+            {
+                if (manage_) {
+                    manage_(Operation::COPY, storage_, const_cast<unsigned char *>(other.storage_));
+                }
+            }
+
+            /**
+             * @brief Move constructor of the InlineFunction class
+             */
+            InlineFunction(InlineFunction&& other) noexcept : invoke_(other.invoke_), manage_(other.manage_)
+            {
+                if (manage_) {
+                    manage_(Operation::MOVE, storage_, other.storage_);
+                }
+                other.invoke_ = nullptr;
+                other.manage_ = nullptr;
+            }
+
+            /**
+             * @brief Assignement operator of the InlineFunction class
+             */
+            InlineFunction& operator=(InlineFunction other) noexcept
+            {
+                reset();
+                invoke_ = other.invoke_;
+                manage_ = other.manage_;
+                if (manage_) {
+                    manage_(Operation::MOVE, storage_, other.storage_);
+                }
+                other.invoke_ = nullptr;
+                other.manage_ = nullptr;
+                return *this;
+            }
+
+            /**
+             * @brief Destroy the InlineFunction object
+             */
+            ~InlineFunction()
+            {
+                reset();
+            }
+
+            /**
+             * @brief Call the stored callable
+             *
+             * @param args The arguments to forward to the callable
+             * @return R The result of the callable
+             */
+            R operator()(Args... args) const
+            {
+                return invoke_(const_cast<unsigned char *>(storage_), std::forward<Args>(args)...);
+            }
+
+            /**
+             * @brief Check if a callable is stored
+             *
+             * @return true if a callable is stored, false otherwise
+             */
+            explicit operator bool() const
+            {
+                return invoke_ != nullptr;
+            }
+
+            /**
+             * @brief Destroy the stored callable, if any
+             */
+            void reset()
+            {
+                if (manage_) {
+                    manage_(Operation::DESTROY, storage_, nullptr);
+                }
+                invoke_ = nullptr;
+                manage_ = nullptr;
+            }
+
+        private:
+            /**
+             * @enum Operation
+             * @brief The operations the manager of a stored callable can perform
+             */
+            enum class Operation {
+                COPY,
+                MOVE,
+                DESTROY
+            };
+
+            alignas(std::max_align_t) unsigned char storage_[Size]; /*!> The inline storage of the callable */
+            R (*invoke_)(void *, Args...) = nullptr;                /*!> The trampoline calling the stored callable */
+            void (*manage_)(Operation, void *, void *) = nullptr;   /*!> The trampoline copying, moving or destroying the stored callable */
+    };
+}
@@ -0,0 +1,130 @@
+
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <memory>
+
+namespace glnet::utils
+{
+    /**
+     * @brief Size of a cache line, used to keep the producer and consumer indexes apart
+     */
+    constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    template <typename T, std::size_t Capacity = 4096>
+    class Ring
+    {
+            static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Ring capacity must be a power of two");
+
+        public:
+            /**
+             * @brief Construct a new Ring object
+             */
+            Ring() : cells_(std::make_unique<Cell[]>(Capacity)), head_(0), tail_(0)
+            {
+                for (std::size_t i = 0; i < Capacity; i++) {
+                    cells_[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            /**
+             * @brief Delete the copy constructor of the Ring class
+             */
+            Ring(const Ring&) = delete;
+
+            /**
+             * @brief Delete the assignement operator of the Ring class
+             */
+            Ring& operator=(const Ring&) = delete;
+
+            /**
+             * @brief Push a value in the ring (safe to call from any number of threads)
+             *
+             * @param value The value to push
+             * @return true if the value was pushed, false if the ring is full
+             */
+            bool push(T&& value)
+            {
+                std::size_t position = tail_.load(std::memory_order_relaxed);
+                Cell *cell = nullptr;
+
+                while (true) {
+                    cell = &cells_[position & (Capacity - 1)];
+                    std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                    std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+                    if (diff == 0) {
+                        if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                            break;
+                        }
+                    } else if (diff < 0) {
+                        return false;
+                    } else {
+                        position = tail_.load(std::memory_order_relaxed);
+                    }
+                }
+                cell->value = std::move(value);
+                cell->sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+
+            /**
+             * @brief Pop a value from the ring (must only be called by the consuming thread)
+             *
+             * @param value The value to fill
+             * @return true if a value was popped, false if the ring is empty
+             */
+            bool pop(T& value)
+            {
+                std::size_t position = head_.load(std::memory_order_relaxed);
+                Cell *cell = &cells_[position & (Capacity - 1)];
+                std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+
+                if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1) < 0) {
+                    return false;
+                }
+                value = std::move(cell->value);
+                cell->sequence.store(position + Capacity, std::memory_order_release);
+                head_.store(position + 1, std::memory_order_relaxed);
+                return true;
+            }
+
+            /**
+             * @brief Check if the ring is empty
+             *
+             * @return true if there is nothing to pop, false otherwise
+             */
+            bool empty() const
+            {
+                return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+            }
+
+            /**
+             * @brief Get the approximate number of values waiting in the ring
+             *
+             * @return std::size_t The number of values
+             */
+            std::size_t size() const
+            {
+                std::size_t tail = tail_.load(std::memory_order_acquire);
+                std::size_t head = head_.load(std::memory_order_acquire);
+
+                return tail > head ? tail - head : 0;
+            }
+
+        private:
+            /**
+             * @struct Cell
+             * @brief A slot of the ring with its sequence number
+             */
+            struct Cell {
+                    std::atomic<std::size_t> sequence; /*!> The sequence number of the slot */
+                    T value;                           /*!> The value stored in the slot */
+            };
+
+            std::unique_ptr<Cell[]> cells_;                          /*!> The slots of the ring */
+            alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_; /*!> The next position to pop (consumer side) */
+            alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_; /*!> The next position to push (producer side) */
+    };
+}
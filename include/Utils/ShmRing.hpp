@@ -0,0 +1,113 @@
+
+#pragma once
+
+#include "Utils/Ring.hpp"
+
+#include <cstdint>
+#include <atomic>
+
+namespace glnet::utils
+{
+    class ShmRing
+    {
+        public:
+            /**
+             * @struct Control
+             * @brief The positions of the ring, at the start of its shared memory, each one on its own cache line
+             */
+            struct Control {
+                    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> head;     /*!> The number of bytes written by the producer */
+                    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> tail;     /*!> The number of bytes read by the consumer */
+                    alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> sleeping; /*!> If the consumer waits for a doorbell before reading again */
+            };
+
+            static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "The shared ring needs lock-free 64 bits atomics");
+
+            static constexpr std::size_t RECORD_ALIGNMENT = 8; /*!> The alignment of every record in the ring */
+            static constexpr std::uint32_t WRAP = 0xffffffff;  /*!> The length marking the end of the ring, the next record being at its start */
+
+            /**
+             * @brief Construct a new ShmRing object, detached
+             */
+            ShmRing();
+
+            /**
+             * @brief Get the size of the shared memory of a ring
+             *
+             * @param capacity The size of the data of the ring
+             * @return std::size_t The size of the control block and of the data, rounded up to a cache line so that rings can follow each other
+             */
+            static std::size_t getFootprint(std::size_t capacity);
+
+            /**
+             * @brief Use a shared memory block as the ring
+             *
+             * @param base The start of the block, aligned on a cache line and getFootprint(capacity) bytes long
+             * @param capacity The size of the data of the ring, a power of two
+             * @param reset Whether to initialize the positions (by the side creating the block)
+             */
+            void attach(void *base, std::size_t capacity, bool reset);
+
+            /**
+             * @brief Get the size of the largest frame the ring takes, half of its capacity so that a frame always fits once the ring drains
+             *
+             * @return std::size_t The size in bytes
+             */
+            std::size_t getMaxFrameSize() const;
+
+            /**
+             * @brief Get the number of bytes written and not read yet
+             *
+             * @return std::size_t The number of bytes
+             */
+            std::size_t getUsed() const;
+
+            /**
+             * @brief Copy a frame into the ring and publish it (producer side, a single producer at a time)
+             *
+             * @param frame The frame, starting with its 32 bits length
+             * @param size The size of the frame, length included
+             * @return true if the frame was written, false if the ring is full or the frame too large
+             */
+            bool push(const std::uint8_t *frame, std::size_t size);
+
+            /**
+             * @brief Check if the consumer went to sleep and take its doorbell (producer side, after push)
+             *
+             * @return true if the producer must ring the doorbell, false if the consumer is awake or another producer rings it
+             */
+            bool needsWakeup();
+
+            /**
+             * @brief Get the oldest frame of the ring without removing it (consumer side)
+             *
+             * @param size Set to the size of the frame, length included
+             * @return const std::uint8_t* The frame, valid until pop, nullptr if the ring is empty
+             */
+            const std::uint8_t *front(std::size_t& size);
+
+            /**
+             * @brief Remove the frame returned by front (consumer side)
+             *
+             * @param size The size of the frame
+             */
+            void pop(std::size_t size);
+
+            /**
+             * @brief Tell the producer a doorbell is needed for the next frame, unless a frame is already there (consumer side)
+             *
+             * @return true if the ring is empty and the consumer may wait for the doorbell, false if it should read again
+             */
+            bool sleep();
+
+            /**
+             * @brief Tell the producer the consumer reads again, so it stops ringing the doorbell (consumer side)
+             */
+            void wake();
+
+        private:
+            Control *control_;     /*!> The positions of the ring */
+            std::uint8_t *data_;   /*!> The data of the ring */
+            std::size_t capacity_; /*!> The size of the data, a power of two */
+    };
+}
@@ -0,0 +1,154 @@
+
+#pragma once
+
+#include "Utils/Wakeup.hpp"
+#include "Data/Tick.hpp"
+#include "Socket.hpp"
+
+#include <unordered_map>
+#include <functional>
+#include <utility>
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+namespace glnet::utils
+{
+    class TimerQueue
+    {
+        public:
+            /**
+             * @brief Clock of the deadlines
+             */
+            using Clock = std::chrono::steady_clock;
+
+            /**
+             * @brief Identifier of a timer, never reused
+             */
+            using Id = std::uint64_t;
+
+            /**
+             * @brief Construct a new TimerQueue object, empty
+             */
+            TimerQueue();
+
+            /**
+             * @brief Add a one-shot timer
+             *
+             * @param delay The time before the callback runs
+             * @param callback The function called once
+             * @return Id The identifier of the timer
+             */
+            Id add(Clock::duration delay, std::function<void()> callback);
+
+            /**
+             * @brief Add a periodic timer, re-armed an interval after each run returns so its runs never overlap nor catch up
+             *
+             * @param interval The time between the end of a run and the start of the next one
+             * @param callback The function called on every run
+             * @return Id The identifier of the timer
+             */
+            Id addPeriodic(Clock::duration interval, std::function<void()> callback);
+
+            /**
+             * @brief Add a fixed-rate tick, due a whole number of periods after its first run whatever the duration of each run, the periods the loop fell behind on are skipped and counted as overruns
+             *
+             * @param period The time between two due times
+             * @param callback The function called on every run with its index, lateness and overruns
+             * @return Id The identifier of the timer
+             */
+            Id addTick(Clock::duration period, std::function<void(const Tick&)> callback);
+
+            /**
+             * @brief Cancel a timer, a run already started finishes but the timer is not re-armed
+             *
+             * @param id The identifier of the timer
+             * @return true if the timer was pending, false otherwise
+             */
+            bool cancel(Id id);
+
+            /**
+             * @brief Run the callbacks of the timers due, must be called by the thread polling on the file descriptor
+             */
+            void process();
+
+            /**
+             * @brief Get the time left before the next timer is due
+             *
+             * @return std::int32_t The time left in milliseconds (rounded up), -1 if no timer is pending
+             */
+            std::int32_t getTimeout() const;
+
+            /**
+             * @brief Get the file descriptor to poll on, readable when a timer is added from another thread ahead of the current deadline
+             *
+             * @return Socket::Fd The file descriptor of the wakeup
+             */
+            Socket::Fd getFd() const;
+
+        private:
+            /**
+             * @enum Kind
+             * @brief The rearming policies of the timers
+             */
+            enum class Kind {
+                ONE_SHOT, /*!> Run once */
+                PERIODIC, /*!> Re-armed an interval after each run */
+                TICK,     /*!> Re-armed a period after the due time of each run */
+            };
+
+            /**
+             * @struct Entry
+             * @brief Represent a pending timer
+             */
+            struct Entry {
+                    Kind kind;                               /*!> The rearming policy */
+                    Clock::duration period;                  /*!> The interval or period, zero for one-shot timers */
+                    Clock::time_point deadline;              /*!> The next due time */
+                    std::function<void()> callback;          /*!> The callback of one-shot and periodic timers */
+                    std::function<void(const Tick&)> onTick; /*!> The callback of fixed-rate ticks */
+                    Tick tick;                               /*!> The state of the last run of a tick */
+            };
+
+            /**
+             * @brief A due time and the timer it belongs to, outdated once the timer is cancelled or re-armed
+             */
+            using Deadline = std::pair<Clock::time_point, Id>;
+
+            /**
+             * @brief Store a timer and push its first deadline
+             *
+             * @param entry The timer
+             * @return Id The identifier of the timer
+             */
+            Id insert(std::shared_ptr<Entry> entry);
+
+            /**
+             * @brief Push the next deadline of a timer still pending, waking the poller up if it became the earliest one
+             *
+             * @param id The identifier of the timer
+             * @param deadline The next due time
+             * @return true if the timer is still pending, false if it was cancelled
+             */
+            bool rearm(Id id, Clock::time_point deadline);
+
+            /**
+             * @brief Run a fixed-rate tick, skipping the periods it is behind on
+             *
+             * @param entry The timer
+             * @param now The current time
+             * @return Clock::time_point The next due time
+             */
+            static Clock::time_point runTick(Entry& entry, Clock::time_point now);
+
+            mutable std::mutex mutex_;                                                               /*!> Guard of the timers and deadlines */
+            std::unordered_map<Id, std::shared_ptr<Entry>> entries_;                                 /*!> The pending timers */
+            std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines_; /*!> The due times, earliest first */
+            Id nextId_;                                                                              /*!> The identifier of the next timer */
+            Wakeup wakeup_;                                                                          /*!> The wakeup signaled when a timer becomes the earliest one */
+            std::vector<std::pair<Id, std::shared_ptr<Entry>>> due_;                                 /*!> The timers due in the current process call, kept to reuse its capacity */
+    };
+}
@@ -0,0 +1,103 @@
+
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+#include <array>
+#include <vector>
+
+namespace glnet::utils
+{
+    class TimingWheel
+    {
+        public:
+            /**
+             * @brief Clock used to advance the wheel
+             */
+            using Clock = std::chrono::steady_clock;
+
+            static constexpr std::size_t LEVELS = 4;                                       /*!> The number of wheels, each one covering SLOTS times the range of the previous one */
+            static constexpr std::size_t SLOT_BITS = 8;                                    /*!> The number of bits of the tick indexing a wheel */
+            static constexpr std::size_t SLOTS = 1 << SLOT_BITS;                           /*!> The number of slots of each wheel */
+            static constexpr std::uint64_t MAX_DELTA = (1ull << (SLOT_BITS * LEVELS)) - 1; /*!> The farthest tick a timer can be armed at, further deadlines are clamped */
+
+            /**
+             * @struct Timer
+             * @brief A timer node, owned by the caller and linked in a slot while armed (intrusive, so arming never allocates)
+             */
+            struct Timer {
+                    Timer *next = nullptr;    /*!> The next timer of the slot */
+                    Timer **pprev = nullptr;  /*!> The pointer to this timer in the slot (nullptr when disarmed) */
+                    std::uint64_t expiry = 0; /*!> The tick the timer expires at */
+                    std::uint32_t id = 0;     /*!> The id of the owner, free for the caller */
+                    std::uint8_t kind = 0;    /*!> The kind of timer, free for the caller */
+            };
+
+            /**
+             * @brief Construct a new TimingWheel object
+             *
+             * @param resolution The duration of a tick
+             * @param now The current time, tick 0
+             */
+            TimingWheel(Clock::duration resolution, Clock::time_point now);
+
+            /**
+             * @brief Arm a timer, disarming it first if needed, in O(1)
+             *
+             * @param timer The timer, which must stay at the same address while armed
+             * @param deadline The time the timer expires at, rounded up to the next tick
+             */
+            void schedule(Timer& timer, Clock::time_point deadline);
+
+            /**
+             * @brief Disarm a timer in O(1), nothing happens if it is not armed
+             *
+             * @param timer The timer
+             */
+            void cancel(Timer& timer);
+
+            /**
+             * @brief Check if a timer is armed
+             *
+             * @param timer The timer
+             * @return true if the timer is linked in the wheel, false otherwise
+             */
+            static bool isArmed(const Timer& timer);
+
+            /**
+             * @brief Advance the wheel up to the current time, cascading the timers of the upper wheels and collecting the expired ones (disarmed)
+             *
+             * @param now The current time
+             * @param expired The list to append the expired timers to
+             */
+            void advance(Clock::time_point now, std::vector<Timer *>& expired);
+
+            /**
+             * @brief Get the time of the next tick that expires a timer or cascades an upper wheel
+             *
+             * @return Clock::time_point The deadline, Clock::time_point::max() if no timer is armed
+             */
+            Clock::time_point getNextDeadline() const;
+
+        private:
+            /**
+             * @brief Link a timer in the slot matching its expiry
+             *
+             * @param timer The timer, disarmed
+             */
+            void link(Timer& timer);
+
+            /**
+             * @brief Move the timers of a slot of an upper wheel to the lower wheels
+             *
+             * @param level The level of the wheel
+             */
+            void cascade(std::size_t level);
+
+            Clock::duration resolution_;                             /*!> The duration of a tick */
+            Clock::time_point origin_;                               /*!> The time of tick 0 */
+            std::uint64_t current_ = 0;                              /*!> The last tick processed */
+            std::size_t size_ = 0;                                   /*!> The number of armed timers */
+            std::array<std::array<Timer *, SLOTS>, LEVELS> slots_{}; /*!> The heads of the slots, by level */
+    };
+}
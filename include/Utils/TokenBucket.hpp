@@ -0,0 +1,71 @@
+
+#pragma once
+
+#include "Data/RateLimit.hpp"
+
+#include <cstdint>
+#include <chrono>
+
+namespace glnet::utils
+{
+    class TokenBucket
+    {
+        public:
+            /**
+             * @brief Clock used to refill the bucket
+             */
+            using Clock = std::chrono::steady_clock;
+
+            /**
+             * @brief Construct a new TokenBucket object, full
+             *
+             * @param limit The rate and burst of the bucket
+             * @param now The current time
+             */
+            TokenBucket(RateLimit limit, Clock::time_point now);
+
+            /**
+             * @brief Check whether a frame can be sent now, a frame larger than the burst is allowed once the bucket is full
+             *
+             * @param size The size of the frame
+             * @param now The current time
+             * @return true if the bucket holds enough tokens, false otherwise
+             */
+            bool canConsume(std::size_t size, Clock::time_point now);
+
+            /**
+             * @brief Take the tokens of a frame, the bucket may go into debt for frames larger than the burst
+             *
+             * @param size The size of the frame
+             */
+            void consume(std::size_t size);
+
+            /**
+             * @brief Get the time left before a frame can be sent
+             *
+             * @param size The size of the frame
+             * @return Clock::duration The time left, zero if the frame can be sent now
+             */
+            Clock::duration getDelay(std::size_t size) const;
+
+            /**
+             * @brief Change the rate and burst of the bucket, keeping its tokens up to the new burst
+             *
+             * @param limit The new rate and burst
+             */
+            void setLimit(RateLimit limit);
+
+        private:
+            /**
+             * @brief Add the tokens earned since the last refill
+             *
+             * @param now The current time
+             */
+            void refill(Clock::time_point now);
+
+            double rate_;                  /*!> The number of tokens earned per second */
+            double burst_;                 /*!> The capacity of the bucket */
+            double tokens_;                /*!> The number of tokens available, negative when in debt */
+            Clock::time_point lastRefill_; /*!> The time of the last refill */
+    };
+}
@@ -0,0 +1,61 @@
+
+#pragma once
+
+#include "Socket.hpp"
+
+#include <atomic>
+#include <memory>
+
+namespace glnet::utils
+{
+    class Wakeup
+    {
+        public:
+            /**
+             * @brief Construct a new Wakeup object
+             */
+            Wakeup();
+
+            /**
+             * @brief Destroy the Wakeup object
+             */
+            ~Wakeup();
+
+            /**
+             * @brief Delete the copy constructor of the Wakeup class
+             */
+            Wakeup(const Wakeup&) = delete;
+
+            /**
+             * @brief Delete the assignement operator of the Wakeup class
+             */
+            Wakeup& operator=(const Wakeup&) = delete;
+
+            /**
+             * @brief Wake up the thread polling on the file descriptor (only one signal is sent until the next clear)
+             */
+            void notify();
+
+            /**
+             * @brief Acknowledge the pending signal, must be called by the polling thread before draining its work
+             */
+            void clear();
+
+            /**
+             * @brief Get the file descriptor to poll on
+             *
+             * @return Socket::Fd The file descriptor readable when a signal is pending
+             */
+            Socket::Fd getFd() const;
+
+        private:
+            std::atomic<bool> signaled_; /*!> If a signal is already pending on the file descriptor */
+
+#ifdef _WIN32
+            std::unique_ptr<Socket> socket_; /*!> The loopback udp socket sending datagrams to itself */
+            Socket::Address_in addr_;        /*!> The address of the loopback socket */
+#else
+            Socket::Fd fd_; /*!> The eventfd */
+#endif
+    };
+}
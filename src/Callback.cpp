@@ -13,6 +13,18 @@ void glnet::Callback::setOnConnection(std::function<void(std::uint32_t)> func)
     onConnection_ = func;
 }
 
+void glnet::Callback::onConnectionFailure(std::uint32_t clientId)
+{
+    if (onConnectionFailure_) {
+        onConnectionFailure_(clientId);
+    }
+}
+
+void glnet::Callback::setOnConnectionFailure(std::function<void(std::uint32_t)> func)
+{
+    onConnectionFailure_ = func;
+}
+
 void glnet::Callback::onDisconnection(std::uint32_t clientId)
 {
     if (onDisconnection_) {
@@ -25,8 +37,35 @@ void glnet::Callback::setOnDisconnection(std::function<void(std::uint32_t)> func
     onDisconnection_ = func;
 }
 
+void glnet::Callback::onBackpressure(std::uint32_t clientId)
+{
+    if (onBackpressure_) {
+        onBackpressure_(clientId);
+    }
+}
+
+void glnet::Callback::setOnBackpressure(std::function<void(std::uint32_t)> func)
+{
+    onBackpressure_ = func;
+}
+
+void glnet::Callback::onWritable(std::uint32_t clientId)
+{
+    if (onWritable_) {
+        onWritable_(clientId);
+    }
+}
+
+void glnet::Callback::setOnWritable(std::function<void(std::uint32_t)> func)
+{
+    onWritable_ = func;
+}
+
 void glnet::Callback::onMessageReception(connection::Type type, std::uint32_t clientId, Packet& packet)
 {
+    if (dispatch(type, clientId, packet)) {
+        return;
+    }
     if (onMessageReception_) {
         onMessageReception_(type, clientId, packet);
     }
@@ -36,3 +75,52 @@ void glnet::Callback::setOnMessageReception(std::function<void(connection::Type,
 {
     onMessageReception_ = func;
 }
+
+bool glnet::Callback::onDescriptorReception(std::uint32_t clientId, std::int32_t descriptor, Packet& packet)
+{
+    if (!onDescriptorReception_) {
+        return false;
+    }
+    onDescriptorReception_(clientId, descriptor, packet);
+    return true;
+}
+
+void glnet::Callback::setOnDescriptorReception(std::function<void(std::uint32_t, std::int32_t, Packet&)> func)
+{
+    onDescriptorReception_ = func;
+}
+
+bool glnet::Callback::dispatch(connection::Type type, std::uint32_t clientId, Packet& packet)
+{
+    std::uint64_t id = 0;
+
+    if (messageIdSize_ == 0 || packet.bytes.size() < messageIdSize_) {
+        return false;
+    }
+    switch (messageIdSize_) {
+        case 1:
+            id = packet.bytes[0];
+            break;
+        case 2: {
+            std::uint16_t value = 0;
+
+            std::memcpy(&value, packet.bytes.data(), sizeof(value));
+            id = value;
+        } break;
+        case 4: {
+            std::uint32_t value = 0;
+
+            std::memcpy(&value, packet.bytes.data(), sizeof(value));
+            id = value;
+        } break;
+        default:
+            std::memcpy(&id, packet.bytes.data(), sizeof(id));
+            break;
+    }
+    if (id >= MAX_MESSAGE_IDS || !messageHandlers_[id]) {
+        return false;
+    }
+    packet.skip(messageIdSize_);
+    messageHandlers_[id](type, clientId, packet);
+    return true;
+}
@@ -0,0 +1,342 @@
+#include "ClientPool.hpp"
+
+#include <iostream>
+#include <cstring>
+#include <format>
+
+glnet::ClientPool::ClientPool(Endpoint server) : server_(server), serverAddr_({0})
+{
+    serverAddr_.sin_family = AF_INET;
+    serverAddr_.sin_port = htons(server.port);
+    serverAddr_.sin_addr.s_addr = Socket::inetAddr(server.address);
+    receiveBuffer_.resize(Udp::MAX_RECEIVE_SIZE);
+}
+
+glnet::ClientPool::Id glnet::ClientPool::add()
+{
+    Client client;
+
+    for (std::size_t attempt = 0; !client.udp; attempt++) {
+        Socket::Address_in addr = {0};
+        Socket::AddressLength addrLen = sizeof(addr);
+
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(0);
+        client.tcp = std::make_unique<Socket>(connection::Type::TCP, Endpoint{"", 0});
+        client.tcp->bind((Socket::Address&) addr, addrLen);
+        client.tcp->getSockName((Socket::Address&) addr, addrLen);
+        // The server matches datagrams to connections by endpoint, so the udp socket must share the local port of the connection
+        try {
+            auto udp = std::make_unique<Socket>(connection::Type::UDP, Endpoint{"", 0});
+
+            udp->bind((Socket::Address&) addr, addrLen);
+            client.udp = std::move(udp);
+        } catch (const std::exception& e) {
+            if (attempt + 1 >= MAX_BIND_ATTEMPTS) {
+                throw std::runtime_error(std::format("Couldn't bind the udp socket of a client: {}", e.what()));
+            }
+        }
+    }
+    client.tcp->setBlocking(false);
+    client.udp->setBlocking(false);
+    client.tcp->tryConnect((const Socket::Address&) serverAddr_, sizeof(serverAddr_));
+    Id id = nextId_++;
+
+    clients_.emplace(id, std::move(client));
+    return id;
+}
+
+void glnet::ClientPool::remove(Id id)
+{
+    auto it = clients_.find(id);
+
+    if (it == clients_.end()) {
+        return;
+    }
+    if (it->second.connected) {
+        connected_--;
+    }
+    traffic_.queuedBytes -= it->second.outbound.size() - it->second.written;
+    clients_.erase(it);
+}
+
+bool glnet::ClientPool::isConnected(Id id) const
+{
+    auto it = clients_.find(id);
+
+    return it != clients_.end() && it->second.connected;
+}
+
+std::size_t glnet::ClientPool::size() const
+{
+    return clients_.size();
+}
+
+std::size_t glnet::ClientPool::getConnectedCount() const
+{
+    return connected_;
+}
+
+glnet::connection::SendResult glnet::ClientPool::send(Id id, connection::Type type, Packet& packet, SendOptions options)
+{
+    auto it = clients_.find(id);
+
+    if (it == clients_.end() || !it->second.connected) {
+        return connection::SendResult::FAILED;
+    }
+    Client& client = it->second;
+
+    if (type == connection::Type::TCP) {
+        std::size_t offset = client.outbound.size();
+
+        client.outbound.resize(offset + sizeof(packet.length) + packet.length);
+        std::memcpy(client.outbound.data() + offset, &packet.length, sizeof(packet.length));
+        std::memcpy(client.outbound.data() + offset + sizeof(packet.length), packet.bytes.data(), packet.length);
+        traffic_.queuedBytes += sizeof(packet.length) + packet.length;
+        traffic_.packetsOut++;
+        if (!flush(id, client)) {
+            return connection::SendResult::FAILED;
+        }
+        if (!clients_.contains(id) || client.outbound.size() - client.written <= watermarks_.high) {
+            return connection::SendResult::QUEUED;
+        }
+        if (!client.congested) {
+            client.congested = true;
+            callbacks_.onBackpressure(id);
+        }
+        return connection::SendResult::CONGESTED;
+    }
+    if (options.delivery == connection::Delivery::RELIABLE_ORDERED || sizeof(Udp::Header) + sizeof(packet.length) + packet.length > Udp::MAX_DATAGRAM_SIZE) {
+        return connection::SendResult::FAILED;
+    }
+    Udp::Header header = {.delivery = static_cast<std::uint8_t>(options.delivery), .channel = options.channel, .sequence = 0, .ack = 0, .flags = 0, .reserved = 0, .ackBits = 0};
+
+    if (options.delivery == connection::Delivery::UNRELIABLE_SEQUENCED) {
+        header.sequence = client.sequences[options.channel]++;
+    }
+    datagram_.resize(sizeof(Udp::Header) + sizeof(packet.length) + packet.length);
+    std::memcpy(datagram_.data(), &header, sizeof(header));
+    std::memcpy(datagram_.data() + sizeof(header), &packet.length, sizeof(packet.length));
+    std::memcpy(datagram_.data() + sizeof(header) + sizeof(packet.length), packet.bytes.data(), packet.length);
+    try {
+        client.udp->sendTo((Socket::Buffer) datagram_.data(), datagram_.size(), 0, (const Socket::Address&) serverAddr_, sizeof(serverAddr_));
+    } catch (const std::exception& e) {
+        return connection::SendResult::FAILED;
+    }
+    traffic_.bytesOut += datagram_.size();
+    traffic_.packetsOut++;
+    return connection::SendResult::QUEUED;
+}
+
+std::int32_t glnet::ClientPool::poll(std::int32_t timeout)
+{
+    pollFds_.clear();
+    pollOwners_.clear();
+    for (auto& [id, client] : clients_) {
+        short events = !client.connected ? POLLOUT : client.written < client.outbound.size() ? POLLIN | POLLOUT : POLLIN;
+
+        pollFds_.push_back({.fd = client.tcp->getFd(), .events = events, .revents = 0});
+        pollOwners_.emplace_back(id, connection::Type::TCP);
+        if (client.connected) {
+            pollFds_.push_back({.fd = client.udp->getFd(), .events = POLLIN, .revents = 0});
+            pollOwners_.emplace_back(id, connection::Type::UDP);
+        }
+    }
+    std::int32_t polled = Socket::poll(pollFds_, pollFds_.size(), timeout);
+
+    for (std::size_t i = 0; i < pollFds_.size() && polled > 0; i++) {
+        if (pollFds_[i].revents == 0) {
+            continue;
+        }
+        auto [id, type] = pollOwners_[i];
+        auto it = clients_.find(id);
+
+        // A callback may have removed the client earlier in this loop
+        if (it == clients_.end()) {
+            continue;
+        }
+        Client& client = it->second;
+
+        if (type == connection::Type::UDP) {
+            readDatagram(id, client);
+            continue;
+        }
+        if (!client.connected) {
+            finishConnect(id, client);
+            continue;
+        }
+        if ((pollFds_[i].revents & (POLLIN | POLLHUP | POLLERR)) && !readFrames(id, client)) {
+            disconnect(id);
+            continue;
+        }
+        // The message callbacks may have removed the client
+        if ((pollFds_[i].revents & POLLOUT) && clients_.contains(id) && !flush(id, client)) {
+            disconnect(id);
+        }
+    }
+    return polled;
+}
+
+void glnet::ClientPool::setWatermarks(Watermarks watermarks)
+{
+    watermarks_ = watermarks;
+}
+
+glnet::TrafficMetrics glnet::ClientPool::getMetrics() const
+{
+    return traffic_;
+}
+
+glnet::Callback& glnet::ClientPool::callbacks()
+{
+    return callbacks_;
+}
+
+bool glnet::ClientPool::finishConnect(Id id, Client& client)
+{
+    try {
+        std::int32_t error = client.tcp->getPendingError();
+
+        if (error != 0) {
+            throw std::runtime_error(std::format("Couldn't connect to the address: {}.", std::strerror(error)));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        clients_.erase(id);
+        callbacks_.onConnectionFailure(id);
+        return false;
+    }
+    client.connected = true;
+    connected_++;
+    callbacks_.onConnection(id);
+    return true;
+}
+
+bool glnet::ClientPool::readFrames(Id id, Client& client)
+{
+    for (std::size_t frames = 0; frames < MAX_READ_BATCH;) {
+        Packet& packet = client.inbound;
+        bool readingLength = client.received < sizeof(packet.length);
+        std::uint8_t *target = readingLength ? reinterpret_cast<std::uint8_t *>(&packet.length) + client.received : packet.bytes.data() + (client.received - sizeof(packet.length));
+        std::size_t wanted = readingLength ? sizeof(packet.length) - client.received : sizeof(packet.length) + packet.length - client.received;
+        std::optional<Socket::BytesReceived> bytesRead;
+
+        try {
+            bytesRead = client.tcp->tryRecv(target, wanted);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return false;
+        }
+        if (!bytesRead) {
+            return true;
+        }
+        if (*bytesRead <= 0) {
+            return false;
+        }
+        traffic_.bytesIn += *bytesRead;
+        if (static_cast<std::size_t>(*bytesRead) < wanted) {
+            traffic_.partialReads++;
+        }
+        client.received += *bytesRead;
+        if (readingLength && client.received == sizeof(packet.length)) {
+            packet.bytes.resize(packet.length);
+        }
+        if (client.received < sizeof(packet.length) || client.received < sizeof(packet.length) + packet.length) {
+            continue;
+        }
+        Packet complete = std::move(packet);
+
+        client.inbound = Packet();
+        client.received = 0;
+        frames++;
+        traffic_.packetsIn++;
+        // Zero-length frames are heartbeats
+        if (complete.length == 0) {
+            continue;
+        }
+        try {
+            callbacks_.onMessageReception(connection::Type::TCP, id, complete);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+        }
+        // The callback may have removed the client
+        if (!clients_.contains(id)) {
+            return true;
+        }
+    }
+    return true;
+}
+
+void glnet::ClientPool::readDatagram(Id id, Client& client)
+{
+    Socket::BytesReceived bytesRead = 0;
+    Udp::Header header = {0};
+    Packet packet;
+
+    try {
+        bytesRead = client.udp->recvFrom(receiveBuffer_.data(), receiveBuffer_.size(), 0);
+    } catch (const std::exception& e) {
+        return;
+    }
+    if (bytesRead < static_cast<Socket::BytesReceived>(sizeof(header) + sizeof(packet.length))) {
+        return;
+    }
+    traffic_.bytesIn += bytesRead;
+    traffic_.packetsIn++;
+    std::memcpy(&header, receiveBuffer_.data(), sizeof(header));
+    // Acknowledgements, fragments and reliable messages need the channel state of a Manager
+    if (header.flags & (Udp::FLAG_ACK_ONLY | Udp::FLAG_FRAGMENT) || static_cast<connection::Delivery>(header.delivery) == connection::Delivery::RELIABLE_ORDERED) {
+        return;
+    }
+    std::memcpy(&packet.length, receiveBuffer_.data() + sizeof(header), sizeof(packet.length));
+    if (packet.length != bytesRead - sizeof(header) - sizeof(packet.length)) {
+        return;
+    }
+    packet.bytes.assign(receiveBuffer_.data() + sizeof(header) + sizeof(packet.length), receiveBuffer_.data() + bytesRead);
+    try {
+        callbacks_.onMessageReception(connection::Type::UDP, id, packet);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+bool glnet::ClientPool::flush(Id id, Client& client)
+{
+    while (client.written < client.outbound.size()) {
+        std::size_t remaining = client.outbound.size() - client.written;
+        Socket::BytesSent bytesSent = 0;
+
+        try {
+            bytesSent = client.tcp->trySend((Socket::Buffer) (client.outbound.data() + client.written), remaining);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return false;
+        }
+        if (bytesSent <= 0) {
+            break;
+        }
+        if (static_cast<std::size_t>(bytesSent) < remaining) {
+            traffic_.partialWrites++;
+        }
+        client.written += bytesSent;
+        traffic_.bytesOut += bytesSent;
+        traffic_.queuedBytes -= bytesSent;
+    }
+    // Drop the written prefix once it is at least half of the buffer, so that a slow connection does not grow it forever
+    if (client.written != 0 && client.written * 2 >= client.outbound.size()) {
+        client.outbound.erase(client.outbound.begin(), client.outbound.begin() + client.written);
+        client.written = 0;
+    }
+    if (client.congested && client.outbound.size() - client.written <= watermarks_.low) {
+        client.congested = false;
+        callbacks_.onWritable(id);
+    }
+    return true;
+}
+
+void glnet::ClientPool::disconnect(Id id)
+{
+    remove(id);
+    callbacks_.onDisconnection(id);
+}
@@ -0,0 +1,163 @@
+#include "Coroutine/Connection.hpp"
+#include "Manager.hpp"
+
+#include <stdexcept>
+
+void glnet::Mailbox::push(Packet&& packet)
+{
+    std::unique_lock lock(mutex_);
+    std::coroutine_handle<> waiter = std::exchange(waiter_, {});
+
+    if (!waiter) {
+        packets_.push_back(std::move(packet));
+        return;
+    }
+    *slot_ = std::move(packet);
+    lock.unlock();
+    waiter.resume();
+}
+
+void glnet::Mailbox::close()
+{
+    std::unique_lock lock(mutex_);
+    std::coroutine_handle<> waiter = std::exchange(waiter_, {});
+
+    closed_ = true;
+    if (!waiter) {
+        return;
+    }
+    *closedSlot_ = true;
+    lock.unlock();
+    waiter.resume();
+}
+
+bool glnet::Mailbox::tryPop(Packet& packet, bool& closed)
+{
+    std::scoped_lock lock(mutex_);
+
+    if (!packets_.empty()) {
+        packet = std::move(packets_.front());
+        packets_.pop_front();
+        return true;
+    }
+    closed = closed_;
+    return closed_;
+}
+
+bool glnet::Mailbox::wait(std::coroutine_handle<> waiter, Packet *packet, bool *closed)
+{
+    std::scoped_lock lock(mutex_);
+
+    if (!packets_.empty()) {
+        *packet = std::move(packets_.front());
+        packets_.pop_front();
+        return false;
+    }
+    if (closed_) {
+        *closed = true;
+        return false;
+    }
+    waiter_ = waiter;
+    slot_ = packet;
+    closedSlot_ = closed;
+    return true;
+}
+
+glnet::Connection::ReceiveAwaiter::ReceiveAwaiter(std::shared_ptr<Mailbox> mailbox) : mailbox_(std::move(mailbox))
+{
+}
+
+bool glnet::Connection::ReceiveAwaiter::await_ready()
+{
+    return mailbox_->tryPop(packet_, closed_);
+}
+
+bool glnet::Connection::ReceiveAwaiter::await_suspend(std::coroutine_handle<> waiter)
+{
+    return mailbox_->wait(waiter, &packet_, &closed_);
+}
+
+glnet::Packet glnet::Connection::ReceiveAwaiter::await_resume()
+{
+    if (closed_) {
+        throw std::runtime_error("The connection is closed");
+    }
+    return std::move(packet_);
+}
+
+glnet::Connection::SendAwaiter::SendAwaiter(connection::SendResult result) : result_(result)
+{
+}
+
+bool glnet::Connection::SendAwaiter::await_ready() const noexcept
+{
+    return true;
+}
+
+void glnet::Connection::SendAwaiter::await_suspend(std::coroutine_handle<>) const noexcept
+{
+}
+
+glnet::connection::SendResult glnet::Connection::SendAwaiter::await_resume() const noexcept
+{
+    return result_;
+}
+
+glnet::Connection::Connection(Manager& manager, connection::Type type, std::uint32_t clientId, std::shared_ptr<Mailbox> mailbox)
+    : manager_(&manager), type_(type), clientId_(clientId), mailbox_(std::move(mailbox))
+{
+}
+
+glnet::Connection::ReceiveAwaiter glnet::Connection::receive()
+{
+    return ReceiveAwaiter(mailbox_);
+}
+
+glnet::Connection::SendAwaiter glnet::Connection::send(Packet& packet)
+{
+    return send(type_, packet);
+}
+
+glnet::Connection::SendAwaiter glnet::Connection::send(connection::Type type, Packet& packet)
+{
+    if (manager_->getSide() == connection::Side::CLIENT) {
+        return SendAwaiter(manager_->sendToServer(type, packet));
+    }
+    return SendAwaiter(manager_->sendToClients(type, {clientId_}, packet));
+}
+
+std::uint32_t glnet::Connection::getId() const
+{
+    return clientId_;
+}
+
+glnet::ConnectAwaiter::ConnectAwaiter(Manager& manager) : manager_(manager), failed_(false)
+{
+}
+
+bool glnet::ConnectAwaiter::await_ready() const noexcept
+{
+    return false;
+}
+
+bool glnet::ConnectAwaiter::await_suspend(std::coroutine_handle<> waiter)
+{
+    Manager& manager = manager_;
+
+    if (manager.side_ != connection::Side::CLIENT || !manager.tcp_) {
+        failed_ = true;
+        return false;
+    }
+    manager.connectWaiter_ = waiter;
+    manager.connectFailed_ = &failed_;
+    manager.connectToServer();
+    return true;
+}
+
+glnet::Connection glnet::ConnectAwaiter::await_resume()
+{
+    if (failed_) {
+        throw std::runtime_error("Couldn't connect to the server");
+    }
+    return manager_.attach(0);
+}
@@ -0,0 +1,47 @@
+#include "Data/Metrics.hpp"
+
+#include <string_view>
+#include <format>
+#include <array>
+#include <utility>
+
+std::string glnet::Metrics::format() const
+{
+    using Field = std::uint64_t TrafficMetrics::*;
+    static constexpr std::array<std::pair<const char *, Field>, 7> TRAFFIC = {{
+        {"glnet_bytes_in_total", &TrafficMetrics::bytesIn},
+        {"glnet_bytes_out_total", &TrafficMetrics::bytesOut},
+        {"glnet_packets_in_total", &TrafficMetrics::packetsIn},
+        {"glnet_packets_out_total", &TrafficMetrics::packetsOut},
+        {"glnet_partial_reads_total", &TrafficMetrics::partialReads},
+        {"glnet_partial_writes_total", &TrafficMetrics::partialWrites},
+        {"glnet_queued_bytes", &TrafficMetrics::queuedBytes},
+    }};
+    const std::array<std::pair<std::string, const TransportMetrics *>, 5> transports = {{{"tcp", &tcp}, {"udp", &udp}, {"local", &local}, {"shm", &shm}, {"loopback", &loopback}}};
+    std::string text;
+
+    for (const auto& [name, field] : TRAFFIC) {
+        text += std::format("# TYPE {} {}\n", name, std::string_view(name).ends_with("_total") ? "counter" : "gauge");
+        for (const auto& [transport, metrics] : transports) {
+            text += std::format("{}{} {}\n", name, "{transport=\"" + transport + "\"}", metrics->total.*field);
+            for (const auto& [clientId, traffic] : metrics->connections) {
+                text += std::format("{}{} {}\n", name, "{transport=\"" + transport + "\",client=\"" + std::to_string(clientId) + "\"}", traffic.*field);
+            }
+        }
+    }
+    auto writeTotal = [&](const char *name, const char *type, auto value) {
+        text += std::format("# TYPE {} {}\n", name, type);
+        for (const auto& [transport, metrics] : transports) {
+            text += std::format("{}{} {}\n", name, "{transport=\"" + transport + "\"}", value(*metrics));
+        }
+    };
+
+    writeTotal("glnet_frames_dropped_total", "counter", [](const TransportMetrics& metrics) { return metrics.framesDropped; });
+    writeTotal("glnet_queued_frames", "gauge", [](const TransportMetrics& metrics) { return metrics.queuedFrames; });
+    writeTotal("glnet_connections_accepted_total", "counter", [](const TransportMetrics& metrics) { return metrics.accepted; });
+    writeTotal("glnet_connections_rejected_total", "counter", [](const TransportMetrics& metrics) { return metrics.rejected; });
+    writeTotal("glnet_connections", "gauge", [](const TransportMetrics& metrics) { return metrics.connections.size(); });
+    writeTotal("glnet_callbacks_total", "counter", [](const TransportMetrics& metrics) { return metrics.callbacks; });
+    writeTotal("glnet_callback_seconds_total", "counter", [](const TransportMetrics& metrics) { return std::chrono::duration<double>(metrics.callbackTime).count(); });
+    return text;
+}
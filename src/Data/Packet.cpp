@@ -37,6 +37,24 @@ glnet::Packet& glnet::Packet::operator>>(std::string& data)
     return *this;
 }
 
+glnet::Packet& glnet::Packet::skip(std::size_t size)
+{
+    if (bytes.size() < readOffset_ + size) {
+        throw std::runtime_error("Insufficient data to skip");
+    }
+    readOffset_ += size;
+    return *this;
+}
+
+std::vector<std::uint8_t> glnet::Packet::serialize() const
+{
+    std::vector<std::uint8_t> frame(sizeof(length) + length);
+
+    std::memcpy(frame.data(), &length, sizeof(length));
+    std::memcpy(frame.data() + sizeof(length), bytes.data(), length);
+    return frame;
+}
+
 std::ostream& operator<<(std::ostream& out, const glnet::Packet& packet)
 {
     out << "There are " << packet.bytes.size() << " bytes in the given packet." << '\n';
@@ -3,19 +3,37 @@
 #include "Utils/Threads.hpp"
 
 #include <type_traits>
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <fstream>
+#include <format>
+#include <mutex>
 
-glnet::Manager::Manager() : running_(true)
+glnet::Manager::Manager() : running_(true), mode_(Mode::THREADED), tcpActive_(false), localActive_(false), localMode_(connection::LocalMode::STREAM), shmActive_(false), loopbackActive_(false)
 {
     Socket::startup();
 }
 
 glnet::Manager::~Manager()
 {
-    running_ = false;
+    stop();
     if (tcp_) {
         tcp_->stop();
     }
     utils::Threads::join(tcpThread_);
+    if (local_) {
+        local_->stop();
+    }
+    utils::Threads::join(localThread_);
+    if (shm_) {
+        shm_->stop();
+    }
+    utils::Threads::join(shmThread_);
+    if (loopback_) {
+        loopback_->stop();
+    }
+    utils::Threads::join(loopbackThread_);
     if (udp_) {
         udp_->stop();
     }
@@ -24,35 +42,185 @@ glnet::Manager::~Manager()
     Socket::cleanup();
 }
 
-void glnet::Manager::initialize(connection::Side side)
+void glnet::Manager::initialize(connection::Side side, Mode mode)
 {
     if (side == connection::Side::CLIENT) {
         client_.clientPort = getAvailablePort();
     }
     side_ = side;
-    mainThread_ = std::thread(&Manager::run, this);
+    mode_ = mode;
+    if (mode_ == Mode::THREADED) {
+        mainThread_ = std::thread(&Manager::run, this);
+    }
 }
 
 void glnet::Manager::stop()
 {
     running_ = false;
+    disconnectionWakeup_.notify();
 }
 
-void glnet::Manager::run()
+std::int32_t glnet::Manager::poll(std::int32_t timeout)
 {
-    while (running_) {
-        while (!disconnectionQueue_.empty()) {
-            if (side_ == connection::Side::SERVER) {
-                std::uint32_t id = disconnectionQueue_.front();
+    if (mode_ != Mode::POLLED) {
+        throw std::runtime_error("The Manager must be initialized in polled mode to be polled");
+    }
+    std::size_t tcpCount = tcp_ && tcpActive_ ? tcp_->getPollFds().size() : 0;
+    std::size_t localCount = local_ && localActive_ ? local_->getPollFds().size() : 0;
+    std::size_t shmCount = shm_ && shmActive_ ? shm_->getPollFds().size() : 0;
+    std::size_t loopbackCount = loopback_ && loopbackActive_ ? loopback_->getPollFds().size() : 0;
+    std::int32_t timerTimeout = timers_.getTimeout();
+    std::int32_t polled = 0;
 
-                if (server_.clients.find(id) == server_.clients.end()) {
-                    return;
-                }
-                callbacks_.onDisconnection(id);
-                server_.clients.erase(id);
+    pollFds_.clear();
+    if (timerTimeout != -1 && (timeout == -1 || timerTimeout < timeout)) {
+        timeout = timerTimeout;
+    }
+    if (tcpCount != 0) {
+        pollFds_.insert(pollFds_.end(), tcp_->getPollFds().begin(), tcp_->getPollFds().end());
+        std::int32_t tcpTimeout = tcp_->getTimeout();
+
+        if (tcpTimeout != -1 && (timeout == -1 || tcpTimeout < timeout)) {
+            timeout = tcpTimeout;
+        }
+    }
+    if (localCount != 0) {
+        pollFds_.insert(pollFds_.end(), local_->getPollFds().begin(), local_->getPollFds().end());
+        std::int32_t localTimeout = local_->getTimeout();
+
+        if (localTimeout != -1 && (timeout == -1 || localTimeout < timeout)) {
+            timeout = localTimeout;
+        }
+    }
+    if (shmCount != 0) {
+        pollFds_.insert(pollFds_.end(), shm_->getPollFds().begin(), shm_->getPollFds().end());
+        std::int32_t shmTimeout = shm_->getTimeout();
+
+        if (shmTimeout != -1 && (timeout == -1 || shmTimeout < timeout)) {
+            timeout = shmTimeout;
+        }
+    }
+    if (loopbackCount != 0) {
+        pollFds_.insert(pollFds_.end(), loopback_->getPollFds().begin(), loopback_->getPollFds().end());
+    }
+    if (udp_) {
+        pollFds_.insert(pollFds_.end(), udp_->getPollFds().begin(), udp_->getPollFds().end());
+        std::int32_t udpTimeout = udp_->getTimeout();
+
+        if (udpTimeout != -1 && (timeout == -1 || udpTimeout < timeout)) {
+            timeout = udpTimeout;
+        }
+    }
+    pollFds_.push_back({.fd = timers_.getFd(), .events = POLLIN, .revents = 0});
+    try {
+        polled = Socket::poll(pollFds_, pollFds_.size(), timeout);
+        if (tcpCount != 0) {
+            std::vector<Socket::PollFd>& fds = tcp_->getPollFds();
+
+            for (std::size_t i = 0; i < tcpCount; i++) {
+                fds[i].revents = pollFds_[i].revents;
+            }
+            tcp_->process();
+        }
+        if (localCount != 0) {
+            std::vector<Socket::PollFd>& fds = local_->getPollFds();
+
+            for (std::size_t i = 0; i < localCount; i++) {
+                fds[i].revents = pollFds_[tcpCount + i].revents;
+            }
+            local_->process();
+        }
+        if (shmCount != 0) {
+            std::vector<Socket::PollFd>& fds = shm_->getPollFds();
+
+            for (std::size_t i = 0; i < shmCount; i++) {
+                fds[i].revents = pollFds_[tcpCount + localCount + i].revents;
             }
-            disconnectionQueue_.pop();
+            shm_->process();
+        }
+        if (loopbackCount != 0) {
+            std::vector<Socket::PollFd>& fds = loopback_->getPollFds();
+
+            for (std::size_t i = 0; i < loopbackCount; i++) {
+                fds[i].revents = pollFds_[tcpCount + localCount + shmCount + i].revents;
+            }
+            loopback_->process();
+        }
+        if (udp_) {
+            std::vector<Socket::PollFd>& fds = udp_->getPollFds();
+
+            for (std::size_t i = 0; i < fds.size(); i++) {
+                fds[i].revents = pollFds_[tcpCount + localCount + shmCount + loopbackCount + i].revents;
+            }
+            udp_->process();
+        }
+        processDisconnections();
+        timers_.process();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+    return polled;
+}
+
+std::int32_t glnet::Manager::pollUntil(std::chrono::steady_clock::time_point deadline)
+{
+    std::int32_t polled = 0;
+
+    do {
+        std::chrono::milliseconds remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+
+        polled += poll(static_cast<std::int32_t>(std::max<std::int64_t>(remaining.count(), 0)));
+    } while (std::chrono::steady_clock::now() < deadline);
+    return polled;
+}
+
+void glnet::Manager::run()
+{
+    std::vector<Socket::PollFd> pollFds = {{.fd = disconnectionWakeup_.getFd(), .events = POLLIN, .revents = 0}, {.fd = timers_.getFd(), .events = POLLIN, .revents = 0}};
+
+    try {
+        while (running_) {
+            Socket::poll(pollFds, pollFds.size(), timers_.getTimeout());
+            processDisconnections();
+            timers_.process();
         }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+glnet::Manager::TimerId glnet::Manager::addTimer(std::chrono::nanoseconds delay, std::function<void()> callback)
+{
+    return timers_.add(delay, std::move(callback));
+}
+
+glnet::Manager::TimerId glnet::Manager::addPeriodicTimer(std::chrono::nanoseconds interval, std::function<void()> callback)
+{
+    return timers_.addPeriodic(interval, std::move(callback));
+}
+
+glnet::Manager::TimerId glnet::Manager::addTick(std::chrono::nanoseconds period, std::function<void(const Tick&)> callback)
+{
+    return timers_.addTick(period, std::move(callback));
+}
+
+bool glnet::Manager::cancelTimer(TimerId id)
+{
+    return timers_.cancel(id);
+}
+
+void glnet::Manager::processDisconnections()
+{
+    std::uint32_t id = 0;
+
+    disconnectionWakeup_.clear();
+    while (disconnectionQueue_.pop(id)) {
+        if (side_ != connection::Side::SERVER || !hasClient(id)) {
+            continue;
+        }
+        callbacks_.onDisconnection(id);
+        std::unique_lock lock(clientsMutex_);
+        server_.clients.erase(id);
     }
 }
 
@@ -63,102 +231,536 @@ void glnet::Manager::createConnection(connection::Type type, Endpoint endpoint)
     }
     switch (type) {
         case connection::Type::TCP:
-            tcp_ = std::make_shared<Tcp>(endpoint, side_);
-            if (side_ == connection::Side::SERVER) {
+            tcp_ = std::make_shared<Tcp>(*this, endpoint, side_);
+            tcpActive_ = side_ == connection::Side::SERVER;
+            if (tcpActive_ && mode_ == Mode::THREADED) {
                 tcpThread_ = std::thread(&Tcp::run, tcp_);
             }
             break;
         case connection::Type::UDP:
-            udp_ = std::make_shared<Udp>(endpoint, side_);
-            udpThread_ = std::thread(&Udp::run, udp_);
+            udp_ = std::make_shared<Udp>(*this, endpoint, side_);
+            if (mode_ == Mode::THREADED) {
+                udpThread_ = std::thread(&Udp::run, udp_);
+            }
+            break;
+        case connection::Type::LOCAL:
+            local_ = std::make_shared<Tcp>(*this, endpoint, side_, connection::Type::LOCAL, localMode_);
+            localActive_ = side_ == connection::Side::SERVER;
+            if (localActive_ && mode_ == Mode::THREADED) {
+                localThread_ = std::thread(&Tcp::run, local_);
+            }
+            break;
+        case connection::Type::SHM:
+            shm_ = std::make_shared<Shm>(*this, endpoint, side_, shmOptions_);
+            shmActive_ = side_ == connection::Side::SERVER;
+            if (shmActive_ && mode_ == Mode::THREADED) {
+                shmThread_ = std::thread(&Shm::run, shm_);
+            }
+            break;
+        case connection::Type::LOOPBACK:
+            loopback_ = std::make_shared<Loopback>(*this, side_);
+            loopback_->listen(endpoint.address);
+            loopbackActive_ = side_ == connection::Side::SERVER;
+            if (loopbackActive_ && mode_ == Mode::THREADED) {
+                loopbackThread_ = std::thread(&Loopback::run, loopback_);
+            }
             break;
         default:
             break;
     }
 }
 
+void glnet::Manager::setLocalMode(connection::LocalMode mode)
+{
+    localMode_ = mode;
+}
+
+void glnet::Manager::setShmOptions(ShmOptions options)
+{
+    shmOptions_ = options;
+}
+
 void glnet::Manager::connectToServer()
 {
     if (side_ == connection::Side::CLIENT && tcp_) {
         tcp_->connectToServer(client_.server.address, client_.server.port);
-        tcpThread_ = std::thread(&Tcp::run, tcp_);
+        tcpActive_ = true;
+        if (mode_ == Mode::THREADED) {
+            tcpThread_ = std::thread(&Tcp::run, tcp_);
+        }
+    }
+    if (side_ == connection::Side::CLIENT && local_) {
+        local_->connectToServer(client_.server.address, client_.server.port);
+        localActive_ = true;
+        if (mode_ == Mode::THREADED) {
+            localThread_ = std::thread(&Tcp::run, local_);
+        }
+    }
+    if (side_ == connection::Side::CLIENT && shm_) {
+        shm_->connectToServer(client_.server.address);
+        shmActive_ = true;
+        if (mode_ == Mode::THREADED) {
+            shmThread_ = std::thread(&Shm::run, shm_);
+        }
+    }
+    if (side_ == connection::Side::CLIENT && loopback_) {
+        loopbackActive_ = true;
+        if (mode_ == Mode::THREADED) {
+            loopbackThread_ = std::thread(&Loopback::run, loopback_);
+        }
+        loopback_->connectToServer(client_.server.address);
+    }
+}
+
+glnet::ConnectAwaiter glnet::Manager::connect(Endpoint endpoint)
+{
+    setServerEndpoint(std::move(endpoint));
+    return ConnectAwaiter(*this);
+}
+
+glnet::Connection glnet::Manager::attach(std::uint32_t clientId, connection::Type type)
+{
+    std::scoped_lock lock(mailboxesMutex_);
+    std::shared_ptr<Mailbox>& mailbox = mailboxes_[clientId];
+
+    if (!mailbox) {
+        mailbox = std::make_shared<Mailbox>();
     }
+    return Connection(*this, type, clientId, mailbox);
 }
 
-void glnet::Manager::sendToServer(connection::Type type, Packet& packet)
+glnet::connection::SendResult glnet::Manager::sendToServer(connection::Type type, Packet& packet, SendOptions options)
 {
     if (side_ != connection::Side::CLIENT) {
-        return;
+        return connection::SendResult::FAILED;
+    }
+    return enqueue(type, makeOutbound(packet, options));
+}
+
+glnet::connection::SendResult glnet::Manager::sendToClients(connection::Type type, std::vector<std::uint32_t> ids, Packet& packet, SendOptions options)
+{
+    if (side_ != connection::Side::SERVER || ids.empty()) {
+        return connection::SendResult::FAILED;
+    }
+    Outbound outbound = makeOutbound(packet, options);
+    connection::SendResult result = connection::SendResult::QUEUED;
+
+    for (std::uint32_t id : ids) {
+        outbound.clientId = id;
+        result = std::max(result, enqueue(type, outbound));
+    }
+    return result;
+}
+
+glnet::connection::SendResult glnet::Manager::sendDescriptor(std::uint32_t clientId, Socket::Fd fd, Packet& packet, SendOptions options)
+{
+    if (!local_) {
+        return connection::SendResult::FAILED;
+    }
+    Outbound outbound = makeOutbound(packet, options);
+
+    outbound.clientId = clientId;
+    outbound.descriptor = std::make_shared<Socket>(Socket::duplicate(fd), true);
+    return enqueue(connection::Type::LOCAL, std::move(outbound));
+}
+
+bool glnet::Manager::adoptClient(connection::Type type, Socket::Fd fd)
+{
+    if (type == connection::Type::TCP && tcp_) {
+        return tcp_->adopt(fd);
+    }
+    if (type == connection::Type::LOCAL && local_) {
+        return local_->adopt(fd);
+    }
+    throw std::runtime_error("The tcp or local connection must be created before adopting a client");
+}
+
+glnet::connection::SendResult glnet::Manager::enqueue(connection::Type type, Outbound outbound)
+{
+    if (capture_.isOpen()) {
+        // The frame is recorded without its length header, like the received packets
+        capture_.record(utils::Capture::Direction::OUT, type, outbound.clientId, outbound.frame->data() + sizeof(Packet::length), outbound.frame->size() - sizeof(Packet::length));
     }
     switch (type) {
         case connection::Type::TCP:
-            tcp_->sendToSocket(*client_.socket, packet);
-            break;
+            return tcp_ ? tcp_->enqueue(std::move(outbound)) : connection::SendResult::FAILED;
         case connection::Type::UDP:
-            udp_->sendToEndpoint(client_.server, packet);
-            break;
+            return udp_ && udp_->enqueue(std::move(outbound)) ? connection::SendResult::QUEUED : connection::SendResult::FAILED;
+        case connection::Type::LOCAL:
+            return local_ ? local_->enqueue(std::move(outbound)) : connection::SendResult::FAILED;
+        case connection::Type::SHM:
+            return shm_ ? shm_->enqueue(std::move(outbound)) : connection::SendResult::FAILED;
+        case connection::Type::LOOPBACK:
+            return loopback_ ? loopback_->enqueue(std::move(outbound)) : connection::SendResult::FAILED;
         default:
             break;
     }
+    return connection::SendResult::FAILED;
 }
 
-void glnet::Manager::sendToClients(connection::Type type, std::vector<std::uint32_t> ids, Packet& packet)
+glnet::Outbound glnet::Manager::makeOutbound(Packet& packet, const SendOptions& options)
 {
-    if (side_ != connection::Side::SERVER || ids.empty()) {
-        return;
+    Outbound outbound = {.clientId = 0, .frame = std::make_shared<const std::vector<std::uint8_t>>(packet.serialize()), .delivery = options.delivery, .channel = options.channel, .priority = options.priority};
+
+    if (options.lifetime.count() != 0) {
+        outbound.deadline = std::chrono::steady_clock::now() + options.lifetime;
     }
-    for (std::uint32_t id : ids) {
-        if (server_.clients.find(id) == server_.clients.end()) {
-            return;
+    return outbound;
+}
+
+glnet::RateLimiter& glnet::Manager::getRateLimiter(connection::Type type)
+{
+    if (type == connection::Type::TCP && tcp_) {
+        return tcp_->getRateLimiter();
+    }
+    if (type == connection::Type::UDP && udp_) {
+        return udp_->getRateLimiter();
+    }
+    if (type == connection::Type::LOCAL && local_) {
+        return local_->getRateLimiter();
+    }
+    throw std::runtime_error("The connection must be created before setting its rate limits");
+}
+
+void glnet::Manager::setRateLimit(connection::Type type, std::uint32_t clientId, RateLimit limit)
+{
+    getRateLimiter(type).setClientLimit(clientId, limit);
+}
+
+void glnet::Manager::setDefaultRateLimit(connection::Type type, RateLimit limit)
+{
+    getRateLimiter(type).setDefaultClientLimit(limit);
+}
+
+void glnet::Manager::setGlobalRateLimit(connection::Type type, RateLimit limit)
+{
+    getRateLimiter(type).setGlobalLimit(limit);
+}
+
+void glnet::Manager::setOverflowPolicy(connection::Type type, connection::Overflow overflow)
+{
+    getRateLimiter(type).setOverflow(overflow);
+}
+
+glnet::RateLimiter::Counters glnet::Manager::getRateLimitCounters(connection::Type type)
+{
+    return getRateLimiter(type).getCounters();
+}
+
+void glnet::Manager::setWatermarks(Watermarks watermarks)
+{
+    if (!tcp_ && !local_) {
+        throw std::runtime_error("The tcp or local connection must be created before setting its watermarks");
+    }
+    for (const std::shared_ptr<Tcp>& stream : {tcp_, local_}) {
+        if (stream) {
+            stream->setWatermarks(watermarks);
         }
-        switch (type) {
-            case connection::Type::TCP:
-                tcp_->sendToSocket(*server_.clients[id], packet);
-                break;
-            case connection::Type::UDP:
-                if (!server_.clients[id]) {
-                    return;
-                }
-                udp_->sendToEndpoint(server_.clients[id]->getEndpoint(), packet);
-                break;
-            default:
-                break;
+    }
+}
+
+void glnet::Manager::setConnectionLimits(ConnectionLimits limits)
+{
+    if (!tcp_ && !local_) {
+        throw std::runtime_error("The tcp or local connection must be created before setting its connection limits");
+    }
+    for (const std::shared_ptr<Tcp>& stream : {tcp_, local_}) {
+        if (stream) {
+            stream->setConnectionLimits(limits);
         }
     }
 }
 
+std::uint64_t glnet::Manager::getRejectedConnections()
+{
+    if (!tcp_ && !local_) {
+        throw std::runtime_error("The tcp or local connection must be created before reading its rejected connections");
+    }
+    return (tcp_ ? tcp_->getRejectedCount() : 0) + (local_ ? local_->getRejectedCount() : 0);
+}
+
+void glnet::Manager::setTimeouts(Timeouts timeouts)
+{
+    if (!tcp_ && !local_) {
+        throw std::runtime_error("The tcp or local connection must be created before setting its timeouts");
+    }
+    for (const std::shared_ptr<Tcp>& stream : {tcp_, local_}) {
+        if (stream) {
+            stream->setTimeouts(timeouts);
+        }
+    }
+}
+
+void glnet::Manager::setAdaptiveRate(bool enable)
+{
+    if (!udp_) {
+        throw std::runtime_error("The udp connection must be created before enabling its adaptive rate");
+    }
+    udp_->setAdaptiveRate(enable);
+}
+
+std::optional<glnet::PathStats> glnet::Manager::getPathStats(std::uint32_t clientId)
+{
+    if (!udp_) {
+        throw std::runtime_error("The udp connection must be created before reading its path statistics");
+    }
+    return udp_->getPathStats(clientId);
+}
+
+glnet::Metrics glnet::Manager::getMetrics()
+{
+    Metrics metrics;
+
+    metrics.time = std::chrono::system_clock::now();
+    if (tcp_) {
+        metrics.tcp = tcp_->getMetrics();
+    }
+    if (udp_) {
+        metrics.udp = udp_->getMetrics();
+    }
+    if (local_) {
+        metrics.local = local_->getMetrics();
+    }
+    if (shm_) {
+        metrics.shm = shm_->getMetrics();
+    }
+    if (loopback_) {
+        metrics.loopback = loopback_->getMetrics();
+    }
+    return metrics;
+}
+
+void glnet::Manager::setLatencyTracing(connection::Type type, bool enable)
+{
+    if (type == connection::Type::TCP && tcp_) {
+        tcp_->setTracing(enable);
+    } else if (type == connection::Type::UDP && udp_) {
+        udp_->setTracing(enable);
+    } else if (type == connection::Type::LOCAL && local_) {
+        local_->setTracing(enable);
+    } else {
+        throw std::runtime_error("The connection must be created before tracing its latency");
+    }
+}
+
+glnet::Latency glnet::Manager::getLatency(connection::Type type)
+{
+    if (type == connection::Type::TCP && tcp_) {
+        return tcp_->getLatency();
+    }
+    if (type == connection::Type::UDP && udp_) {
+        return udp_->getLatency();
+    }
+    if (type == connection::Type::LOCAL && local_) {
+        return local_->getLatency();
+    }
+    throw std::runtime_error("The connection must be created before reading its latency");
+}
+
+void glnet::Manager::startCapture(const std::string& path, std::size_t capacity)
+{
+    capture_.open(path, capacity);
+}
+
+void glnet::Manager::stopCapture()
+{
+    capture_.close();
+}
+
+std::uint64_t glnet::Manager::getCaptureDropped() const
+{
+    return capture_.getDropped();
+}
+
+void glnet::Manager::writeMetrics(const std::string& path)
+{
+    std::string temporary = path + ".tmp";
+    std::ofstream file(temporary, std::ios::trunc);
+    std::error_code error;
+
+    file << getMetrics().format();
+    file.close();
+    if (!file) {
+        throw std::runtime_error(std::format("Couldn't write the metrics to {}", temporary));
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        throw std::runtime_error(std::format("Couldn't replace the metrics file {}: {}", path, error.message()));
+    }
+}
+
+glnet::Impairer& glnet::Manager::getImpairer(connection::Type type)
+{
+    if (type == connection::Type::TCP && tcp_) {
+        return tcp_->getImpairer();
+    }
+    if (type == connection::Type::UDP && udp_) {
+        return udp_->getImpairer();
+    }
+    if (type == connection::Type::LOCAL && local_) {
+        return local_->getImpairer();
+    }
+    throw std::runtime_error("The connection must be created before setting its impairment");
+}
+
+void glnet::Manager::setImpairment(connection::Type type, connection::Direction direction, std::uint32_t clientId, Impairment impairment)
+{
+    getImpairer(type).setClientImpairment(direction, clientId, impairment);
+}
+
+void glnet::Manager::setDefaultImpairment(connection::Type type, connection::Direction direction, Impairment impairment)
+{
+    getImpairer(type).setDefaultImpairment(direction, impairment);
+}
+
+void glnet::Manager::clearImpairments(connection::Type type)
+{
+    getImpairer(type).clear();
+}
+
+glnet::Impairer::Counters glnet::Manager::getImpairmentCounters(connection::Type type)
+{
+    return getImpairer(type).getCounters();
+}
 
-void glnet::Manager::callbackHandler(Callback::Type callback, Socket& socket)
+void glnet::Manager::setSimulatedLoss(double probability)
+{
+    Impairer& impairer = getImpairer(connection::Type::UDP);
+    Impairment impairment = impairer.getDefaultImpairment(connection::Direction::OUTBOUND);
+
+    impairment.loss = probability;
+    impairer.setDefaultImpairment(connection::Direction::OUTBOUND, impairment);
+}
+
+void glnet::Manager::callbackHandler(Callback::Type callback, Socket& socket, connection::Type type)
 {
     if (callback == Callback::Type::ON_CONNECTION) {
-        std::shared_ptr<Socket> connectionSocket = std::make_shared<Socket>(socket);
+        registerConnection(std::make_shared<Socket>(socket), type);
+    }
+}
 
-        if (side_ == connection::Side::CLIENT) {
-            client_.socket = connectionSocket;
-            callbacks_.onConnection(0);
-        } else if (side_ == connection::Side::SERVER) {
-            server_.clients[server_.nextClientId] = connectionSocket;
-            callbacks_.onConnection(server_.nextClientId);
-            server_.nextClientId++;
+void glnet::Manager::callbackHandler(Callback::Type callback, connection::Type type)
+{
+    if (callback == Callback::Type::ON_CONNECTION) {
+        registerConnection(nullptr, type);
+    }
+}
+
+void glnet::Manager::registerConnection(std::shared_ptr<Socket> socket, connection::Type type)
+{
+    if (side_ == connection::Side::CLIENT) {
+        client_.socket = socket;
+        callbacks_.onConnection(0);
+        if (connectWaiter_) {
+            std::exchange(connectWaiter_, {}).resume();
+        }
+    } else if (side_ == connection::Side::SERVER) {
+        std::uint32_t id = 0;
+        {
+            std::unique_lock lock(clientsMutex_);
+
+            id = server_.nextClientId++;
+            server_.clients[id] = socket;
+        }
+        switch (type) {
+            case connection::Type::SHM:
+                shm_->track(id);
+                break;
+            case connection::Type::LOOPBACK:
+                loopback_->track(id);
+                break;
+            default:
+                (type == connection::Type::LOCAL ? local_ : tcp_)->track(id);
+                break;
         }
+        callbacks_.onConnection(id);
     }
 }
 
 void glnet::Manager::callbackHandler(Callback::Type callback, std::uint32_t id)
 {
+    if (callback == Callback::Type::ON_CONNECTION_FAILURE) {
+        callbacks_.onConnectionFailure(id);
+        if (connectWaiter_) {
+            *connectFailed_ = true;
+            std::exchange(connectWaiter_, {}).resume();
+        }
+    }
+    if (callback == Callback::Type::ON_BACKPRESSURE) {
+        callbacks_.onBackpressure(id);
+    }
+    if (callback == Callback::Type::ON_WRITABLE) {
+        callbacks_.onWritable(id);
+    }
     if (callback == Callback::Type::ON_DISCONNECTION) {
-        disconnectionQueue_.push(id);
+        std::shared_ptr<Mailbox> mailbox;
+        {
+            std::scoped_lock lock(mailboxesMutex_);
+            auto it = mailboxes_.find(id);
+
+            if (it != mailboxes_.end()) {
+                mailbox = it->second;
+                mailboxes_.erase(it);
+            }
+        }
+        if (mailbox) {
+            mailbox->close();
+        }
+        if (udp_) {
+            udp_->forget(id);
+        }
+        disconnectionQueue_.push(std::move(id));
+        disconnectionWakeup_.notify();
     }
 }
 
 void glnet::Manager::callbackHandler(Callback::Type callback, connection::Type type, std::uint32_t id, Packet& packet)
 {
     if (callback == Callback::Type::ON_MESSAGE_RECEPTION) {
-        if (side_ != connection::Side::CLIENT && server_.clients.find(id) == server_.clients.end()) {
+        if (side_ != connection::Side::CLIENT && !hasClient(id)) {
+            return;
+        }
+        if (capture_.isOpen()) {
+            capture_.record(utils::Capture::Direction::IN, type, id, packet.bytes.data(), packet.length);
+        }
+        dispatchMessage(type, id, packet);
+    }
+}
+
+void glnet::Manager::callbackHandler(Callback::Type callback, std::uint32_t id, Socket::Fd descriptor, Packet& packet)
+{
+    if (callback == Callback::Type::ON_DESCRIPTOR_RECEPTION) {
+        if (side_ != connection::Side::CLIENT && !hasClient(id)) {
+            Socket(descriptor).close();
             return;
         }
-        callbacks_.onMessageReception(type, id, packet);
+        if (capture_.isOpen()) {
+            capture_.record(utils::Capture::Direction::IN, connection::Type::LOCAL, id, packet.bytes.data(), packet.length);
+        }
+        // Without a descriptor callback the descriptor is closed and the packet is handled like any message
+        if (!callbacks_.onDescriptorReception(id, descriptor, packet)) {
+            Socket(descriptor).close();
+            dispatchMessage(connection::Type::LOCAL, id, packet);
+        }
+    }
+}
+
+void glnet::Manager::dispatchMessage(connection::Type type, std::uint32_t id, Packet& packet)
+{
+    std::shared_ptr<Mailbox> mailbox;
+    {
+        std::scoped_lock lock(mailboxesMutex_);
+        auto it = mailboxes_.find(id);
+
+        if (it != mailboxes_.end()) {
+            mailbox = it->second;
+        }
+    }
+    if (mailbox) {
+        mailbox->push(std::move(packet));
+        return;
     }
+    callbacks_.onMessageReception(type, id, packet);
 }
 
 template <typename T>
@@ -167,7 +769,9 @@ glnet::Socket& glnet::Manager::getClientSocketBy(T& ref)
     if (side_ == connection::Side::CLIENT) {
         throw std::runtime_error("Client side has no clients");
     }
-    if (std::is_same_v<T, Socket::Fd>) {
+    std::shared_lock lock(clientsMutex_);
+
+    if constexpr (std::is_same_v<T, Socket::Fd>) {
         for (auto& [id, client] : server_.clients) {
             if (client && client->getFd() == ref) {
                 return *client;
@@ -185,6 +789,8 @@ std::uint32_t glnet::Manager::getClientIdBy(T& ref)
     if (side_ == connection::Side::CLIENT) {
         return 0;
     }
+    std::shared_lock lock(clientsMutex_);
+
     if constexpr (std::is_same_v<T, Socket>) {
         for (auto& [id, client] : server_.clients) {
             if (client && client->getFd() == ref.getFd()) {
@@ -204,11 +810,34 @@ std::uint32_t glnet::Manager::getClientIdBy(T& ref)
 template std::uint32_t glnet::Manager::getClientIdBy<glnet::Socket>(glnet::Socket& ref);
 template std::uint32_t glnet::Manager::getClientIdBy<glnet::Endpoint>(glnet::Endpoint& ref);
 
+std::shared_ptr<glnet::Socket> glnet::Manager::findClient(std::uint32_t id)
+{
+    std::shared_lock lock(clientsMutex_);
+    auto client = server_.clients.find(id);
+
+    if (client == server_.clients.end()) {
+        return nullptr;
+    }
+    return client->second;
+}
+
+bool glnet::Manager::hasClient(std::uint32_t id)
+{
+    std::shared_lock lock(clientsMutex_);
+
+    return server_.clients.contains(id);
+}
+
 void glnet::Manager::setServerEndpoint(Endpoint endpoint)
 {
     client_.server = endpoint;
 }
 
+const glnet::Endpoint& glnet::Manager::getServerEndpoint() const
+{
+    return client_.server;
+}
+
 std::uint16_t glnet::Manager::getAvailablePort()
 {
     Socket socket(connection::Type::TCP, {LOCALHOST, 0});
@@ -224,6 +853,11 @@ std::uint16_t glnet::Manager::getAvailablePort()
     return ntohs(addr.sin_port);
 }
 
+glnet::connection::Side glnet::Manager::getSide() const
+{
+    return side_;
+}
+
 glnet::Callback& glnet::Manager::callbacks()
 {
     return callbacks_;
@@ -0,0 +1,84 @@
+#include "Protocol/CongestionControl.hpp"
+
+#include <algorithm>
+
+glnet::CongestionControl::CongestionControl(Clock::time_point now) : minRttAt_(now), intervalStart_(now)
+{
+}
+
+void glnet::CongestionControl::onSent(std::size_t size)
+{
+    bytesSent_ += size;
+}
+
+void glnet::CongestionControl::onTransmission(bool retransmission)
+{
+    transmissions_++;
+    if (retransmission) {
+        retransmissions_++;
+    }
+}
+
+void glnet::CongestionControl::onRtt(std::chrono::microseconds sample, Clock::time_point now)
+{
+    srtt_ = srtt_.count() == 0 ? sample : (srtt_ * 7 + sample) / 8;
+    if (lastRtt_.count() != 0) {
+        std::chrono::microseconds delta = sample > lastRtt_ ? sample - lastRtt_ : lastRtt_ - sample;
+
+        jitter_ += (delta - jitter_) / 16;
+    }
+    lastRtt_ = sample;
+    if (minRtt_.count() == 0 || sample <= minRtt_ || now - minRttAt_ >= MIN_RTT_WINDOW) {
+        minRtt_ = sample;
+        minRttAt_ = now;
+    }
+    samples_++;
+}
+
+bool glnet::CongestionControl::update(Clock::time_point now)
+{
+    Clock::duration elapsed = now - intervalStart_;
+
+    if (elapsed < std::max<Clock::duration>(UPDATE_INTERVAL, srtt_)) {
+        return false;
+    }
+    bool measured = transmissions_ >= MIN_LOSS_SAMPLES;
+
+    if (measured) {
+        loss_ = static_cast<double>(retransmissions_) / transmissions_;
+        transmissions_ = 0;
+        retransmissions_ = 0;
+    }
+    if (samples_ != 0 || measured) {
+        std::chrono::microseconds tolerated = std::max(MIN_QUEUING_DELAY, minRtt_ / 4) + jitter_ * 2;
+        double usable = rate_ * std::chrono::duration<double>(elapsed).count();
+
+        if (measured && loss_ > LOSS_THRESHOLD) {
+            rate_ *= std::max(0.5, 1 - loss_);
+        } else if (samples_ != 0 && srtt_ - minRtt_ > tolerated) {
+            rate_ *= DELAY_DECREASE;
+        } else if (static_cast<double>(bytesSent_) * 2 >= usable) {
+            rate_ *= INCREASE;
+        }
+        rate_ = std::clamp<double>(rate_, MIN_RATE, MAX_RATE);
+    }
+    intervalStart_ = now;
+    bytesSent_ = 0;
+    samples_ = 0;
+    return true;
+}
+
+std::uint64_t glnet::CongestionControl::getRate() const
+{
+    return static_cast<std::uint64_t>(rate_);
+}
+
+glnet::RateLimit glnet::CongestionControl::getLimit() const
+{
+    return {.bytesPerSecond = getRate(), .burst = static_cast<std::uint64_t>(rate_ * std::chrono::duration<double>(BURST).count())};
+}
+
+glnet::PathStats glnet::CongestionControl::getStats() const
+{
+    return {.rtt = srtt_, .minRtt = minRtt_, .jitter = jitter_, .loss = loss_, .targetRate = getRate()};
+}
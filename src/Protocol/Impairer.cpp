@@ -0,0 +1,142 @@
+#include "Protocol/Impairer.hpp"
+
+#include <algorithm>
+
+glnet::Impairer::Impairer(bool stream) : stream_(stream), random_(std::random_device{}())
+{
+}
+
+void glnet::Impairer::setClientImpairment(connection::Direction direction, std::uint32_t clientId, Impairment impairment)
+{
+    std::scoped_lock lock(settingsMutex_);
+
+    staged_.clients[static_cast<std::size_t>(direction)][clientId] = impairment;
+    changed_ = true;
+}
+
+void glnet::Impairer::setDefaultImpairment(connection::Direction direction, Impairment impairment)
+{
+    std::scoped_lock lock(settingsMutex_);
+
+    staged_.defaults[static_cast<std::size_t>(direction)] = impairment;
+    changed_ = true;
+}
+
+glnet::Impairment glnet::Impairer::getDefaultImpairment(connection::Direction direction)
+{
+    std::scoped_lock lock(settingsMutex_);
+
+    return staged_.defaults[static_cast<std::size_t>(direction)];
+}
+
+void glnet::Impairer::clear()
+{
+    std::scoped_lock lock(settingsMutex_);
+
+    staged_ = Settings();
+    changed_ = true;
+}
+
+void glnet::Impairer::refresh()
+{
+    if (!changed_) {
+        return;
+    }
+    std::scoped_lock lock(settingsMutex_);
+
+    settings_ = staged_;
+    changed_ = false;
+    for (std::size_t direction = 0; direction < active_.size(); direction++) {
+        active_[direction] = isEnabled(settings_.defaults[direction]) || std::any_of(settings_.clients[direction].begin(), settings_.clients[direction].end(), [](const auto& entry) {
+            return isEnabled(entry.second);
+        });
+        if (!active_[direction]) {
+            links_[direction].clear();
+        }
+    }
+}
+
+bool glnet::Impairer::isActive(connection::Direction direction) const
+{
+    return active_[static_cast<std::size_t>(direction)];
+}
+
+glnet::Impairer::Plan glnet::Impairer::plan(connection::Direction direction, std::uint32_t clientId, std::size_t size, Clock::time_point now)
+{
+    std::size_t index = static_cast<std::size_t>(direction);
+    auto client = settings_.clients[index].find(clientId);
+    const Impairment& impairment = client != settings_.clients[index].end() ? client->second : settings_.defaults[index];
+    Plan plan = {.copies = 0, .at = {}};
+
+    delayed_.fetch_add(1, std::memory_order_relaxed);
+    if (!stream_ && impairment.loss > 0 && chance(impairment.loss)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return plan;
+    }
+    std::size_t copies = !stream_ && impairment.duplicate > 0 && chance(impairment.duplicate) ? 2 : 1;
+    Link& link = links_[index][clientId];
+
+    for (std::size_t copy = 0; copy < copies; copy++) {
+        Clock::time_point departure = now;
+
+        // The link serializes the packets at its capacity, a datagram waiting too long being dropped like by a full router queue
+        if (impairment.bytesPerSecond != 0) {
+            departure = std::max(now, link.busyUntil) + std::chrono::nanoseconds(size * 1000000000 / impairment.bytesPerSecond);
+            if (!stream_ && departure - now > MAX_QUEUE_DELAY) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            link.busyUntil = departure;
+        }
+        Clock::duration delay = impairment.latency;
+
+        if (impairment.jitter.count() > 0) {
+            std::int64_t jitter = std::chrono::duration_cast<std::chrono::microseconds>(impairment.jitter).count();
+
+            delay = std::max<Clock::duration>(Clock::duration::zero(), delay + std::chrono::microseconds(std::uniform_int_distribution<std::int64_t>(-jitter, jitter)(random_)));
+        }
+        if (!stream_ && impairment.reorder > 0 && chance(impairment.reorder)) {
+            delay += impairment.reorderDelay;
+            reordered_.fetch_add(1, std::memory_order_relaxed);
+        }
+        Clock::time_point at = departure + delay;
+
+        // A stream delivers in order whatever the jitter
+        if (stream_) {
+            at = std::max(at, link.lastRelease);
+            link.lastRelease = at;
+        }
+        plan.at[plan.copies++] = at;
+    }
+    if (plan.copies == MAX_COPIES) {
+        duplicated_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return plan;
+}
+
+void glnet::Impairer::erase(std::uint32_t clientId)
+{
+    for (auto& links : links_) {
+        links.erase(clientId);
+    }
+}
+
+glnet::Impairer::Counters glnet::Impairer::getCounters() const
+{
+    return {
+        .delayed = delayed_.load(std::memory_order_relaxed),
+        .dropped = dropped_.load(std::memory_order_relaxed),
+        .duplicated = duplicated_.load(std::memory_order_relaxed),
+        .reordered = reordered_.load(std::memory_order_relaxed),
+    };
+}
+
+bool glnet::Impairer::isEnabled(const Impairment& impairment)
+{
+    return impairment.latency.count() > 0 || impairment.jitter.count() > 0 || impairment.loss > 0 || impairment.duplicate > 0 || impairment.reorder > 0 || impairment.bytesPerSecond != 0;
+}
+
+bool glnet::Impairer::chance(double probability)
+{
+    return std::uniform_real_distribution<double>(0, 1)(random_) < probability;
+}
@@ -0,0 +1,257 @@
+#include "Manager.hpp"
+#include "Protocol/Loopback.hpp"
+
+#include <iostream>
+#include <cstring>
+#include <format>
+
+glnet::Loopback::Loopback(Manager& manager, connection::Side side) : manager_(manager), side_(side), running_(true)
+{
+    pollFds_.push_back({.fd = wakeup_.getFd(), .events = POLLIN, .revents = 0});
+}
+
+glnet::Loopback::~Loopback()
+{
+    std::size_t side = static_cast<std::size_t>(side_);
+
+    if (side_ == connection::Side::SERVER) {
+        Registry& registry = Registry::getInstance();
+        std::scoped_lock lock(registry.mutex);
+        auto server = registry.servers.find(name_);
+
+        // The name may already belong to a new server
+        if (server != registry.servers.end() && server->second.expired()) {
+            registry.servers.erase(server);
+        }
+    }
+    for (auto& [clientId, link] : links_) {
+        std::shared_ptr<Loopback> peer;
+        std::scoped_lock lock(link->mutex);
+
+        link->closed = true;
+        peer = link->ends[1 - side].lock();
+        if (peer) {
+            peer->post({.event = Event::DISCONNECT, .link = link, .frame = nullptr});
+        }
+    }
+}
+
+void glnet::Loopback::listen(const std::string& name)
+{
+    if (side_ != connection::Side::SERVER) {
+        return;
+    }
+    Registry& registry = Registry::getInstance();
+    std::scoped_lock lock(registry.mutex);
+    std::weak_ptr<Loopback>& server = registry.servers[name];
+
+    if (!server.expired()) {
+        throw std::runtime_error(std::format("A loopback server already listens on {}", name));
+    }
+    server = weak_from_this();
+    name_ = name;
+}
+
+void glnet::Loopback::stop()
+{
+    running_ = false;
+    wakeup_.notify();
+}
+
+void glnet::Loopback::run()
+{
+    try {
+        while (running_) {
+            Socket::poll(pollFds_, pollFds_.size(), getTimeout());
+            process();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+void glnet::Loopback::process()
+{
+    wakeup_.clear();
+    {
+        std::scoped_lock lock(inboxMutex_);
+
+        received_.swap(inbox_);
+    }
+    for (Message& message : received_) {
+        if (!running_) {
+            break;
+        }
+        switch (message.event) {
+            case Event::CONNECT:
+                meter_.onAccept();
+                registering_ = message.link;
+                manager_.callbackHandler(Callback::Type::ON_CONNECTION, connection::Type::LOOPBACK);
+                registering_ = nullptr;
+                break;
+            case Event::MESSAGE:
+                deliver(message.link, message.frame);
+                break;
+            case Event::DISCONNECT:
+                disconnect(message.link);
+                break;
+        }
+    }
+    received_.clear();
+}
+
+std::vector<glnet::Socket::PollFd>& glnet::Loopback::getPollFds()
+{
+    return pollFds_;
+}
+
+std::int32_t glnet::Loopback::getTimeout() const
+{
+    return -1;
+}
+
+void glnet::Loopback::connectToServer(const std::string& name)
+{
+    if (side_ != connection::Side::CLIENT) {
+        return;
+    }
+    std::shared_ptr<Loopback> server;
+    {
+        Registry& registry = Registry::getInstance();
+        std::scoped_lock lock(registry.mutex);
+        auto entry = registry.servers.find(name);
+
+        if (entry != registry.servers.end()) {
+            server = entry->second.lock();
+        }
+    }
+    if (!server) {
+        std::cerr << std::format("No loopback server listens on {}", name) << std::endl;
+        manager_.callbackHandler(Callback::Type::ON_CONNECTION_FAILURE, 0);
+        return;
+    }
+    std::shared_ptr<Link> link = std::make_shared<Link>();
+
+    link->ends[static_cast<std::size_t>(connection::Side::CLIENT)] = weak_from_this();
+    link->ends[static_cast<std::size_t>(connection::Side::SERVER)] = server;
+    link->counters[static_cast<std::size_t>(side_)] = &meter_.track(0);
+    {
+        std::unique_lock lock(linksMutex_);
+
+        links_[0] = link;
+    }
+    // The frames sent from the connection callback on are queued behind the connection
+    server->post({.event = Event::CONNECT, .link = link, .frame = nullptr});
+    manager_.callbackHandler(Callback::Type::ON_CONNECTION, connection::Type::LOOPBACK);
+}
+
+glnet::connection::SendResult glnet::Loopback::enqueue(Outbound outbound)
+{
+    std::shared_ptr<Link> link = findLink(outbound.clientId);
+    std::size_t side = static_cast<std::size_t>(side_);
+
+    if (!link || !outbound.frame) {
+        return connection::SendResult::FAILED;
+    }
+    // The peer is released after the lock, as the last reference destroys it and it locks its links
+    std::shared_ptr<Loopback> peer;
+    std::scoped_lock lock(link->mutex);
+
+    peer = link->ends[1 - side].lock();
+    if (link->closed || !peer || !peer->post({.event = Event::MESSAGE, .link = link, .frame = outbound.frame})) {
+        meter_.onDrop();
+        return connection::SendResult::FAILED;
+    }
+    // The counters of the connection are written under its mutex, one producer at a time
+    link->counters[side]->bytesOut.add(outbound.frame->size());
+    link->counters[side]->packetsOut.add();
+    return connection::SendResult::QUEUED;
+}
+
+void glnet::Loopback::track(std::uint32_t clientId)
+{
+    if (!registering_) {
+        return;
+    }
+    registering_->clientId = clientId;
+    registering_->counters[static_cast<std::size_t>(side_)] = &meter_.track(clientId);
+    std::unique_lock lock(linksMutex_);
+
+    links_[clientId] = registering_;
+}
+
+glnet::TransportMetrics glnet::Loopback::getMetrics()
+{
+    return meter_.snapshot();
+}
+
+bool glnet::Loopback::post(Message message)
+{
+    {
+        std::scoped_lock lock(inboxMutex_);
+
+        if (message.event == Event::MESSAGE && inbox_.size() >= MAX_QUEUED_FRAMES) {
+            return false;
+        }
+        inbox_.push_back(std::move(message));
+    }
+    wakeup_.notify();
+    return true;
+}
+
+void glnet::Loopback::deliver(const std::shared_ptr<Link>& link, const Frame& frame)
+{
+    std::uint32_t clientId = side_ == connection::Side::SERVER ? link->clientId : 0;
+    auto open = links_.find(clientId);
+
+    // The frames of a connection the server refused or already closed are dropped
+    if (open == links_.end() || open->second != link) {
+        return;
+    }
+    Meter::Counters& counters = *link->counters[static_cast<std::size_t>(side_)];
+    Packet packet;
+
+    std::memcpy(&packet.length, frame->data(), sizeof(packet.length));
+    packet.bytes.assign(frame->begin() + sizeof(packet.length), frame->end());
+    counters.bytesIn.add(frame->size());
+    counters.packetsIn.add();
+    // An empty frame is a heartbeat, like on tcp
+    if (packet.length == 0) {
+        return;
+    }
+    try {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        manager_.callbackHandler(Callback::Type::ON_MESSAGE_RECEPTION, connection::Type::LOOPBACK, clientId, packet);
+        meter_.onCallback(std::chrono::steady_clock::now() - start);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+void glnet::Loopback::disconnect(const std::shared_ptr<Link>& link)
+{
+    std::uint32_t clientId = side_ == connection::Side::SERVER ? link->clientId : 0;
+    auto open = links_.find(clientId);
+
+    if (open == links_.end() || open->second != link) {
+        return;
+    }
+    {
+        std::unique_lock lock(linksMutex_);
+
+        links_.erase(open);
+    }
+    meter_.forget(clientId);
+    if (side_ == connection::Side::SERVER) {
+        manager_.callbackHandler(Callback::Type::ON_DISCONNECTION, clientId);
+    }
+}
+
+std::shared_ptr<glnet::Loopback::Link> glnet::Loopback::findLink(std::uint32_t clientId)
+{
+    std::shared_lock lock(linksMutex_);
+    auto link = links_.find(clientId);
+
+    return link != links_.end() ? link->second : nullptr;
+}
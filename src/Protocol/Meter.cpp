@@ -0,0 +1,81 @@
+#include "Protocol/Meter.hpp"
+
+glnet::Meter::Counters& glnet::Meter::track(std::uint32_t clientId)
+{
+    auto counters = connections_.find(clientId);
+
+    if (counters != connections_.end()) {
+        return *counters->second;
+    }
+    std::scoped_lock lock(mutex_);
+
+    return *connections_.emplace(clientId, std::make_unique<Counters>()).first->second;
+}
+
+void glnet::Meter::forget(std::uint32_t clientId)
+{
+    std::scoped_lock lock(mutex_);
+    auto counters = connections_.find(clientId);
+
+    if (counters == connections_.end()) {
+        return;
+    }
+    retired_.bytesIn.add(counters->second->bytesIn.get());
+    retired_.bytesOut.add(counters->second->bytesOut.get());
+    retired_.packetsIn.add(counters->second->packetsIn.get());
+    retired_.packetsOut.add(counters->second->packetsOut.get());
+    retired_.partialReads.add(counters->second->partialReads.get());
+    retired_.partialWrites.add(counters->second->partialWrites.get());
+    connections_.erase(counters);
+}
+
+void glnet::Meter::onDrop()
+{
+    dropped_.add();
+}
+
+void glnet::Meter::onAccept()
+{
+    totals_.accepted.add();
+}
+
+void glnet::Meter::onCallback(std::chrono::steady_clock::duration elapsed)
+{
+    totals_.callbacks.add();
+    totals_.callbackTime.add(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+}
+
+void glnet::Meter::setQueuedFrames(std::size_t frames)
+{
+    totals_.queuedFrames.set(frames);
+}
+
+glnet::TransportMetrics glnet::Meter::snapshot() const
+{
+    TransportMetrics metrics;
+    std::scoped_lock lock(mutex_);
+
+    collect(retired_, metrics.total);
+    for (const auto& [clientId, counters] : connections_) {
+        TrafficMetrics& traffic = metrics.connections[clientId];
+
+        collect(*counters, traffic);
+        collect(*counters, metrics.total);
+    }
+    metrics.framesDropped = dropped_.get();
+    metrics.queuedFrames = totals_.queuedFrames.get();
+    metrics.accepted = totals_.accepted.get();
+    metrics.callbacks = totals_.callbacks.get();
+    metrics.callbackTime = std::chrono::nanoseconds(totals_.callbackTime.get());
+    return metrics;
+}
+
+void glnet::Meter::collect(const Counters& counters, TrafficMetrics& traffic)
+{
+    traffic.bytesIn += counters.bytesIn.get();
+    traffic.bytesOut += counters.bytesOut.get();
+    traffic.packetsIn += counters.packetsIn.get();
+    traffic.packetsOut += counters.packetsOut.get();
+    traffic.partialReads += counters.partialReads.get();
+    traffic.partialWrites += counters.partialWrites.get();
+}
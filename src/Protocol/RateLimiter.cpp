@@ -0,0 +1,207 @@
+#include "Protocol/RateLimiter.hpp"
+
+#include <algorithm>
+
+void glnet::RateLimiter::setClientLimit(std::uint32_t clientId, RateLimit limit)
+{
+    std::scoped_lock lock(settingsMutex_);
+
+    staged_.clients[clientId] = limit;
+    changed_ = true;
+}
+
+void glnet::RateLimiter::setDefaultClientLimit(RateLimit limit)
+{
+    std::scoped_lock lock(settingsMutex_);
+
+    staged_.defaultClient = limit;
+    changed_ = true;
+}
+
+void glnet::RateLimiter::setGlobalLimit(RateLimit limit)
+{
+    std::scoped_lock lock(settingsMutex_);
+
+    staged_.global = limit;
+    changed_ = true;
+}
+
+void glnet::RateLimiter::setOverflow(connection::Overflow overflow)
+{
+    std::scoped_lock lock(settingsMutex_);
+
+    staged_.overflow = overflow;
+    changed_ = true;
+}
+
+void glnet::RateLimiter::setAdaptiveLimit(std::uint32_t clientId, RateLimit limit)
+{
+    if (limit.bytesPerSecond == 0) {
+        adaptive_.erase(clientId);
+        return;
+    }
+    auto bucket = adaptive_.find(clientId);
+
+    if (bucket == adaptive_.end()) {
+        adaptive_.try_emplace(clientId, limit, Clock::now());
+    } else {
+        bucket->second.setLimit(limit);
+    }
+}
+
+void glnet::RateLimiter::clearAdaptiveLimits()
+{
+    adaptive_.clear();
+}
+
+void glnet::RateLimiter::refresh()
+{
+    retryAt_ = Clock::time_point::max();
+    if (!changed_) {
+        return;
+    }
+    std::scoped_lock lock(settingsMutex_);
+    Clock::time_point now = Clock::now();
+    bool defaultChanged = staged_.defaultClient.bytesPerSecond != settings_.defaultClient.bytesPerSecond || staged_.defaultClient.burst != settings_.defaultClient.burst;
+
+    changed_ = false;
+    settings_.defaultClient = staged_.defaultClient;
+    settings_.global = staged_.global;
+    settings_.overflow = staged_.overflow;
+    // Only the changed entries are applied, and the buckets keep their tokens, so setting a limit never hands out a fresh burst
+    for (const auto& [clientId, limit] : staged_.clients) {
+        RateLimit& applied = settings_.clients[clientId];
+
+        limitedClients_ += (limit.bytesPerSecond != 0) - (applied.bytesPerSecond != 0);
+        applied = limit;
+        if (!defaultChanged) {
+            updateBucket(clientId);
+        }
+    }
+    staged_.clients.clear();
+    if (defaultChanged) {
+        for (auto it = buckets_.begin(); it != buckets_.end();) {
+            it = updateBucket(it);
+        }
+    }
+    if (settings_.global.bytesPerSecond == 0) {
+        global_.reset();
+    } else if (global_) {
+        global_->setLimit(settings_.global);
+    } else {
+        global_.emplace(settings_.global, now);
+    }
+    limited_ = global_ || settings_.defaultClient.bytesPerSecond != 0 || limitedClients_ != 0;
+}
+
+glnet::RateLimiter::Verdict glnet::RateLimiter::admit(const Outbound& outbound, Clock::time_point now)
+{
+    if (!limited_ && adaptive_.empty()) {
+        return Verdict::SEND;
+    }
+    std::size_t size = outbound.frame->size();
+    utils::TokenBucket *bucket = limited_ ? getBucket(outbound.clientId, now) : nullptr;
+    auto adaptive = adaptive_.find(outbound.clientId);
+    utils::TokenBucket *cap = adaptive != adaptive_.end() ? &adaptive->second : nullptr;
+    bool globalFits = !global_ || global_->canConsume(size, now);
+    bool clientFits = !bucket || bucket->canConsume(size, now);
+    bool capFits = !cap || cap->canConsume(size, now);
+
+    if (globalFits && clientFits && capFits) {
+        if (global_) {
+            global_->consume(size);
+        }
+        if (bucket) {
+            bucket->consume(size);
+        }
+        if (cap) {
+            cap->consume(size);
+        }
+        return Verdict::SEND;
+    }
+    if (settings_.overflow == connection::Overflow::DROP) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return Verdict::DROP;
+    }
+    if (settings_.overflow == connection::Overflow::DOWNSAMPLE && outbound.priority == connection::Priority::REALTIME) {
+        downsampled_.fetch_add(1, std::memory_order_relaxed);
+        return Verdict::DROP;
+    }
+    Clock::duration delay = std::max({global_ ? global_->getDelay(size) : Clock::duration::zero(), bucket ? bucket->getDelay(size) : Clock::duration::zero(), cap ? cap->getDelay(size) : Clock::duration::zero()});
+
+    deferred_.fetch_add(1, std::memory_order_relaxed);
+    retryAt_ = std::min(retryAt_, now + delay);
+    return Verdict::DEFER;
+}
+
+void glnet::RateLimiter::erase(std::uint32_t clientId)
+{
+    auto client = settings_.clients.find(clientId);
+
+    buckets_.erase(clientId);
+    adaptive_.erase(clientId);
+    if (client != settings_.clients.end()) {
+        limitedClients_ -= client->second.bytesPerSecond != 0;
+        settings_.clients.erase(client);
+        limited_ = global_ || settings_.defaultClient.bytesPerSecond != 0 || limitedClients_ != 0;
+    }
+    std::scoped_lock lock(settingsMutex_);
+
+    staged_.clients.erase(clientId);
+}
+
+glnet::RateLimiter::Clock::time_point glnet::RateLimiter::getRetryDeadline() const
+{
+    return retryAt_;
+}
+
+glnet::RateLimiter::Counters glnet::RateLimiter::getCounters() const
+{
+    return {
+        .deferred = deferred_.load(std::memory_order_relaxed),
+        .dropped = dropped_.load(std::memory_order_relaxed),
+        .downsampled = downsampled_.load(std::memory_order_relaxed),
+    };
+}
+
+glnet::utils::TokenBucket *glnet::RateLimiter::getBucket(std::uint32_t clientId, Clock::time_point now)
+{
+    auto bucket = buckets_.find(clientId);
+
+    if (bucket != buckets_.end()) {
+        return &bucket->second;
+    }
+    RateLimit limit = getLimit(clientId);
+
+    if (limit.bytesPerSecond == 0) {
+        return nullptr;
+    }
+    return &buckets_.try_emplace(clientId, limit, now).first->second;
+}
+
+glnet::RateLimit glnet::RateLimiter::getLimit(std::uint32_t clientId) const
+{
+    auto client = settings_.clients.find(clientId);
+
+    return client != settings_.clients.end() ? client->second : settings_.defaultClient;
+}
+
+void glnet::RateLimiter::updateBucket(std::uint32_t clientId)
+{
+    auto bucket = buckets_.find(clientId);
+
+    if (bucket != buckets_.end()) {
+        updateBucket(bucket);
+    }
+}
+
+std::unordered_map<std::uint32_t, glnet::utils::TokenBucket>::iterator glnet::RateLimiter::updateBucket(std::unordered_map<std::uint32_t, utils::TokenBucket>::iterator bucket)
+{
+    RateLimit limit = getLimit(bucket->first);
+
+    if (limit.bytesPerSecond == 0) {
+        return buckets_.erase(bucket);
+    }
+    bucket->second.setLimit(limit);
+    return ++bucket;
+}
@@ -0,0 +1,166 @@
+#include "Protocol/Reliability.hpp"
+
+#include <algorithm>
+
+bool glnet::Reliability::isNewer(std::uint16_t lhs, std::uint16_t rhs)
+{
+    return static_cast<std::uint16_t>(lhs - rhs) != 0 && static_cast<std::uint16_t>(lhs - rhs) < 0x8000;
+}
+
+void glnet::Reliability::send(const Frame& frame, std::uint16_t messageId)
+{
+    queued_.push_back({.sequence = 0, .frame = frame, .sentAt = {}, .transmissions = 0, .messageId = messageId});
+}
+
+void glnet::Reliability::collectSendable(Clock::time_point now, std::vector<const Pending *>& sendable)
+{
+    while (!queued_.empty() && (pending_.empty() || static_cast<std::uint16_t>(nextSequence_ - pending_.front().sequence) < SEND_WINDOW)) {
+        Pending& pending = pending_.emplace_back(std::move(queued_.front()));
+
+        queued_.pop_front();
+        pending.sequence = nextSequence_++;
+        pending.sentAt = now;
+        pending.transmissions = 1;
+        sendable.push_back(&pending);
+    }
+}
+
+std::chrono::microseconds glnet::Reliability::acknowledge(std::uint16_t ack, std::uint32_t ackBits, Clock::time_point now)
+{
+    std::chrono::microseconds sample{0};
+
+    auto isAcked = [ack, ackBits](std::uint16_t sequence) {
+        std::uint16_t distance = static_cast<std::uint16_t>(ack - sequence);
+
+        if (distance == 0) {
+            return true;
+        }
+        return distance <= 32 && (ackBits & (1u << (distance - 1))) != 0;
+    };
+
+    for (auto it = pending_.begin(); it != pending_.end();) {
+        if (!isAcked(it->sequence)) {
+            it++;
+            continue;
+        }
+        if (it->transmissions == 1) {
+            sample = std::chrono::duration_cast<std::chrono::microseconds>(now - it->sentAt);
+            sampleRtt(sample);
+        }
+        it = pending_.erase(it);
+    }
+    return sample;
+}
+
+void glnet::Reliability::collectExpired(Clock::time_point now, std::vector<const Pending *>& expired)
+{
+    for (Pending& pending : pending_) {
+        if (now - pending.sentAt < getTimeout(pending)) {
+            continue;
+        }
+        pending.sentAt = now;
+        pending.transmissions++;
+        expired.push_back(&pending);
+    }
+}
+
+glnet::Reliability::Clock::time_point glnet::Reliability::getNextDeadline() const
+{
+    Clock::time_point deadline = Clock::time_point::max();
+
+    for (const Pending& pending : pending_) {
+        deadline = std::min(deadline, pending.sentAt + getTimeout(pending));
+    }
+    return deadline;
+}
+
+bool glnet::Reliability::receive(std::uint16_t sequence, Packet&& packet, std::vector<Packet>& deliverable)
+{
+    if (static_cast<std::uint16_t>(sequence - nextExpected_) >= RECEIVE_WINDOW) {
+        if (!isNewer(sequence, nextExpected_)) {
+            recordAck(sequence);
+        }
+        return false;
+    }
+    recordAck(sequence);
+    if (sequence != nextExpected_) {
+        return buffered_.try_emplace(sequence, std::move(packet)).second;
+    }
+    deliverable.push_back(std::move(packet));
+    nextExpected_++;
+    for (auto it = buffered_.find(nextExpected_); it != buffered_.end(); it = buffered_.find(nextExpected_)) {
+        deliverable.push_back(std::move(it->second));
+        buffered_.erase(it);
+        nextExpected_++;
+    }
+    return true;
+}
+
+bool glnet::Reliability::hasReceived() const
+{
+    return received_;
+}
+
+std::uint16_t glnet::Reliability::getAck() const
+{
+    return remoteSequence_;
+}
+
+std::uint32_t glnet::Reliability::getAckBits() const
+{
+    return remoteBits_;
+}
+
+std::chrono::microseconds glnet::Reliability::getRtt() const
+{
+    return srtt_;
+}
+
+std::size_t glnet::Reliability::getPendingCount() const
+{
+    return queued_.size() + pending_.size();
+}
+
+std::chrono::microseconds glnet::Reliability::getTimeout(const Pending& pending) const
+{
+    return std::min(rto_ * (1 << std::min<std::uint32_t>(pending.transmissions - 1, 6)), MAX_RTO);
+}
+
+void glnet::Reliability::sampleRtt(std::chrono::microseconds sample)
+{
+    if (srtt_.count() == 0) {
+        srtt_ = sample;
+        rttVar_ = sample / 2;
+    } else {
+        std::chrono::microseconds delta = srtt_ > sample ? srtt_ - sample : sample - srtt_;
+
+        rttVar_ = (rttVar_ * 3 + delta) / 4;
+        srtt_ = (srtt_ * 7 + sample) / 8;
+    }
+    rto_ = std::clamp(srtt_ + rttVar_ * 4, MIN_RTO, MAX_RTO);
+}
+
+void glnet::Reliability::recordAck(std::uint16_t sequence)
+{
+    if (!received_) {
+        received_ = true;
+        remoteSequence_ = sequence;
+        remoteBits_ = 0;
+        return;
+    }
+    if (isNewer(sequence, remoteSequence_)) {
+        std::uint16_t shift = static_cast<std::uint16_t>(sequence - remoteSequence_);
+
+        remoteBits_ = shift < 32 ? (remoteBits_ << shift) : 0;
+        if (shift <= 32) {
+            remoteBits_ |= 1u << (shift - 1);
+        }
+        remoteSequence_ = sequence;
+        return;
+    }
+    std::uint16_t distance = static_cast<std::uint16_t>(remoteSequence_ - sequence);
+
+    if (distance >= 1 && distance <= 32) {
+        remoteBits_ |= 1u << (distance - 1);
+    }
+}
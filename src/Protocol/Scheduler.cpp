@@ -0,0 +1,134 @@
+#include "Protocol/Scheduler.hpp"
+
+void glnet::Scheduler::push(Outbound&& outbound)
+{
+    auto [it, inserted] = connections_.try_emplace(outbound.clientId);
+    Classes& classes = it->second;
+
+    if (inserted) {
+        classes.deficits[0] = WEIGHTS[0] * QUANTUM;
+        if (!blocked_.contains(outbound.clientId)) {
+            active_.push_back(outbound.clientId);
+        }
+    }
+    classes.queues[static_cast<std::size_t>(outbound.priority)].push_back(std::move(outbound));
+    classes.size++;
+    size_++;
+}
+
+bool glnet::Scheduler::pop(Clock::time_point now, RateLimiter& limiter, Outbound& outbound)
+{
+    std::size_t deferred = 0;
+
+    while (deferred < active_.size()) {
+        std::uint32_t clientId = active_.front();
+        auto it = connections_.find(clientId);
+        Classes& classes = it->second;
+        Outbound *head = selectClass(classes, now);
+        RateLimiter::Verdict verdict = head ? limiter.admit(*head, now) : RateLimiter::Verdict::DROP;
+
+        if (head && verdict != RateLimiter::Verdict::DEFER) {
+            if (verdict == RateLimiter::Verdict::SEND) {
+                classes.deficits[classes.current] -= head->frame->size();
+                outbound = std::move(*head);
+            } else if (onDiscard_) {
+                onDiscard_(*head);
+            }
+            classes.queues[classes.current].pop_front();
+            classes.size--;
+            size_--;
+        }
+        if (classes.size == 0) {
+            connections_.erase(it);
+            active_.pop_front();
+        } else if (verdict != RateLimiter::Verdict::DROP) {
+            active_.pop_front();
+            active_.push_back(clientId);
+        }
+        if (verdict == RateLimiter::Verdict::SEND) {
+            return true;
+        }
+        if (verdict == RateLimiter::Verdict::DEFER) {
+            deferred++;
+        }
+    }
+    return false;
+}
+
+glnet::Outbound *glnet::Scheduler::selectClass(Classes& classes, Clock::time_point now)
+{
+    while (classes.size != 0) {
+        std::deque<Outbound>& queue = classes.queues[classes.current];
+
+        while (!queue.empty() && queue.front().deadline != Clock::time_point{} && queue.front().deadline < now) {
+            if (onDiscard_) {
+                onDiscard_(queue.front());
+            }
+            queue.pop_front();
+            classes.size--;
+            size_--;
+            expired_++;
+        }
+        if (!queue.empty() && classes.deficits[classes.current] >= queue.front().frame->size()) {
+            return &queue.front();
+        }
+        if (queue.empty()) {
+            classes.deficits[classes.current] = 0;
+        }
+        classes.current = (classes.current + 1) % CLASS_COUNT;
+        classes.deficits[classes.current] += WEIGHTS[classes.current] * QUANTUM;
+    }
+    return nullptr;
+}
+
+void glnet::Scheduler::block(std::uint32_t clientId)
+{
+    if (blocked_.insert(clientId).second) {
+        std::erase(active_, clientId);
+    }
+}
+
+void glnet::Scheduler::unblock(std::uint32_t clientId)
+{
+    if (blocked_.erase(clientId) != 0 && connections_.contains(clientId)) {
+        active_.push_back(clientId);
+    }
+}
+
+void glnet::Scheduler::setOnDiscard(std::function<void(const Outbound&)> func)
+{
+    onDiscard_ = func;
+}
+
+void glnet::Scheduler::erase(std::uint32_t clientId)
+{
+    auto it = connections_.find(clientId);
+
+    blocked_.erase(clientId);
+    if (it == connections_.end()) {
+        return;
+    }
+    size_ -= it->second.size;
+    connections_.erase(it);
+    std::erase(active_, clientId);
+}
+
+bool glnet::Scheduler::empty() const
+{
+    return size_ == 0;
+}
+
+bool glnet::Scheduler::full() const
+{
+    return size_ >= MAX_SCHEDULED;
+}
+
+std::size_t glnet::Scheduler::size() const
+{
+    return size_;
+}
+
+std::uint64_t glnet::Scheduler::getExpiredCount() const
+{
+    return expired_;
+}
@@ -0,0 +1,468 @@
+#include "Manager.hpp"
+#include "Protocol/Shm.hpp"
+
+#ifdef _WIN32
+
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <cstring>
+#include <format>
+#include <new>
+
+glnet::Shm::Link::~Link()
+{
+#ifndef _WIN32
+    if (memory != nullptr) {
+        ::munmap(memory, size);
+    }
+#endif
+}
+
+glnet::Shm::Shm(Manager& manager, Endpoint endpoint, connection::Side side, ShmOptions options)
+    : manager_(manager), side_(side), options_(options), running_(true), socket_(connection::Type::LOCAL, endpoint), lastFrame_()
+{
+#ifdef _WIN32
+    throw std::runtime_error("Shared memory connections are not supported on this platform");
+#else
+    if (side_ == connection::Side::SERVER) {
+        Socket::Address_un addr = {};
+        Socket::AddressLength addrLen = Socket::localAddress(endpoint.address, addr);
+        std::error_code error;
+
+        // The socket file left by a previous server would make the bind fail
+        if (endpoint.address[0] != '@' && std::filesystem::is_socket(endpoint.address, error)) {
+            std::filesystem::remove(endpoint.address, error);
+        }
+        socket_.bind((Socket::Address&) addr, addrLen);
+        socket_.listen();
+        socket_.setBlocking(false);
+    }
+    pollFds_.push_back({.fd = side_ == connection::Side::SERVER ? socket_.getFd() : INVALID_FD, .events = POLLIN, .revents = 0});
+    pollFds_.push_back({.fd = wakeup_.getFd(), .events = POLLIN, .revents = 0});
+    polled_.resize(pollFds_.size());
+#endif
+}
+
+void glnet::Shm::stop()
+{
+    running_ = false;
+    wakeup_.notify();
+}
+
+void glnet::Shm::run()
+{
+    std::chrono::steady_clock::time_point lastPoll = {};
+
+    try {
+        while (running_) {
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+            // After a frame the rings are read again without sleeping, the sockets being polled only now and then
+            if (now - lastFrame_ < options_.spin) {
+                if (now - lastPoll < SPIN_POLL_INTERVAL) {
+                    drain();
+                    continue;
+                }
+                Socket::poll(pollFds_, pollFds_.size(), 0);
+            } else {
+                Socket::poll(pollFds_, pollFds_.size(), getTimeout());
+            }
+            lastPoll = now;
+            process();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+void glnet::Shm::process()
+{
+    // The rings are read before the hangups are handled, so the last frames of a closed peer are delivered
+    drain();
+    if (pollFds_[WAKEUP_POLL_INDEX].revents & POLLIN) {
+        wakeup_.clear();
+    }
+    if (pollFds_[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+        if (side_ == connection::Side::SERVER) {
+            acceptSockets();
+        } else if (!readDoorbells(pollFds_[0].fd)) {
+            disconnect(0);
+        }
+    }
+    if (side_ == connection::Side::SERVER) {
+        for (std::size_t i = FIRST_CLIENT_POLL_INDEX; i < pollFds_.size(); i++) {
+            if (!(pollFds_[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+            if (!(polled_[i] ? readDoorbells(pollFds_[i].fd) : registerClient(i))) {
+                disconnect(i);
+                i--;
+            }
+        }
+    }
+}
+
+std::vector<glnet::Socket::PollFd>& glnet::Shm::getPollFds()
+{
+    return pollFds_;
+}
+
+std::int32_t glnet::Shm::getTimeout()
+{
+    std::int32_t timeout = -1;
+
+    for (auto& [clientId, link] : links_) {
+        if (!link->inbound.sleep()) {
+            timeout = 0;
+        }
+    }
+    return timeout;
+}
+
+void glnet::Shm::connectToServer(const std::string& path)
+{
+    if (side_ != connection::Side::CLIENT) {
+        return;
+    }
+#ifndef _WIN32
+    Socket::Fd memory = INVALID_FD;
+
+    try {
+        std::shared_ptr<Link> link = std::make_shared<Link>();
+        std::size_t capacity = options_.capacity;
+
+        if (capacity > UINT32_MAX || (capacity & (capacity - 1)) != 0) {
+            throw std::runtime_error(std::format("The capacity of a shared ring must be a power of two, not {}", capacity));
+        }
+        link->size = getMemorySize(capacity);
+        memory = ::memfd_create("glnet-shm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (memory == INVALID_FD || ::ftruncate(memory, static_cast<off_t>(link->size)) != 0) {
+            throw std::runtime_error(std::format("Couldn't create the shared memory: {}.", std::strerror(errno)));
+        }
+        // The server maps a memory whose size can no longer change under it
+        ::fcntl(memory, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL);
+        link->memory = ::mmap(nullptr, link->size, PROT_READ | PROT_WRITE, MAP_SHARED, memory, 0);
+        if (link->memory == MAP_FAILED) {
+            link->memory = nullptr;
+            throw std::runtime_error(std::format("Couldn't map the shared memory: {}.", std::strerror(errno)));
+        }
+        Header *header = new (link->memory) Header();
+        std::uint8_t *rings = static_cast<std::uint8_t *>(link->memory) + sizeof(Header);
+
+        std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+        header->version = VERSION;
+        header->capacity = static_cast<std::uint32_t>(capacity);
+        link->outbound.attach(rings, capacity, true);
+        link->inbound.attach(rings + utils::ShmRing::getFootprint(capacity), capacity, true);
+
+        Socket::Address_un addr = {};
+        Socket::AddressLength addrLen = Socket::localAddress(path, addr);
+        std::uint8_t hello = 0;
+        Socket::Buffer buffer = &hello;
+
+        socket_.connect((Socket::Address&) addr, addrLen);
+        if (socket_.trySend(buffer, sizeof(hello), memory) != sizeof(hello)) {
+            throw std::runtime_error("Couldn't send the shared memory to the server");
+        }
+        socket_.setBlocking(false);
+        Socket(memory).close();
+        link->doorbell = socket_.getFd();
+        link->counters = &meter_.track(0);
+        {
+            std::unique_lock lock(linksMutex_);
+
+            links_[0] = link;
+        }
+        pollFds_[0].fd = socket_.getFd();
+        polled_[0] = link;
+    } catch (const std::exception& e) {
+        if (memory != INVALID_FD) {
+            Socket(memory).close();
+        }
+        std::cerr << e.what() << std::endl;
+        manager_.callbackHandler(Callback::Type::ON_CONNECTION_FAILURE, 0);
+        return;
+    }
+    manager_.callbackHandler(Callback::Type::ON_CONNECTION, socket_, connection::Type::SHM);
+#endif
+}
+
+glnet::connection::SendResult glnet::Shm::enqueue(Outbound outbound)
+{
+    std::shared_ptr<Link> link = findLink(outbound.clientId);
+
+    if (!link || !outbound.frame) {
+        return connection::SendResult::FAILED;
+    }
+    std::scoped_lock lock(link->mutex);
+
+    if (link->closed || !link->outbound.push(outbound.frame->data(), outbound.frame->size())) {
+        meter_.onDrop();
+        return connection::SendResult::FAILED;
+    }
+    // The counters of the connection are written under its mutex, one producer at a time
+    link->counters->bytesOut.add(outbound.frame->size());
+    link->counters->packetsOut.add();
+    if (link->outbound.needsWakeup()) {
+        std::uint8_t doorbell = 0;
+        Socket::Buffer buffer = &doorbell;
+
+        // A full socket already holds doorbells, and a broken one is reported to the shm thread by poll
+        try {
+            Socket(link->doorbell).trySend(buffer, sizeof(doorbell));
+        } catch (const std::exception&) {
+        }
+    }
+    return connection::SendResult::QUEUED;
+}
+
+void glnet::Shm::track(std::uint32_t clientId)
+{
+    if (!registering_) {
+        return;
+    }
+    registering_->clientId = clientId;
+    registering_->counters = &meter_.track(clientId);
+    std::unique_lock lock(linksMutex_);
+
+    links_[clientId] = registering_;
+}
+
+glnet::TransportMetrics glnet::Shm::getMetrics()
+{
+    TransportMetrics metrics = meter_.snapshot();
+    std::shared_lock lock(linksMutex_);
+
+    for (const auto& [clientId, link] : links_) {
+        std::size_t queued = link->outbound.getUsed();
+
+        metrics.total.queuedBytes += queued;
+        metrics.connections[clientId].queuedBytes = queued;
+    }
+    return metrics;
+}
+
+bool glnet::Shm::drain()
+{
+    std::vector<std::uint32_t> corrupted;
+    bool read = false;
+
+    for (auto& [clientId, link] : links_) {
+        Meter::Counters& counters = *link->counters;
+
+        link->inbound.wake();
+        try {
+            for (std::size_t frames = 0; frames < MAX_READ_BATCH; frames++) {
+                std::size_t size = 0;
+                const std::uint8_t *frame = link->inbound.front(size);
+
+                if (frame == nullptr) {
+                    break;
+                }
+                Packet packet;
+
+                std::memcpy(&packet.length, frame, sizeof(packet.length));
+                packet.bytes.assign(frame + sizeof(packet.length), frame + size);
+                link->inbound.pop(size);
+                counters.bytesIn.add(size);
+                counters.packetsIn.add();
+                read = true;
+                // An empty frame is a heartbeat, like on tcp
+                if (packet.length == 0) {
+                    continue;
+                }
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+                manager_.callbackHandler(Callback::Type::ON_MESSAGE_RECEPTION, connection::Type::SHM, clientId, packet);
+                meter_.onCallback(std::chrono::steady_clock::now() - start);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            corrupted.push_back(clientId);
+        }
+    }
+    for (std::uint32_t clientId : corrupted) {
+        auto link = std::find(polled_.begin(), polled_.end(), links_[clientId]);
+
+        if (link != polled_.end()) {
+            disconnect(static_cast<std::size_t>(link - polled_.begin()));
+        }
+    }
+    if (read) {
+        lastFrame_ = std::chrono::steady_clock::now();
+    }
+    return read;
+}
+
+void glnet::Shm::acceptSockets()
+{
+    for (;;) {
+        Socket::Address addr = {0};
+        Socket::AddressLength addrLen = sizeof(addr);
+        Socket::Fd fd = INVALID_FD;
+
+        try {
+            fd = socket_.tryAccept(addr, addrLen);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return;
+        }
+        if (fd == INVALID_FD) {
+            return;
+        }
+        // The client registers once its memory arrives on the socket
+        pollFds_.push_back({.fd = fd, .events = POLLIN, .revents = 0});
+        polled_.push_back(nullptr);
+    }
+}
+
+bool glnet::Shm::registerClient(std::size_t pollIndex)
+{
+#ifdef _WIN32
+    return false;
+#else
+    Socket socket(pollFds_[pollIndex].fd);
+    Socket::Fd memory = INVALID_FD;
+
+    try {
+        std::uint8_t hello = 0;
+        std::optional<Socket::BytesReceived> bytesRead = socket.tryRecv(&hello, sizeof(hello), memory);
+
+        if (!bytesRead) {
+            return true;
+        }
+        if (*bytesRead <= 0 || memory == INVALID_FD) {
+            throw std::runtime_error("The client closed its connection or sent no shared memory");
+        }
+        std::shared_ptr<Link> link = std::make_shared<Link>();
+        struct stat status = {};
+
+        // The client may be faulty, so the memory is checked before its positions are trusted
+        if (::fstat(memory, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(Header)) {
+            throw std::runtime_error("The shared memory of the client is too small");
+        }
+        if ((::fcntl(memory, F_GET_SEALS) & F_SEAL_SHRINK) == 0) {
+            throw std::runtime_error("The shared memory of the client can shrink");
+        }
+        link->size = static_cast<std::size_t>(status.st_size);
+        link->memory = ::mmap(nullptr, link->size, PROT_READ | PROT_WRITE, MAP_SHARED, memory, 0);
+        Socket(memory).close();
+        memory = INVALID_FD;
+        if (link->memory == MAP_FAILED) {
+            link->memory = nullptr;
+            throw std::runtime_error(std::format("Couldn't map the shared memory of the client: {}.", std::strerror(errno)));
+        }
+        const Header *header = static_cast<const Header *>(link->memory);
+        std::size_t capacity = header->capacity;
+        std::uint8_t *rings = static_cast<std::uint8_t *>(link->memory) + sizeof(Header);
+
+        if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION) {
+            throw std::runtime_error("The shared memory of the client has an unknown layout");
+        }
+        if ((capacity & (capacity - 1)) != 0 || getMemorySize(capacity) != link->size) {
+            throw std::runtime_error(std::format("The shared memory of the client doesn't match its capacity of {} bytes", capacity));
+        }
+        link->inbound.attach(rings, capacity, false);
+        link->outbound.attach(rings + utils::ShmRing::getFootprint(capacity), capacity, false);
+        link->doorbell = socket.getFd();
+        meter_.onAccept();
+        polled_[pollIndex] = link;
+        registering_ = link;
+        // The clients share the path of the server, like the local clients
+        socket.setEndpoint(socket_.getEndpoint());
+        manager_.callbackHandler(Callback::Type::ON_CONNECTION, socket, connection::Type::SHM);
+        registering_ = nullptr;
+    } catch (const std::exception& e) {
+        if (memory != INVALID_FD) {
+            Socket(memory).close();
+        }
+        registering_ = nullptr;
+        std::cerr << e.what() << std::endl;
+        return polled_[pollIndex] != nullptr;
+    }
+    return true;
+#endif
+}
+
+bool glnet::Shm::readDoorbells(Socket::Fd fd)
+{
+    std::uint8_t doorbells[64];
+    Socket socket(fd);
+
+    try {
+        for (;;) {
+            std::optional<Socket::BytesReceived> bytesRead = socket.tryRecv(doorbells, sizeof(doorbells));
+
+            if (!bytesRead) {
+                return true;
+            }
+            if (*bytesRead <= 0) {
+                return false;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+    return false;
+}
+
+void glnet::Shm::disconnect(std::size_t pollIndex)
+{
+    std::shared_ptr<Link> link = polled_[pollIndex];
+    Socket::Fd fd = pollFds_[pollIndex].fd;
+
+    // The producers see the connection closed before its socket is, so none writes to a reused descriptor
+    if (link) {
+        {
+            std::scoped_lock lock(link->mutex);
+
+            link->closed = true;
+        }
+        {
+            std::unique_lock lock(linksMutex_);
+
+            links_.erase(link->clientId);
+        }
+        meter_.forget(link->clientId);
+    }
+    if (side_ == connection::Side::CLIENT) {
+        pollFds_[0].fd = INVALID_FD;
+        polled_[0] = nullptr;
+        return;
+    }
+    try {
+        if (link) {
+            manager_.getClientSocketBy<Socket::Fd>(fd).close();
+        } else {
+            Socket(fd).close();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+    pollFds_.erase(pollFds_.begin() + pollIndex);
+    polled_.erase(polled_.begin() + pollIndex);
+    if (link) {
+        manager_.callbackHandler(Callback::Type::ON_DISCONNECTION, link->clientId);
+    }
+}
+
+std::shared_ptr<glnet::Shm::Link> glnet::Shm::findLink(std::uint32_t clientId)
+{
+    std::shared_lock lock(linksMutex_);
+    auto link = links_.find(clientId);
+
+    return link != links_.end() ? link->second : nullptr;
+}
+
+std::size_t glnet::Shm::getMemorySize(std::size_t capacity)
+{
+    return sizeof(Header) + 2 * utils::ShmRing::getFootprint(capacity);
+}
@@ -3,105 +3,339 @@
 #include "Manager.hpp"
 #include "Protocol/Tcp.hpp"
 
+#include <algorithm>
+#include <filesystem>
 #include <iostream>
+#include <cstring>
+#include <limits>
+#include <format>
 #include <thread>
 
-glnet::Tcp::Tcp(Endpoint endpoint, connection::Side side) : side_(side), running_(true), socket_(connection::Type::TCP, endpoint)
+glnet::Tcp::Tcp(Manager& manager, Endpoint endpoint, connection::Side side, connection::Type type, connection::LocalMode localMode)
+    : manager_(manager), side_(side), type_(type), localMode_(localMode), running_(true), connecting_(false), socket_(type, endpoint, localMode), impairer_(true), wheel_(TIMER_RESOLUTION, std::chrono::steady_clock::now()),
+      now_(std::chrono::steady_clock::now()), heartbeatFrame_(std::make_shared<const std::vector<std::uint8_t>>(Packet().serialize()))
 {
-    Socket::Address_in addr = {0};
+    if (type_ == connection::Type::LOCAL && side_ == connection::Side::SERVER && !endpoint.address.empty()) {
+        Socket::Address_un addr = {};
+        Socket::AddressLength addrLen = Socket::localAddress(endpoint.address, addr);
 
-    addr.sin_family = AF_INET;
-    addr.sin_addr.s_addr = htonl(INADDR_ANY);
-    addr.sin_port = htons(endpoint.port);
-    if (endpoint != Endpoint{"", 0}) {
+        std::error_code error;
+
+        // The socket file left by a previous server would make the bind fail, a local client never binds
+        if (endpoint.address[0] != '@' && std::filesystem::is_socket(endpoint.address, error)) {
+            std::filesystem::remove(endpoint.address, error);
+        }
+        socket_.bind((Socket::Address&) addr, addrLen);
+        socket_.listen();
+        socket_.setBlocking(false);
+    } else if (type_ == connection::Type::TCP && endpoint != Endpoint{"", 0}) {
+        Socket::Address_in addr = {0};
+
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(endpoint.port);
         socket_.reuse();
         socket_.bind((Socket::Address&) addr, sizeof(addr));
         if (side_ == connection::Side::SERVER) {
             socket_.listen();
+            socket_.setBlocking(false);
+        }
+    }
+    if (type_ == connection::Type::LOCAL && localMode_ == connection::LocalMode::SEQPACKET) {
+        record_.resize(MAX_RECORD_SIZE);
+    }
+    // A server without an endpoint only serves the adopted sockets, its unbound socket must not be polled
+    bool listening = side_ == connection::Side::CLIENT || (type_ == connection::Type::LOCAL ? !endpoint.address.empty() : endpoint != Endpoint{"", 0});
+
+    pollFds_.push_back({.fd = listening ? socket_.getFd() : INVALID_FD, .events = POLLIN, .revents = 0});
+    pollFds_.push_back({.fd = wakeup_.getFd(), .events = POLLIN, .revents = 0});
+    polled_.resize(pollFds_.size());
+    scheduler_.setOnDiscard([this](const Outbound& outbound) {
+        auto backlog = backlogs_.find(outbound.clientId);
+
+        meter_.onDrop();
+        if (backlog != backlogs_.end()) {
+            release(outbound.clientId, *backlog->second, outbound.frame->size());
         }
+    });
+    hardLimitDeadline_ = std::chrono::steady_clock::time_point::max();
+    if (side_ == connection::Side::CLIENT) {
+        track(0);
     }
-    pollFds_.push_back({.fd = socket_.getFd(), .events = POLLIN, .revents = 0});
 }
 
 void glnet::Tcp::stop()
 {
     running_ = false;
+    wakeup_.notify();
 }
 
 void glnet::Tcp::run()
 {
     try {
-        Manager& manager = Manager::getInstance();
-
         while (running_) {
-            std::int32_t result = socket_.poll(pollFds_, pollFds_.size(), 0);
-
-            if (result > 0 && pollFds_.size() >= 1) {
-                if (pollFds_[0].revents & POLLIN) {
-                    if (side_ == connection::Side::SERVER) {
-                        acceptSocket();
-                    } else {
-                        readFromSocket(socket_);
-                    }
-                }
-                if (side_ == connection::Side::SERVER) {
-                    for (std::size_t i = 1; i < pollFds_.size(); i++) {
-                        if (pollFds_[i].revents & POLLHUP) {
-                            disconnectSocket(i);
-                            i--;
-                            continue;
-                        }
-                        if (pollFds_[i].revents & POLLIN) {
-                            if (!readFromSocket(manager.getClientSocketBy<Socket::Fd>(pollFds_[i].fd))) {
-                                disconnectSocket(i);
-                                i--;
-                            }
-                        }
-                    }
-                }
-            }
+            Socket::poll(pollFds_, pollFds_.size(), getTimeout());
+            process();
         }
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
 }
 
+void glnet::Tcp::process()
+{
+    now_ = std::chrono::steady_clock::now();
+    if (tracer_.isEnabled() != tracingApplied_) {
+        applyTracing();
+    }
+    impairer_.refresh();
+    if (side_ == connection::Side::SERVER && !adopted_.empty()) {
+        adoptSockets();
+    }
+    if (!delayedIn_.empty()) {
+        releaseInbound();
+    }
+    if (connecting_ && connectTimeout_ != 0 && !utils::TimingWheel::isArmed(connectTimer_)) {
+        connectTimer_.kind = static_cast<std::uint8_t>(TimerKind::CONNECT);
+        wheel_.schedule(connectTimer_, now_ + std::chrono::milliseconds(connectTimeout_));
+    }
+    if (connecting_ && pollFds_[0].revents & (POLLOUT | POLLERR | POLLHUP)) {
+        finishConnect();
+    } else if (pollFds_[0].revents & POLLIN) {
+        if (side_ == connection::Side::SERVER) {
+            acceptSockets();
+        } else if (!readFromSocket(socket_, 0)) {
+            wheel_.cancel(timers_[0].heartbeat);
+        }
+    }
+    if (side_ == connection::Side::CLIENT && !connecting_ && pollFds_[0].revents & POLLERR) {
+        readSendTimestamps(socket_, 0);
+    }
+    if (side_ == connection::Side::CLIENT && !connecting_ && pollFds_[0].revents & POLLOUT) {
+        resumeWrite(socket_, 0, 0);
+    }
+    if (side_ == connection::Side::SERVER) {
+        for (std::size_t i = FIRST_CLIENT_POLL_INDEX; i < pollFds_.size(); i++) {
+            if (pollFds_[i].revents & POLLHUP) {
+                disconnectSocket(i);
+                i--;
+                continue;
+            }
+            // The connection is kept next to its pollfd, a ready fd costs no search through the clients
+            Polled& polled = polled_[i];
+
+            if (!polled.socket) {
+                continue;
+            }
+            if (pollFds_[i].revents & POLLERR) {
+                readSendTimestamps(*polled.socket, polled.clientId);
+            }
+            if (pollFds_[i].revents & POLLOUT) {
+                resumeWrite(*polled.socket, polled.clientId, i);
+            }
+            if (pollFds_[i].revents & POLLIN) {
+                touchIdle(polled.clientId);
+                if (!readFromSocket(*polled.socket, polled.clientId)) {
+                    disconnectSocket(i);
+                    i--;
+                }
+            }
+        }
+    }
+    processTimers();
+    flushOutbound();
+    if (!broken_.empty()) {
+        disconnectBroken();
+    }
+}
+
+std::vector<glnet::Socket::PollFd>& glnet::Tcp::getPollFds()
+{
+    return pollFds_;
+}
+
+std::int32_t glnet::Tcp::getTimeout() const
+{
+    RateLimiter::Clock::time_point deadline = std::min({limiter_.getRetryDeadline(), hardLimitDeadline_, wheel_.getNextDeadline(), delayedIn_.getNextDeadline(), delayedOut_.getNextDeadline()});
+
+    if (deadline == RateLimiter::Clock::time_point::max()) {
+        return -1;
+    }
+    std::chrono::milliseconds remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - RateLimiter::Clock::now());
+
+    return static_cast<std::int32_t>(std::clamp<std::int64_t>(remaining.count(), 0, std::numeric_limits<std::int32_t>::max()));
+}
+
+glnet::RateLimiter& glnet::Tcp::getRateLimiter()
+{
+    return limiter_;
+}
+
+glnet::Impairer& glnet::Tcp::getImpairer()
+{
+    return impairer_;
+}
+
 void glnet::Tcp::connectToServer(const std::string& host, std::uint16_t port)
 {
     if (side_ != connection::Side::CLIENT) {
         return;
     }
     try {
-        Manager& manager = Manager::getInstance();
-        Socket::Address_in addr = {0};
+        socket_.setBlocking(false);
+        if (type_ == connection::Type::LOCAL) {
+            Socket::Address_un addr = {};
+            Socket::AddressLength addrLen = Socket::localAddress(host, addr);
 
-        addr.sin_family = AF_INET;
-        addr.sin_port = htons(port);
-        addr.sin_addr.s_addr = Socket::inetAddr(host.c_str());
-        socket_.connect((Socket::Address&) addr, sizeof(addr));
-        manager.callbackHandler(Callback::Type::ON_CONNECTION, socket_);
+            socket_.tryConnect((Socket::Address&) addr, addrLen);
+        } else {
+            Socket::Address_in addr = {0};
+
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(port);
+            addr.sin_addr.s_addr = Socket::inetAddr(host.c_str());
+            socket_.tryConnect((Socket::Address&) addr, sizeof(addr));
+        }
+        connecting_ = true;
+        pollFds_[0].events = POLLOUT;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        manager_.callbackHandler(Callback::Type::ON_CONNECTION_FAILURE, 0);
+    }
+}
+
+void glnet::Tcp::finishConnect()
+{
+    connecting_ = false;
+    pollFds_[0].events = POLLIN;
+    wheel_.cancel(connectTimer_);
+    try {
+        std::int32_t error = socket_.getPendingError();
+
+        if (error != 0) {
+            throw std::runtime_error(std::format("Couldn't connect to the address: {}.", std::strerror(error)));
+        }
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
+        manager_.callbackHandler(Callback::Type::ON_CONNECTION_FAILURE, 0);
+        return;
     }
+    touchHeartbeat(0);
+    manager_.callbackHandler(Callback::Type::ON_CONNECTION, socket_, type_);
 }
 
-void glnet::Tcp::acceptSocket()
+void glnet::Tcp::acceptSockets()
 {
     if (side_ != connection::Side::SERVER) {
         return;
     }
-    try {
-        Manager& manager = Manager::getInstance();
+    std::size_t budget = acceptsPerTick_;
+
+    for (std::size_t accepted = 0; budget == 0 || accepted < budget; accepted++) {
         Socket::Address addr = {0};
         Socket::AddressLength addrLen = sizeof(addr);
-        Socket socket = socket_.accept(addr, addrLen);
+        Socket::Fd fd = INVALID_FD;
 
-        pollFds_.push_back({.fd = socket.getFd(), .events = POLLIN, .revents = 0});
-        socket.setEndpoint({::inet_ntoa(((Socket::Address_in&) addr).sin_addr), ntohs(((Socket::Address_in&) addr).sin_port)});
-        manager.callbackHandler(Callback::Type::ON_CONNECTION, socket);
-    } catch (const std::exception& e) {
-        std::cerr << e.what() << std::endl;
+        try {
+            fd = socket_.tryAccept(addr, addrLen);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return;
+        }
+        if (fd == INVALID_FD) {
+            return;
+        }
+        // The local clients are unnamed, they are known by the path of the server
+        if (type_ == connection::Type::LOCAL) {
+            addClient(fd, socket_.getEndpoint());
+        } else {
+            addClient(fd, {::inet_ntoa(((Socket::Address_in&) addr).sin_addr), ntohs(((Socket::Address_in&) addr).sin_port)});
+        }
+    }
+}
+
+bool glnet::Tcp::adopt(Socket::Fd fd)
+{
+    if (side_ != connection::Side::SERVER || !adopted_.push(std::move(fd))) {
+        return false;
     }
+    wakeup_.notify();
+    return true;
+}
+
+void glnet::Tcp::adoptSockets()
+{
+    Socket::Fd fd = INVALID_FD;
+
+    while (adopted_.pop(fd)) {
+        Socket socket(fd);
+        Socket::Address_in addr = {0};
+        Socket::AddressLength addrLen = sizeof(addr);
+        Endpoint endpoint = socket_.getEndpoint();
+
+        try {
+            socket.setBlocking(false);
+            if (type_ == connection::Type::TCP) {
+                socket.getPeerName((Socket::Address&) addr, addrLen);
+                endpoint = {::inet_ntoa(addr.sin_addr), ntohs(addr.sin_port)};
+            }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            socket.close();
+            continue;
+        }
+        addClient(fd, endpoint);
+    }
+}
+
+void glnet::Tcp::addClient(Socket::Fd fd, Endpoint endpoint)
+{
+    Socket socket(fd);
+    std::size_t maxConnections = maxConnections_;
+
+    if (maxConnections != 0 && pollFds_.size() - FIRST_CLIENT_POLL_INDEX >= maxConnections) {
+        socket.close();
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    meter_.onAccept();
+    if (tracingApplied_ && type_ == connection::Type::TCP) {
+        try {
+            socket.setTimestamping(true);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+    pollFds_.push_back({.fd = fd, .events = POLLIN, .revents = 0});
+    polled_.emplace_back();
+    socket.setEndpoint(endpoint);
+    manager_.callbackHandler(Callback::Type::ON_CONNECTION, socket, type_);
+}
+
+void glnet::Tcp::setConnectionLimits(ConnectionLimits limits)
+{
+    maxConnections_ = limits.maxConnections;
+    acceptsPerTick_ = limits.acceptsPerTick;
+}
+
+std::uint64_t glnet::Tcp::getRejectedCount() const
+{
+    return rejected_.load(std::memory_order_relaxed);
+}
+
+glnet::TransportMetrics glnet::Tcp::getMetrics()
+{
+    TransportMetrics metrics = meter_.snapshot();
+    std::shared_lock lock(backlogsMutex_);
+
+    for (const auto& [clientId, backlog] : backlogs_) {
+        std::size_t queued = backlog->bytes;
+
+        metrics.total.queuedBytes += queued;
+        metrics.connections[clientId].queuedBytes = queued;
+    }
+    metrics.rejected = getRejectedCount();
+    return metrics;
 }
 
 void glnet::Tcp::disconnectSocket(std::size_t id)
@@ -110,73 +344,585 @@ void glnet::Tcp::disconnectSocket(std::size_t id)
         return;
     }
     try {
-        Manager& manager = Manager::getInstance();
-        Socket& socket = manager.getClientSocketBy<Socket::Fd>(pollFds_[id].fd);
+        std::shared_ptr<Socket> socket = polled_[id].socket;
+        std::uint32_t clientId = polled_[id].clientId;
+
+        {
+            std::unique_lock lock(backlogsMutex_);
+
+            backlogs_.erase(clientId);
+        }
+        congested_.erase(clientId);
+        auto inbound = inbound_.find(clientId);
 
-        manager.callbackHandler(Callback::Type::ON_DISCONNECTION, manager.getClientIdBy<Socket>(socket));
+        if (inbound != inbound_.end()) {
+            if (inbound->second.descriptor != INVALID_FD) {
+                Socket(inbound->second.descriptor).close();
+            }
+            inbound_.erase(inbound);
+        }
+        meter_.forget(clientId);
+        auto timers = timers_.find(clientId);
+
+        if (timers != timers_.end()) {
+            wheel_.cancel(timers->second.idle);
+            wheel_.cancel(timers->second.heartbeat);
+            timers_.erase(timers);
+        }
+        scheduler_.erase(clientId);
+        limiter_.erase(clientId);
+        impairer_.erase(clientId);
+        socket->close();
         pollFds_.erase(pollFds_.begin() + id);
+        polled_.erase(polled_.begin() + id);
+        manager_.callbackHandler(Callback::Type::ON_DISCONNECTION, clientId);
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
 }
 
-std::size_t glnet::Tcp::readHeader(Socket& socket, Packet& packet)
+bool glnet::Tcp::readFromSocket(Socket& socket, std::uint32_t clientId)
 {
-    std::size_t bytesRead = socket.recv(&packet.length, sizeof(packet.length), 0);
+    if (!running_) {
+        return false;
+    }
+    if (type_ == connection::Type::LOCAL && localMode_ == connection::LocalMode::SEQPACKET) {
+        return readRecords(socket, clientId);
+    }
+    Inbound& inbound = inbound_[clientId];
+    Meter::Counters& counters = meter_.track(clientId);
+
+    for (std::size_t frames = 0; frames < MAX_READ_BATCH;) {
+        Packet& packet = inbound.packet;
+        bool readingLength = inbound.received < sizeof(packet.length);
+        std::uint8_t *target = readingLength ? reinterpret_cast<std::uint8_t *>(&packet.length) + inbound.received : packet.bytes.data() + (inbound.received - sizeof(packet.length));
+        std::size_t wanted = readingLength ? sizeof(packet.length) - inbound.received : sizeof(packet.length) + packet.length - inbound.received;
+        std::optional<Socket::BytesReceived> bytesRead;
+        Socket::Timestamp kernelTime;
+        Socket::Fd descriptor = INVALID_FD;
 
-    if (bytesRead != sizeof(packet.length)) {
-        return 0;
+        try {
+            if (type_ == connection::Type::LOCAL) {
+                bytesRead = socket.tryRecv(target, wanted, descriptor);
+            } else {
+                bytesRead = tracingApplied_ ? socket.tryRecv(target, wanted, kernelTime) : socket.tryRecv(target, wanted);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return false;
+        }
+        // The reads never cross a frame, so a descriptor belongs to the frame being read
+        if (descriptor != INVALID_FD) {
+            if (inbound.descriptor != INVALID_FD) {
+                Socket(inbound.descriptor).close();
+            }
+            inbound.descriptor = descriptor;
+        }
+        if (!bytesRead) {
+            return true;
+        }
+        if (*bytesRead <= 0) {
+            return false;
+        }
+        counters.bytesIn.add(*bytesRead);
+        if (static_cast<std::size_t>(*bytesRead) < wanted) {
+            counters.partialReads.add();
+        }
+        if (tracingApplied_) {
+            if (inbound.received == 0) {
+                tracer_.onReceive(kernelTime);
+            }
+            readAt_ = Tracer::Clock::now();
+        }
+        inbound.received += *bytesRead;
+        if (readingLength && inbound.received == sizeof(packet.length)) {
+            packet.bytes.resize(packet.length);
+        }
+        if (inbound.received < sizeof(packet.length) || inbound.received < sizeof(packet.length) + packet.length) {
+            continue;
+        }
+        Packet complete = std::move(packet);
+        Socket::Fd received = inbound.descriptor;
+
+        inbound = Inbound();
+        frames++;
+        counters.packetsIn.add();
+        receive(clientId, complete, received);
     }
-    return bytesRead;
+    return true;
 }
 
-std::size_t glnet::Tcp::readBody(Socket& socket, Packet& packet)
+bool glnet::Tcp::readRecords(Socket& socket, std::uint32_t clientId)
 {
-    if (packet.length == 0) {
-        return 0;
-    }
-    packet.bytes.resize(packet.length);
-    std::uint8_t* buffer = packet.bytes.data();
+    Meter::Counters& counters = meter_.track(clientId);
 
-    std::size_t bytesRead = socket.recv(buffer, packet.length, 0);
+    for (std::size_t frames = 0; frames < MAX_READ_BATCH; frames++) {
+        std::optional<Socket::BytesReceived> bytesRead;
+        Socket::Fd descriptor = INVALID_FD;
+        Packet packet;
 
-    if (bytesRead != packet.length) {
-        return 0;
+        try {
+            bytesRead = socket.tryRecv(record_.data(), record_.size(), descriptor);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return false;
+        }
+        if (!bytesRead) {
+            return true;
+        }
+        if (*bytesRead <= 0) {
+            return false;
+        }
+        std::size_t size = static_cast<std::size_t>(*bytesRead);
+
+        counters.bytesIn.add(size);
+        if (tracingApplied_) {
+            readAt_ = Tracer::Clock::now();
+        }
+        if (size >= sizeof(packet.length)) {
+            std::memcpy(&packet.length, record_.data(), sizeof(packet.length));
+        }
+        if (size < sizeof(packet.length) || sizeof(packet.length) + packet.length != size) {
+            std::cerr << std::format("Malformed record of {} bytes from client {}, disconnecting it", size, clientId) << std::endl;
+            if (descriptor != INVALID_FD) {
+                Socket(descriptor).close();
+            }
+            return false;
+        }
+        packet.bytes.assign(record_.begin() + sizeof(packet.length), record_.begin() + size);
+        counters.packetsIn.add();
+        receive(clientId, packet, descriptor);
     }
-    return bytesRead;
+    return true;
 }
 
-bool glnet::Tcp::readFromSocket(Socket& socket)
+void glnet::Tcp::receive(std::uint32_t clientId, Packet& packet, Socket::Fd descriptor)
 {
-    if (!running_) {
-        return false;
+    // An empty frame is a heartbeat, unless it carries a descriptor
+    if (packet.length == 0 && descriptor == INVALID_FD) {
+        return;
+    }
+    if (impairer_.isActive(connection::Direction::INBOUND)) {
+        Impairer::Plan plan = impairer_.plan(connection::Direction::INBOUND, clientId, sizeof(packet.length) + packet.length, Impairer::Clock::now());
+
+        delayedIn_.push(plan.at[0], {.clientId = clientId, .packet = std::move(packet), .descriptor = descriptor});
+        return;
     }
+    deliver(clientId, packet, descriptor);
+}
+
+void glnet::Tcp::deliver(std::uint32_t clientId, Packet& packet, Socket::Fd descriptor)
+{
     try {
-        Manager& manager = Manager::getInstance();
-        Packet packet;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-        if (readHeader(socket, packet) == 0) {
-            return false;
+        if (descriptor != INVALID_FD) {
+            manager_.callbackHandler(Callback::Type::ON_DESCRIPTOR_RECEPTION, clientId, descriptor, packet);
+        } else {
+            manager_.callbackHandler(Callback::Type::ON_MESSAGE_RECEPTION, type_, clientId, packet);
         }
-        if (readBody(socket, packet) == 0 && packet.length != 0) {
-            return false;
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        meter_.onCallback(end - start);
+        if (tracingApplied_) {
+            tracer_.record(Tracer::Stage::DISPATCH, start - readAt_);
+            tracer_.record(Tracer::Stage::CALLBACK, end - start);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+void glnet::Tcp::releaseInbound()
+{
+    Impairer::Clock::time_point due = impairer_.isActive(connection::Direction::INBOUND) ? Impairer::Clock::now() : Impairer::Clock::time_point::max();
+    Received received;
+
+    while (delayedIn_.pop(due, received)) {
+        deliver(received.clientId, received.packet, received.descriptor);
+    }
+}
+
+void glnet::Tcp::releaseOutbound(Scheduler::Clock::time_point now)
+{
+    Impairer::Clock::time_point due = impairer_.isActive(connection::Direction::OUTBOUND) ? now : Impairer::Clock::time_point::max();
+    Outbound outbound;
+
+    while (!scheduler_.full() && delayedOut_.pop(due, outbound)) {
+        scheduler_.push(std::move(outbound));
+    }
+}
+
+glnet::connection::SendResult glnet::Tcp::enqueue(Outbound outbound)
+{
+    std::shared_ptr<Backlog> backlog = findBacklog(outbound.clientId);
+    std::size_t size = outbound.frame->size();
+
+    if (!backlog) {
+        meter_.onDrop();
+        return connection::SendResult::FAILED;
+    }
+    if (tracer_.isEnabled()) {
+        outbound.enqueuedAt = Tracer::Clock::now();
+    }
+    std::size_t queued = backlog->bytes.fetch_add(size) + size;
+
+    if (!outbound_.push(std::move(outbound))) {
+        backlog->bytes.fetch_sub(size);
+        meter_.onDrop();
+        return connection::SendResult::FAILED;
+    }
+    wakeup_.notify();
+    return queued > highWatermark_ ? connection::SendResult::CONGESTED : connection::SendResult::QUEUED;
+}
+
+void glnet::Tcp::setWatermarks(Watermarks watermarks)
+{
+    lowWatermark_ = watermarks.low;
+    highWatermark_ = watermarks.high;
+    hardLimit_ = watermarks.hardLimit;
+    hardLimitTimeout_ = watermarks.hardLimitTimeout.count();
+}
+
+void glnet::Tcp::track(std::uint32_t clientId)
+{
+    std::unique_lock lock(backlogsMutex_);
+
+    backlogs_[clientId] = std::make_shared<Backlog>();
+    if (side_ == connection::Side::SERVER) {
+        // Called from the connection callback of addClient, while the pollfd of the connection is the last one
+        polled_.back() = {.clientId = clientId, .socket = manager_.findClient(clientId)};
+        touchIdle(clientId);
+        touchHeartbeat(clientId);
+    }
+}
+
+void glnet::Tcp::flushOutbound()
+{
+    Scheduler::Clock::time_point now = Scheduler::Clock::now();
+    Outbound outbound;
+
+    wakeup_.clear();
+    limiter_.refresh();
+    if (connecting_) {
+        return;
+    }
+    // The held frames go first, so that a frame never overtakes an older one of its connection once the impairment is removed
+    if (!delayedOut_.empty()) {
+        releaseOutbound(now);
+    }
+    while (!scheduler_.full() && outbound_.pop(outbound)) {
+        std::uint32_t clientId = outbound.clientId;
+
+        if (impairer_.isActive(connection::Direction::OUTBOUND)) {
+            Impairer::Plan plan = impairer_.plan(connection::Direction::OUTBOUND, clientId, outbound.frame->size(), now);
+
+            delayedOut_.push(plan.at[0], std::move(outbound));
+        } else {
+            scheduler_.push(std::move(outbound));
+        }
+        checkCongestion(clientId);
+    }
+    if (!delayedOut_.empty()) {
+        releaseOutbound(now);
+    }
+    std::size_t written = 0;
+
+    for (; written < MAX_FLUSH_BATCH && scheduler_.pop(now, limiter_, outbound); written++) {
+        auto backlog = backlogs_.find(outbound.clientId);
+        std::shared_ptr<Socket> client = side_ == connection::Side::SERVER ? manager_.findClient(outbound.clientId) : nullptr;
+        Socket *socket = side_ == connection::Side::CLIENT ? &socket_ : client.get();
+
+        if (backlog == backlogs_.end() || !socket) {
+            continue;
+        }
+        if (outbound.enqueuedAt != Tracer::Clock::time_point{}) {
+            tracer_.record(Tracer::Stage::QUEUE, now - outbound.enqueuedAt);
+        }
+        backlog->second->partial = std::move(outbound.frame);
+        backlog->second->descriptor = std::move(outbound.descriptor);
+        backlog->second->offset = 0;
+        if (!writeBacklog(*socket, outbound.clientId, *backlog->second)) {
+            scheduler_.block(outbound.clientId);
+            setWriteInterest(socket->getFd(), true);
+        }
+    }
+    meter_.setQueuedFrames(scheduler_.size());
+    if (!congested_.empty()) {
+        enforceHardLimit(now);
+    }
+    if (!outbound_.empty() || written == MAX_FLUSH_BATCH) {
+        wakeup_.notify();
+    }
+}
+
+bool glnet::Tcp::writeBacklog(Socket& socket, std::uint32_t clientId, Backlog& backlog)
+{
+    std::size_t size = backlog.partial->size();
+    Meter::Counters& counters = meter_.track(clientId);
+
+    try {
+        while (backlog.offset < size) {
+            Socket::Timestamp writeTime = tracingApplied_ ? std::chrono::system_clock::now() : Socket::Timestamp();
+            Socket::Buffer buffer = (Socket::Buffer) (backlog.partial->data() + backlog.offset);
+            Socket::BytesSent sent = backlog.descriptor ? socket.trySend(buffer, size - backlog.offset, backlog.descriptor->getFd()) : socket.trySend(buffer, size - backlog.offset);
+
+            if (sent <= 0) {
+                return false;
+            }
+            // The descriptor travels with the first byte written, the local copy is closed once it is in flight
+            backlog.descriptor.reset();
+            counters.bytesOut.add(sent);
+            if (tracingApplied_) {
+                tracer_.onSent(backlog.sendLog, sent, true, writeTime);
+            }
+            backlog.offset += sent;
+            if (backlog.offset < size) {
+                counters.partialWrites.add();
+            }
         }
-        manager.callbackHandler(Callback::Type::ON_MESSAGE_RECEPTION, connection::Type::TCP, manager.getClientIdBy<Socket>(socket), packet);
     } catch (const std::exception& e) {
+        // Like a failed read, a failed write loses the connection, its frame being neither counted nor released
         std::cerr << e.what() << std::endl;
+        broken_.push_back(clientId);
+        return false;
     }
+    counters.packetsOut.add();
+    backlog.partial.reset();
+    backlog.descriptor.reset();
+    release(clientId, backlog, size);
+    touchHeartbeat(clientId);
     return true;
 }
 
-void glnet::Tcp::sendToSocket(Socket& socket, Packet& packet)
+void glnet::Tcp::resumeWrite(Socket& socket, std::uint32_t clientId, std::size_t pollIndex)
+{
+    auto backlog = backlogs_.find(clientId);
+
+    if (backlog != backlogs_.end() && backlog->second->partial && !writeBacklog(socket, clientId, *backlog->second)) {
+        return;
+    }
+    pollFds_[pollIndex].events &= ~POLLOUT;
+    scheduler_.unblock(clientId);
+}
+
+void glnet::Tcp::setWriteInterest(Socket::Fd fd, bool enable)
+{
+    for (Socket::PollFd& pollFd : pollFds_) {
+        if (pollFd.fd == fd) {
+            pollFd.events = enable ? (pollFd.events | POLLOUT) : (pollFd.events & ~POLLOUT);
+            return;
+        }
+    }
+}
+
+void glnet::Tcp::release(std::uint32_t clientId, Backlog& backlog, std::size_t size)
+{
+    std::size_t queued = backlog.bytes.fetch_sub(size) - size;
+
+    if (backlog.congested && queued <= lowWatermark_) {
+        backlog.congested = false;
+        backlog.overLimitSince = {};
+        congested_.erase(clientId);
+        manager_.callbackHandler(Callback::Type::ON_WRITABLE, clientId);
+    }
+}
+
+void glnet::Tcp::checkCongestion(std::uint32_t clientId)
 {
+    auto backlog = backlogs_.find(clientId);
+
+    if (backlog == backlogs_.end() || backlog->second->congested || backlog->second->bytes <= highWatermark_) {
+        return;
+    }
+    backlog->second->congested = true;
+    congested_.insert(clientId);
+    manager_.callbackHandler(Callback::Type::ON_BACKPRESSURE, clientId);
+}
+
+void glnet::Tcp::enforceHardLimit(std::chrono::steady_clock::time_point now)
+{
+    std::size_t hardLimit = hardLimit_;
+    std::chrono::milliseconds timeout(hardLimitTimeout_);
+    std::vector<std::uint32_t> dropped;
+
+    hardLimitDeadline_ = std::chrono::steady_clock::time_point::max();
+    if (hardLimit == 0 || side_ != connection::Side::SERVER) {
+        return;
+    }
+    for (std::uint32_t clientId : congested_) {
+        Backlog& backlog = *backlogs_[clientId];
+
+        if (backlog.bytes <= hardLimit) {
+            backlog.overLimitSince = {};
+            continue;
+        }
+        if (backlog.overLimitSince == std::chrono::steady_clock::time_point{}) {
+            backlog.overLimitSince = now;
+        }
+        if (now - backlog.overLimitSince >= timeout) {
+            dropped.push_back(clientId);
+        } else {
+            hardLimitDeadline_ = std::min(hardLimitDeadline_, backlog.overLimitSince + timeout);
+        }
+    }
+    for (std::uint32_t clientId : dropped) {
+        std::cerr << std::format("Client {} stayed above the hard limit of {} bytes for {} ms, disconnecting it", clientId, hardLimit, timeout.count()) << std::endl;
+        disconnectClient(clientId);
+    }
+}
+
+void glnet::Tcp::setTracing(bool enable)
+{
+    tracer_.setEnabled(enable);
+    wakeup_.notify();
+}
+
+glnet::Latency glnet::Tcp::getLatency() const
+{
+    return tracer_.getLatency();
+}
+
+void glnet::Tcp::applyTracing()
+{
+    bool enable = tracer_.isEnabled();
+
     try {
-        std::uint8_t buffer[sizeof(packet.length) + packet.length];
+        // The unix domain sockets have no kernel timestamps, only the stages of glnet are traced
+        if (side_ == connection::Side::CLIENT && type_ == connection::Type::TCP) {
+            socket_.setTimestamping(enable);
+        }
+        for (std::size_t i = FIRST_CLIENT_POLL_INDEX; side_ == connection::Side::SERVER && type_ == connection::Type::TCP && i < polled_.size(); i++) {
+            if (polled_[i].socket) {
+                polled_[i].socket->setTimestamping(enable);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+    for (auto& [clientId, backlog] : backlogs_) {
+        backlog->sendLog = Tracer::SendLog();
+    }
+    tracingApplied_ = enable;
+}
 
-        std::memcpy(buffer, &packet.length, sizeof(packet.length));
-        std::memcpy(buffer + sizeof(packet.length), packet.bytes.data(), packet.length);
-        socket.send(buffer, sizeof(packet.length) + packet.length, 0);
+void glnet::Tcp::readSendTimestamps(Socket& socket, std::uint32_t clientId)
+{
+    auto backlog = backlogs_.find(clientId);
+    Socket::Timestamp kernelTime;
+    std::uint32_t key = 0;
+
+    try {
+        while (socket.readSendTimestamp(key, kernelTime)) {
+            if (tracingApplied_ && backlog != backlogs_.end()) {
+                tracer_.onSendTimestamp(backlog->second->sendLog, key, kernelTime);
+            }
+        }
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
 }
+
+void glnet::Tcp::setTimeouts(Timeouts timeouts)
+{
+    idleTimeout_ = timeouts.idle.count();
+    heartbeatInterval_ = timeouts.heartbeat.count();
+    connectTimeout_ = timeouts.connect.count();
+}
+
+void glnet::Tcp::touchIdle(std::uint32_t clientId)
+{
+    std::int64_t timeout = idleTimeout_;
+    utils::TimingWheel::Timer& timer = timers_[clientId].idle;
+
+    if (timeout == 0) {
+        wheel_.cancel(timer);
+        return;
+    }
+    timer.id = clientId;
+    timer.kind = static_cast<std::uint8_t>(TimerKind::IDLE);
+    wheel_.schedule(timer, now_ + std::chrono::milliseconds(timeout));
+}
+
+void glnet::Tcp::touchHeartbeat(std::uint32_t clientId)
+{
+    std::int64_t interval = heartbeatInterval_;
+    utils::TimingWheel::Timer& timer = timers_[clientId].heartbeat;
+
+    if (interval == 0) {
+        wheel_.cancel(timer);
+        return;
+    }
+    timer.id = clientId;
+    timer.kind = static_cast<std::uint8_t>(TimerKind::HEARTBEAT);
+    wheel_.schedule(timer, now_ + std::chrono::milliseconds(interval));
+}
+
+void glnet::Tcp::processTimers()
+{
+    expiredTimers_.clear();
+    wheel_.advance(now_, expiredTimers_);
+    if (expiredTimers_.empty()) {
+        return;
+    }
+    expiredKinds_.clear();
+    for (utils::TimingWheel::Timer *timer : expiredTimers_) {
+        expiredKinds_.emplace_back(timer->id, static_cast<TimerKind>(timer->kind));
+    }
+    for (auto [clientId, kind] : expiredKinds_) {
+        switch (kind) {
+            case TimerKind::IDLE:
+                if (timers_.contains(clientId)) {
+                    std::cerr << std::format("Client {} sent nothing for {} ms, disconnecting it", clientId, idleTimeout_.load()) << std::endl;
+                    disconnectClient(clientId);
+                }
+                break;
+            case TimerKind::HEARTBEAT:
+                if (timers_.contains(clientId)) {
+                    enqueue({.clientId = clientId, .frame = heartbeatFrame_, .priority = connection::Priority::CONTROL});
+                    touchHeartbeat(clientId);
+                }
+                break;
+            case TimerKind::CONNECT:
+                if (connecting_) {
+                    connecting_ = false;
+                    pollFds_[0].events = POLLIN;
+                    std::cerr << std::format("Couldn't connect to the server within {} ms", connectTimeout_.load()) << std::endl;
+                    manager_.callbackHandler(Callback::Type::ON_CONNECTION_FAILURE, 0);
+                }
+                break;
+        }
+    }
+}
+
+void glnet::Tcp::disconnectClient(std::uint32_t clientId)
+{
+    std::shared_ptr<Socket> socket = manager_.findClient(clientId);
+
+    for (std::size_t i = FIRST_CLIENT_POLL_INDEX; socket && i < pollFds_.size(); i++) {
+        if (pollFds_[i].fd == socket->getFd()) {
+            disconnectSocket(i);
+            return;
+        }
+    }
+}
+
+void glnet::Tcp::disconnectBroken()
+{
+    for (std::uint32_t clientId : broken_) {
+        if (side_ == connection::Side::SERVER) {
+            disconnectClient(clientId);
+        } else {
+            wheel_.cancel(timers_[0].heartbeat);
+        }
+    }
+    broken_.clear();
+}
+
+std::shared_ptr<glnet::Tcp::Backlog> glnet::Tcp::findBacklog(std::uint32_t clientId)
+{
+    std::shared_lock lock(backlogsMutex_);
+    auto backlog = backlogs_.find(clientId);
+
+    return backlog != backlogs_.end() ? backlog->second : nullptr;
+}
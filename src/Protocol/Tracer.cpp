@@ -0,0 +1,60 @@
+#include "Protocol/Tracer.hpp"
+
+#include <algorithm>
+
+void glnet::Tracer::setEnabled(bool enable)
+{
+    enabled_.store(enable, std::memory_order_relaxed);
+}
+
+bool glnet::Tracer::isEnabled() const
+{
+    return enabled_.load(std::memory_order_relaxed);
+}
+
+void glnet::Tracer::record(Stage stage, std::chrono::nanoseconds latency)
+{
+    histograms_[static_cast<std::size_t>(stage)].record(static_cast<std::uint64_t>(std::max<std::int64_t>(latency.count(), 0)));
+}
+
+void glnet::Tracer::onReceive(Socket::Timestamp kernelTime)
+{
+    if (kernelTime == Socket::Timestamp{}) {
+        return;
+    }
+    record(Stage::KERNEL_RECEIVE, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now() - kernelTime));
+}
+
+void glnet::Tracer::onSent(SendLog& log, std::size_t bytes, bool stream, Socket::Timestamp writeTime)
+{
+    std::uint32_t key = stream ? log.next + static_cast<std::uint32_t>(bytes) - 1 : log.next;
+
+    log.next += stream ? static_cast<std::uint32_t>(bytes) : 1;
+    if (log.pending.size() == MAX_PENDING_SENDS) {
+        log.pending.pop_front();
+    }
+    log.pending.emplace_back(key, writeTime);
+}
+
+void glnet::Tracer::onSendTimestamp(SendLog& log, std::uint32_t key, Socket::Timestamp kernelTime)
+{
+    while (!log.pending.empty() && static_cast<std::int32_t>(log.pending.front().first - key) < 0) {
+        log.pending.pop_front();
+    }
+    if (log.pending.empty() || log.pending.front().first != key) {
+        return;
+    }
+    record(Stage::KERNEL_SEND, std::chrono::duration_cast<std::chrono::nanoseconds>(kernelTime - log.pending.front().second));
+    log.pending.pop_front();
+}
+
+glnet::Latency glnet::Tracer::getLatency() const
+{
+    return {
+        .kernelReceive = histograms_[static_cast<std::size_t>(Stage::KERNEL_RECEIVE)].getStats(),
+        .dispatch = histograms_[static_cast<std::size_t>(Stage::DISPATCH)].getStats(),
+        .callback = histograms_[static_cast<std::size_t>(Stage::CALLBACK)].getStats(),
+        .queue = histograms_[static_cast<std::size_t>(Stage::QUEUE)].getStats(),
+        .kernelSend = histograms_[static_cast<std::size_t>(Stage::KERNEL_SEND)].getStats(),
+    };
+}
@@ -3,9 +3,11 @@
 #include "Protocol/Udp.hpp"
 #include "Utils/Converter.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 
-glnet::Udp::Udp(Endpoint endpoint, connection::Side side) : side_(side), running_(true), socket_(connection::Type::UDP, endpoint)
+glnet::Udp::Udp(Manager& manager, Endpoint endpoint, connection::Side side) : manager_(manager), side_(side), running_(true), socket_(connection::Type::UDP, endpoint), impairer_(false)
 {
     Socket::Address_in addr = {0};
 
@@ -17,77 +19,750 @@ glnet::Udp::Udp(Endpoint endpoint, connection::Side side) : side_(side), running
         socket_.bind((Socket::Address&) addr, sizeof(addr));
     }
     pollFds_.push_back({.fd = socket_.getFd(), .events = POLLIN, .revents = 0});
+    pollFds_.push_back({.fd = wakeup_.getFd(), .events = POLLIN, .revents = 0});
+    receiveBuffer_.resize(MAX_RECEIVE_SIZE);
+    scheduler_.setOnDiscard([this](const Outbound& outbound) {
+        if (outbound.delivery == connection::Delivery::RELIABLE_ORDERED) {
+            release(channelKey(outbound.clientId, outbound.channel), 1);
+        }
+        meter_.onDrop();
+    });
 }
 
 void glnet::Udp::stop()
 {
     running_ = false;
+    wakeup_.notify();
 }
 
 void glnet::Udp::run()
 {
     try {
         while (running_) {
-            std::int32_t result = socket_.poll(pollFds_, pollFds_.size(), 0);
-
-            if (result > 0 && pollFds_.size() >= 1) {
-                if (pollFds_[0].revents & POLLIN) {
-                    readFromSocket();
-                }
-            }
+            Socket::poll(pollFds_, pollFds_.size(), getTimeout());
+            process();
         }
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
 }
 
-std::size_t glnet::Udp::readDatagram(Socket::Address& addr, Socket::AddressLength& len, Packet& packet)
+void glnet::Udp::process()
+{
+    if (tracer_.isEnabled() != tracingApplied_) {
+        applyTracing();
+    }
+    impairer_.refresh();
+    if (!delayedIn_.empty() || !delayedOut_.empty()) {
+        releaseDelayed();
+    }
+    if (pollFds_[0].revents & POLLERR) {
+        readSendTimestamps();
+    }
+    if (pollFds_[0].revents & POLLIN) {
+        readFromSocket();
+    }
+    flushOutbound();
+    transmit();
+    sendAcks();
+    if (!congestion_.empty() || adaptiveApplied_ != adaptiveRate_) {
+        updateCongestion(Reliability::Clock::now());
+    }
+    if (!reassemblies_.empty()) {
+        expireReassemblies(Reliability::Clock::now());
+    }
+}
+
+std::vector<glnet::Socket::PollFd>& glnet::Udp::getPollFds()
+{
+    return pollFds_;
+}
+
+std::int32_t glnet::Udp::getTimeout() const
+{
+    Reliability::Clock::time_point deadline = Reliability::Clock::time_point::max();
+
+    for (const auto& [key, channel] : channels_) {
+        deadline = std::min(deadline, channel.getNextDeadline());
+    }
+    deadline = std::min({deadline, limiter_.getRetryDeadline(), delayedIn_.getNextDeadline(), delayedOut_.getNextDeadline()});
+    if (deadline == Reliability::Clock::time_point::max()) {
+        return -1;
+    }
+    std::chrono::milliseconds remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - Reliability::Clock::now());
+
+    return static_cast<std::int32_t>(std::clamp<std::int64_t>(remaining.count(), 0, std::numeric_limits<std::int32_t>::max()));
+}
+
+glnet::Impairer& glnet::Udp::getImpairer()
 {
-    std::vector<std::uint8_t> buffer(1024);
-    std::size_t bytesRead = socket_.recvFrom(buffer.data(), buffer.size(), 0, addr, len);
+    return impairer_;
+}
+
+glnet::RateLimiter& glnet::Udp::getRateLimiter()
+{
+    return limiter_;
+}
 
-    if (bytesRead < 5) {
-        return 0;
+void glnet::Udp::setAdaptiveRate(bool enable)
+{
+    adaptiveRate_ = enable;
+    wakeup_.notify();
+}
+
+std::optional<glnet::PathStats> glnet::Udp::getPathStats(std::uint32_t clientId)
+{
+    std::scoped_lock lock(statsMutex_);
+    auto stats = stats_.find(clientId);
+
+    if (stats == stats_.end()) {
+        return std::nullopt;
     }
-    std::memcpy(&packet.length, buffer.data(), sizeof(packet.length));
-    packet.bytes = std::vector(buffer.begin() + sizeof(packet.length), buffer.begin() + sizeof(packet.length) + packet.length);
-    return bytesRead;
+    return stats->second;
+}
+
+glnet::TransportMetrics glnet::Udp::getMetrics() const
+{
+    return meter_.snapshot();
+}
+
+void glnet::Udp::setTracing(bool enable)
+{
+    tracer_.setEnabled(enable);
+    wakeup_.notify();
+}
+
+glnet::Latency glnet::Udp::getLatency() const
+{
+    return tracer_.getLatency();
+}
+
+void glnet::Udp::forget(std::uint32_t clientId)
+{
+    {
+        std::scoped_lock lock(forgottenMutex_);
+
+        forgotten_.push_back(clientId);
+    }
+    wakeup_.notify();
+}
+
+std::size_t glnet::Udp::readDatagram(Socket::Address& addr, Socket::AddressLength& len)
+{
+    Socket::Timestamp kernelTime;
+    std::size_t bytesRead = tracingApplied_ ? socket_.recvFrom(receiveBuffer_.data(), receiveBuffer_.size(), addr, len, kernelTime) : socket_.recvFrom(receiveBuffer_.data(), receiveBuffer_.size(), 0, addr, len);
+
+    if (tracingApplied_) {
+        tracer_.onReceive(kernelTime);
+        readAt_ = Tracer::Clock::now();
+    }
+    return bytesRead < sizeof(Header) ? 0 : bytesRead;
+}
+
+bool glnet::Udp::readPacket(const std::uint8_t *data, std::size_t size, Packet& packet)
+{
+    if (size < sizeof(packet.length)) {
+        return false;
+    }
+    std::memcpy(&packet.length, data, sizeof(packet.length));
+    if (packet.length != size - sizeof(packet.length)) {
+        return false;
+    }
+    packet.bytes.assign(data + sizeof(packet.length), data + size);
+    return true;
+}
+
+bool glnet::Udp::reassemble(std::uint32_t clientId, const std::uint8_t *data, std::size_t size, std::vector<std::uint8_t>& message)
+{
+    FragmentHeader fragment = {0};
+
+    if (size < sizeof(FragmentHeader)) {
+        return false;
+    }
+    std::memcpy(&fragment, data, sizeof(FragmentHeader));
+    data += sizeof(FragmentHeader);
+    size -= sizeof(FragmentHeader);
+    bool last = fragment.index + 1 == fragment.count;
+
+    if (fragment.count < 2 || fragment.count > MAX_FRAGMENTS || fragment.index >= fragment.count || size > MAX_FRAGMENT_PAYLOAD || (!last && size != MAX_FRAGMENT_PAYLOAD)) {
+        return false;
+    }
+    Reliability::Clock::time_point now = Reliability::Clock::now();
+    std::uint64_t key = (static_cast<std::uint64_t>(clientId) << 16) | fragment.messageId;
+    auto it = reassemblies_.find(key);
+
+    if (it == reassemblies_.end()) {
+        expireReassemblies(now);
+        auto count = reassemblyCounts_.find(clientId);
+
+        // A peer cannot hold more than its share of the table: its stalest frame, often a duplicate of a delivered one, makes room
+        if (count != reassemblyCounts_.end() && count->second >= MAX_REASSEMBLIES_PER_PEER) {
+            evictReassembly(clientId);
+        }
+        // The global bound only caps the memory of many peers
+        if (reassemblies_.size() >= MAX_REASSEMBLIES) {
+            meter_.onDrop();
+            return false;
+        }
+        reassemblyCounts_[clientId]++;
+        it = reassemblies_.try_emplace(key).first;
+        it->second.bytes.resize(fragment.count * MAX_FRAGMENT_PAYLOAD);
+        it->second.received.assign(fragment.count, false);
+        it->second.count = fragment.count;
+    }
+    Reassembly& reassembly = it->second;
+
+    if (reassembly.count != fragment.count || reassembly.received[fragment.index]) {
+        return false;
+    }
+    // A retransmitted frame keeps its id, so its fragments fill the gaps left by the previous attempts
+    std::memcpy(reassembly.bytes.data() + fragment.index * MAX_FRAGMENT_PAYLOAD, data, size);
+    reassembly.updatedAt = now;
+    reassembly.received[fragment.index] = true;
+    reassembly.receivedCount++;
+    if (last) {
+        reassembly.size = fragment.index * MAX_FRAGMENT_PAYLOAD + size;
+    }
+    if (reassembly.receivedCount != reassembly.count) {
+        return false;
+    }
+    reassembly.bytes.resize(reassembly.size);
+    message = std::move(reassembly.bytes);
+    releaseReassembly(key);
+    reassemblies_.erase(it);
+    return true;
+}
+
+void glnet::Udp::evictReassembly(std::uint32_t clientId)
+{
+    auto stalest = reassemblies_.end();
+
+    for (auto it = reassemblies_.begin(); it != reassemblies_.end(); it++) {
+        if ((it->first >> 16) == clientId && (stalest == reassemblies_.end() || it->second.updatedAt < stalest->second.updatedAt)) {
+            stalest = it;
+        }
+    }
+    if (stalest != reassemblies_.end()) {
+        releaseReassembly(stalest->first);
+        reassemblies_.erase(stalest);
+        meter_.onDrop();
+    }
+}
+
+void glnet::Udp::releaseReassembly(std::uint64_t key)
+{
+    auto count = reassemblyCounts_.find(static_cast<std::uint32_t>(key >> 16));
+
+    if (count != reassemblyCounts_.end() && --count->second == 0) {
+        reassemblyCounts_.erase(count);
+    }
+}
+
+void glnet::Udp::expireReassemblies(Reliability::Clock::time_point now)
+{
+    std::erase_if(reassemblies_, [this, now](const auto& entry) {
+        if (now - entry.second.updatedAt < REASSEMBLY_TIMEOUT) {
+            return false;
+        }
+        releaseReassembly(entry.first);
+        return true;
+    });
 }
 
 void glnet::Udp::readFromSocket()
 {
     try {
-        Manager& manager = Manager::getInstance();
         Socket::Address addr = {0};
         Socket::AddressLength len = sizeof(addr);
         Endpoint endpoint = {.address = "", .port = 0};
-        Packet packet;
+        std::size_t bytesRead = readDatagram(addr, len);
 
-        if (readDatagram(addr, len, packet) == 0) {
+        if (bytesRead == 0) {
+            meter_.onDrop();
             return;
         }
         endpoint.address = ::inet_ntoa(((Socket::Address_in&) addr).sin_addr);
         endpoint.port = ntohs(((Socket::Address_in&) addr).sin_port);
-        manager.callbackHandler(Callback::Type::ON_MESSAGE_RECEPTION, connection::Type::UDP, manager.getClientIdBy<Endpoint>(endpoint), packet);
+        std::uint32_t clientId = manager_.getClientIdBy<Endpoint>(endpoint);
+        Meter::Counters& counters = meter_.track(clientId);
+
+        counters.bytesIn.add(bytesRead);
+        counters.packetsIn.add();
+        if (impairer_.isActive(connection::Direction::INBOUND)) {
+            Impairer::Plan plan = impairer_.plan(connection::Direction::INBOUND, clientId, bytesRead, Impairer::Clock::now());
+
+            for (std::size_t copy = 0; copy < plan.copies; copy++) {
+                delayedIn_.push(plan.at[copy], {clientId, {}, std::vector<std::uint8_t>(receiveBuffer_.data(), receiveBuffer_.data() + bytesRead)});
+            }
+            return;
+        }
+        handleDatagram(clientId, receiveBuffer_.data(), bytesRead);
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
 }
 
-void glnet::Udp::sendToEndpoint(Endpoint endpoint, Packet& packet)
+void glnet::Udp::handleDatagram(std::uint32_t clientId, const std::uint8_t *data, std::size_t size)
+{
+    Header header = {0};
+    Packet packet;
+
+    std::memcpy(&header, data, sizeof(Header));
+    std::uint64_t key = channelKey(clientId, header.channel);
+
+    if (header.flags & FLAG_ACK) {
+        auto channel = channels_.find(key);
+
+        if (channel != channels_.end()) {
+            Reliability::Clock::time_point now = Reliability::Clock::now();
+            std::size_t pending = channel->second.getPendingCount();
+            std::chrono::microseconds sample = channel->second.acknowledge(header.ack, header.ackBits, now);
+
+            release(key, pending - channel->second.getPendingCount());
+            if (sample.count() != 0) {
+                getCongestion(clientId).onRtt(sample, now);
+            }
+        }
+    }
+    if (header.flags & FLAG_ACK_ONLY) {
+        return;
+    }
+    const std::uint8_t *payload = data + sizeof(Header);
+    std::size_t payloadSize = size - sizeof(Header);
+
+    if (header.flags & FLAG_FRAGMENT) {
+        if (!reassemble(clientId, payload, payloadSize, reassembled_)) {
+            return;
+        }
+        payload = reassembled_.data();
+        payloadSize = reassembled_.size();
+    }
+    if (!readPacket(payload, payloadSize, packet)) {
+        meter_.onDrop();
+        return;
+    }
+    if (static_cast<connection::Delivery>(header.delivery) == connection::Delivery::UNRELIABLE_SEQUENCED) {
+        Sequenced& sequenced = sequenced_[key];
+
+        if (sequenced.received && !Reliability::isNewer(header.sequence, sequenced.lastReceived)) {
+            return;
+        }
+        sequenced.received = true;
+        sequenced.lastReceived = header.sequence;
+    }
+    if (static_cast<connection::Delivery>(header.delivery) != connection::Delivery::RELIABLE_ORDERED) {
+        deliver(clientId, packet);
+        return;
+    }
+    delivered_.clear();
+    getChannel(clientId, header.channel).receive(header.sequence, std::move(packet), delivered_);
+    ackPending_.insert(key);
+    for (Packet& message : delivered_) {
+        deliver(clientId, message);
+    }
+}
+
+void glnet::Udp::releaseDelayed()
+{
+    Impairer::Clock::time_point now = Impairer::Clock::now();
+    Impairer::Clock::time_point inboundDue = impairer_.isActive(connection::Direction::INBOUND) ? now : Impairer::Clock::time_point::max();
+    Impairer::Clock::time_point outboundDue = impairer_.isActive(connection::Direction::OUTBOUND) ? now : Impairer::Clock::time_point::max();
+    Delayed delayed;
+
+    while (delayedIn_.pop(inboundDue, delayed)) {
+        try {
+            handleDatagram(delayed.clientId, delayed.bytes.data(), delayed.bytes.size());
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+    while (delayedOut_.pop(outboundDue, delayed)) {
+        // The peer may have disconnected while its datagram was held
+        if (side_ == connection::Side::SERVER && !manager_.findClient(delayed.clientId)) {
+            continue;
+        }
+        writeDatagram(delayed.endpoint, delayed.bytes, meter_.track(delayed.clientId));
+    }
+}
+
+bool glnet::Udp::enqueue(Outbound outbound)
+{
+    if (outbound.frame && tracer_.isEnabled()) {
+        outbound.enqueuedAt = Tracer::Clock::now();
+    }
+    if (!outbound.frame || outbound.frame->size() > MAX_MESSAGE_SIZE) {
+        meter_.onDrop();
+        return false;
+    }
+    // A reliable message is counted before it is queued, so the producer learns the channel is full instead of the udp thread dropping it
+    bool reliable = outbound.delivery == connection::Delivery::RELIABLE_ORDERED;
+    std::uint64_t key = channelKey(outbound.clientId, outbound.channel);
+
+    if (reliable && !reserve(key)) {
+        meter_.onDrop();
+        return false;
+    }
+    if (!outbound_.push(std::move(outbound))) {
+        if (reliable) {
+            release(key, 1);
+        }
+        meter_.onDrop();
+        return false;
+    }
+    wakeup_.notify();
+    return true;
+}
+
+void glnet::Udp::flushOutbound()
+{
+    Scheduler::Clock::time_point now = Scheduler::Clock::now();
+    Outbound outbound;
+    Endpoint endpoint;
+
+    wakeup_.clear();
+    limiter_.refresh();
+    while (!scheduler_.full() && outbound_.pop(outbound)) {
+        scheduler_.push(std::move(outbound));
+    }
+    dropForgotten();
+    std::size_t written = 0;
+
+    for (; written < MAX_FLUSH_BATCH && scheduler_.pop(now, limiter_, outbound); written++) {
+        Header header = {.delivery = static_cast<std::uint8_t>(outbound.delivery), .channel = outbound.channel};
+
+        if (!resolveEndpoint(outbound.clientId, endpoint)) {
+            if (outbound.delivery == connection::Delivery::RELIABLE_ORDERED) {
+                dropBacklog(channelKey(outbound.clientId, outbound.channel));
+            }
+            continue;
+        }
+        if (outbound.enqueuedAt != Tracer::Clock::time_point{}) {
+            tracer_.record(Tracer::Stage::QUEUE, now - outbound.enqueuedAt);
+        }
+        if (outbound.delivery == connection::Delivery::UNRELIABLE_SEQUENCED) {
+            header.sequence = sequenced_[channelKey(outbound.clientId, outbound.channel)].nextSequence++;
+        }
+        if (outbound.delivery == connection::Delivery::RELIABLE_ORDERED) {
+            getChannel(outbound.clientId, outbound.channel).send(outbound.frame, takeMessageId(outbound.frame));
+            continue;
+        }
+        sendDatagram(outbound.clientId, endpoint, header, outbound.frame, takeMessageId(outbound.frame));
+    }
+    meter_.setQueuedFrames(scheduler_.size());
+    if (!outbound_.empty() || written == MAX_FLUSH_BATCH) {
+        wakeup_.notify();
+    }
+}
+
+void glnet::Udp::transmit()
+{
+    Reliability::Clock::time_point now = Reliability::Clock::now();
+    Endpoint endpoint;
+
+    for (auto it = channels_.begin(); it != channels_.end();) {
+        std::uint32_t clientId = static_cast<std::uint32_t>(it->first >> 8);
+        std::uint8_t channel = static_cast<std::uint8_t>(it->first & 0xFF);
+
+        transmitted_.clear();
+        it->second.collectSendable(now, transmitted_);
+        it->second.collectExpired(now, transmitted_);
+        if (transmitted_.empty()) {
+            it++;
+            continue;
+        }
+        if (!resolveEndpoint(clientId, endpoint)) {
+            dropBacklog(it->first);
+            ackPending_.erase(it->first);
+            it = channels_.erase(it);
+            continue;
+        }
+        CongestionControl& congestion = getCongestion(clientId);
+
+        for (const Reliability::Pending *pending : transmitted_) {
+            Header header = {.delivery = static_cast<std::uint8_t>(connection::Delivery::RELIABLE_ORDERED), .channel = channel, .sequence = pending->sequence};
+
+            congestion.onTransmission(pending->transmissions > 1);
+            sendDatagram(clientId, endpoint, header, pending->frame, pending->messageId);
+        }
+        it++;
+    }
+}
+
+void glnet::Udp::sendAcks()
+{
+    Endpoint endpoint;
+
+    while (!ackPending_.empty()) {
+        std::uint64_t key = *ackPending_.begin();
+        std::uint32_t clientId = static_cast<std::uint32_t>(key >> 8);
+        Header header = {.delivery = static_cast<std::uint8_t>(connection::Delivery::RELIABLE_ORDERED), .channel = static_cast<std::uint8_t>(key & 0xFF), .flags = FLAG_ACK_ONLY};
+
+        ackPending_.erase(key);
+        if (resolveEndpoint(clientId, endpoint)) {
+            sendDatagram(clientId, endpoint, header, nullptr);
+        }
+    }
+}
+
+glnet::CongestionControl& glnet::Udp::getCongestion(std::uint32_t clientId)
+{
+    return congestion_.try_emplace(clientId, Reliability::Clock::now()).first->second;
+}
+
+void glnet::Udp::updateCongestion(Reliability::Clock::time_point now)
+{
+    bool enforce = adaptiveRate_;
+
+    if (adaptiveApplied_ && !enforce) {
+        limiter_.clearAdaptiveLimits();
+    }
+    for (auto& [clientId, congestion] : congestion_) {
+        if (!congestion.update(now) && adaptiveApplied_ == enforce) {
+            continue;
+        }
+        if (enforce) {
+            limiter_.setAdaptiveLimit(clientId, congestion.getLimit());
+        }
+        std::scoped_lock lock(statsMutex_);
+
+        stats_[clientId] = congestion.getStats();
+    }
+    adaptiveApplied_ = enforce;
+}
+
+void glnet::Udp::dropForgotten()
+{
+    {
+        std::scoped_lock lock(forgottenMutex_);
+
+        dropping_.swap(forgotten_);
+    }
+    for (std::uint32_t clientId : dropping_) {
+        scheduler_.erase(clientId);
+        limiter_.erase(clientId);
+        dropPeer(clientId);
+    }
+    dropping_.clear();
+}
+
+void glnet::Udp::dropPeer(std::uint32_t clientId)
+{
+    auto isPeer = [clientId](std::uint64_t key) {
+        return (key >> 8) == clientId;
+    };
+
+    std::erase_if(channels_, [&isPeer](const auto& entry) { return isPeer(entry.first); });
+    std::erase_if(sequenced_, [&isPeer](const auto& entry) { return isPeer(entry.first); });
+    std::erase_if(ackPending_, isPeer);
+    std::erase_if(reassemblies_, [clientId](const auto& entry) { return (entry.first >> 16) == clientId; });
+    reassemblyCounts_.erase(clientId);
+    congestion_.erase(clientId);
+    impairer_.erase(clientId);
+    meter_.forget(clientId);
+    {
+        std::unique_lock lock(backlogsMutex_);
+
+        std::erase_if(backlogs_, [&isPeer](const auto& entry) { return isPeer(entry.first); });
+    }
+    std::scoped_lock lock(statsMutex_);
+
+    stats_.erase(clientId);
+}
+
+bool glnet::Udp::reserve(std::uint64_t key)
+{
+    // The counter is only touched under the lock, as dropping the peer erases it
+    auto count = [](std::atomic<std::size_t>& backlog) {
+        if (backlog.fetch_add(1) >= Reliability::MAX_PENDING) {
+            backlog.fetch_sub(1);
+            return false;
+        }
+        return true;
+    };
+
+    {
+        std::shared_lock lock(backlogsMutex_);
+        auto entry = backlogs_.find(key);
+
+        if (entry != backlogs_.end()) {
+            return count(*entry->second);
+        }
+    }
+    // A channel is only created for a known peer, the map outliving it otherwise; a peer dropped meanwhile is cleaned up when its frames fail to resolve
+    if (side_ == connection::Side::SERVER && !manager_.findClient(static_cast<std::uint32_t>(key >> 8))) {
+        return false;
+    }
+    std::unique_lock lock(backlogsMutex_);
+    std::unique_ptr<std::atomic<std::size_t>>& entry = backlogs_[key];
+
+    if (!entry) {
+        entry = std::make_unique<std::atomic<std::size_t>>(0);
+    }
+    return count(*entry);
+}
+
+void glnet::Udp::dropBacklog(std::uint64_t key)
+{
+    std::unique_lock lock(backlogsMutex_);
+
+    backlogs_.erase(key);
+}
+
+void glnet::Udp::release(std::uint64_t key, std::size_t count)
+{
+    std::shared_lock lock(backlogsMutex_);
+    auto entry = backlogs_.find(key);
+
+    if (count == 0 || entry == backlogs_.end()) {
+        return;
+    }
+    std::size_t backlog = entry->second->load();
+
+    // The counter of a dropped peer starts over, a frame counted before the drop must not wrap it
+    while (backlog != 0 && !entry->second->compare_exchange_weak(backlog, backlog - std::min(backlog, count))) {
+    }
+}
+
+std::uint64_t glnet::Udp::channelKey(std::uint32_t clientId, std::uint8_t channel)
+{
+    return (static_cast<std::uint64_t>(clientId) << 8) | channel;
+}
+
+glnet::Reliability& glnet::Udp::getChannel(std::uint32_t clientId, std::uint8_t channel)
+{
+    return channels_[channelKey(clientId, channel)];
+}
+
+bool glnet::Udp::resolveEndpoint(std::uint32_t clientId, Endpoint& endpoint)
+{
+    if (side_ == connection::Side::CLIENT) {
+        endpoint = manager_.getServerEndpoint();
+        return true;
+    }
+    std::shared_ptr<Socket> socket = manager_.findClient(clientId);
+
+    if (!socket) {
+        return false;
+    }
+    endpoint = socket->getEndpoint();
+    return true;
+}
+
+void glnet::Udp::sendDatagram(std::uint32_t clientId, const Endpoint& endpoint, Header header, const Frame& frame, std::uint16_t messageId)
+{
+    std::uint64_t key = channelKey(clientId, header.channel);
+    auto channel = channels_.find(key);
+    std::size_t frameSize = frame ? frame->size() : 0;
+    Meter::Counters& counters = meter_.track(clientId);
+
+    if (channel != channels_.end() && channel->second.hasReceived()) {
+        header.flags |= FLAG_ACK;
+        header.ack = channel->second.getAck();
+        header.ackBits = channel->second.getAckBits();
+    }
+    ackPending_.erase(key);
+    getCongestion(clientId).onSent(sizeof(Header) + frameSize);
+    if (sizeof(Header) + frameSize <= MAX_DATAGRAM_SIZE) {
+        sendBuffer_.resize(sizeof(Header) + frameSize);
+        std::memcpy(sendBuffer_.data(), &header, sizeof(Header));
+        if (frameSize != 0) {
+            std::memcpy(sendBuffer_.data() + sizeof(Header), frame->data(), frameSize);
+        }
+        sendToEndpoint(clientId, endpoint, sendBuffer_, counters);
+        return;
+    }
+    FragmentHeader fragment = {.messageId = messageId, .index = 0, .count = static_cast<std::uint16_t>((frameSize + MAX_FRAGMENT_PAYLOAD - 1) / MAX_FRAGMENT_PAYLOAD)};
+
+    header.flags |= FLAG_FRAGMENT;
+    for (; fragment.index < fragment.count; fragment.index++) {
+        std::size_t offset = fragment.index * MAX_FRAGMENT_PAYLOAD;
+        std::size_t chunk = std::min(MAX_FRAGMENT_PAYLOAD, frameSize - offset);
+
+        sendBuffer_.resize(sizeof(Header) + sizeof(FragmentHeader) + chunk);
+        std::memcpy(sendBuffer_.data(), &header, sizeof(Header));
+        std::memcpy(sendBuffer_.data() + sizeof(Header), &fragment, sizeof(FragmentHeader));
+        std::memcpy(sendBuffer_.data() + sizeof(Header) + sizeof(FragmentHeader), frame->data() + offset, chunk);
+        sendToEndpoint(clientId, endpoint, sendBuffer_, counters);
+    }
+}
+
+std::uint16_t glnet::Udp::takeMessageId(const Frame& frame)
+{
+    return sizeof(Header) + frame->size() > MAX_DATAGRAM_SIZE ? nextMessageId_++ : 0;
+}
+
+void glnet::Udp::sendToEndpoint(std::uint32_t clientId, const Endpoint& endpoint, const std::vector<std::uint8_t>& datagram, Meter::Counters& counters)
+{
+    if (!impairer_.isActive(connection::Direction::OUTBOUND)) {
+        writeDatagram(endpoint, datagram, counters);
+        return;
+    }
+    Impairer::Plan plan = impairer_.plan(connection::Direction::OUTBOUND, clientId, datagram.size(), Impairer::Clock::now());
+
+    for (std::size_t copy = 0; copy < plan.copies; copy++) {
+        delayedOut_.push(plan.at[copy], {clientId, endpoint, datagram});
+    }
+}
+
+void glnet::Udp::writeDatagram(const Endpoint& endpoint, const std::vector<std::uint8_t>& datagram, Meter::Counters& counters)
 {
     try {
         Socket::Address_in servAddr = {0};
-        std::uint8_t buffer[sizeof(packet.length) + packet.length];
 
         servAddr.sin_family = AF_INET;
         servAddr.sin_port = htons(endpoint.port);
         servAddr.sin_addr.s_addr = inet_addr(endpoint.address.c_str());
+        Socket::Timestamp writeTime = tracingApplied_ ? std::chrono::system_clock::now() : Socket::Timestamp();
+
+        socket_.sendTo((Socket::Buffer) datagram.data(), datagram.size(), 0, (const Socket::Address&) servAddr, sizeof(servAddr));
+        counters.bytesOut.add(datagram.size());
+        counters.packetsOut.add();
+        if (tracingApplied_) {
+            tracer_.onSent(sendLog_, datagram.size(), false, writeTime);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+void glnet::Udp::deliver(std::uint32_t clientId, Packet& packet)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-        std::memcpy(buffer, &packet.length, sizeof(packet.length));
-        std::memcpy(buffer + sizeof(packet.length), packet.bytes.data(), packet.length);
+    manager_.callbackHandler(Callback::Type::ON_MESSAGE_RECEPTION, connection::Type::UDP, clientId, packet);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
-        socket_.sendTo(buffer, sizeof(packet.length) + packet.length, 0, (const Socket::Address&) servAddr, sizeof(servAddr));
+    meter_.onCallback(end - start);
+    if (tracingApplied_) {
+        tracer_.record(Tracer::Stage::DISPATCH, start - readAt_);
+        tracer_.record(Tracer::Stage::CALLBACK, end - start);
+    }
+}
+
+void glnet::Udp::applyTracing()
+{
+    bool enable = tracer_.isEnabled();
+
+    try {
+        socket_.setTimestamping(enable);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+    sendLog_ = Tracer::SendLog();
+    tracingApplied_ = enable;
+}
+
+void glnet::Udp::readSendTimestamps()
+{
+    Socket::Timestamp kernelTime;
+    std::uint32_t key = 0;
+
+    try {
+        while (socket_.readSendTimestamp(key, kernelTime)) {
+            if (tracingApplied_) {
+                tracer_.onSendTimestamp(sendLog_, key, kernelTime);
+            }
+        }
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
@@ -4,18 +4,28 @@
 #ifdef _WIN32
 
 #else
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
 #include <errno.h>
+#include <fcntl.h>
 #endif
 
 #include <cstring>
+#include <cstddef>
 #include <format>
 
-glnet::Socket::Socket(connection::Type type, Endpoint endpoint) : endpoint_(endpoint), isOwner_(true)
+glnet::Socket::Socket(connection::Type type, Endpoint endpoint, connection::LocalMode localMode) : fd_(INVALID_FD), endpoint_(endpoint), isOwner_(true)
 {
     if (type == connection::Type::TCP) {
         fd_ = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
     } else if (type == connection::Type::UDP) {
         fd_ = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    } else if (type == connection::Type::LOCAL) {
+#ifdef _WIN32
+        throw std::runtime_error("Local connections are not supported on this platform");
+#else
+        fd_ = ::socket(AF_UNIX, (localMode == connection::LocalMode::SEQPACKET ? SOCK_SEQPACKET : SOCK_STREAM) | SOCK_CLOEXEC, 0);
+#endif
     }
     if (fd_ == INVALID_FD) {
         throw std::runtime_error(std::format("Couldn't create the socket: {}.", getLastError()));
@@ -44,6 +54,19 @@ glnet::Socket::~Socket()
     }
 }
 
+void glnet::Socket::close()
+{
+    if (fd_ == INVALID_FD) {
+        return;
+    }
+#ifdef _WIN32
+    closesocket(fd_);
+#else
+    ::close(fd_);
+#endif
+    fd_ = INVALID_FD;
+}
+
 void glnet::Socket::startup()
 {
 #ifdef _WIN32
@@ -113,6 +136,39 @@ glnet::Socket glnet::Socket::accept(OptionalReference<Address> addr, OptionalRef
     return clientFd;
 }
 
+glnet::Socket::Fd glnet::Socket::tryAccept(Address& addr, AddressLength& addrLen)
+{
+#ifdef _WIN32
+    Fd clientFd = ::accept(fd_, &addr, &addrLen);
+    u_long mode = 1;
+
+    if (clientFd == INVALID_FD) {
+        if (::WSAGetLastError() == WSAEWOULDBLOCK) {
+            return INVALID_FD;
+        }
+        throw std::runtime_error(std::format("Couldn't accept the connection: {}.", getLastError()));
+    }
+    ::ioctlsocket(clientFd, FIONBIO, &mode);
+    return clientFd;
+#else
+    while (true) {
+        AddressLength length = addrLen;
+        Fd clientFd = ::accept4(fd_, &addr, &length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (clientFd != INVALID_FD) {
+            addrLen = length;
+            return clientFd;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return INVALID_FD;
+        }
+        if (errno != EINTR && errno != ECONNABORTED) {
+            throw std::runtime_error(std::format("Couldn't accept the connection: {}.", getLastError()));
+        }
+    }
+#endif
+}
+
 void glnet::Socket::connect(const Address& addr, AddressLength addrLen)
 {
     if (::connect(fd_, &addr, addrLen) == SOCKET_ERROR_CODE) {
@@ -120,6 +176,55 @@ void glnet::Socket::connect(const Address& addr, AddressLength addrLen)
     }
 }
 
+bool glnet::Socket::tryConnect(const Address& addr, AddressLength addrLen)
+{
+    if (::connect(fd_, &addr, addrLen) != SOCKET_ERROR_CODE) {
+        return true;
+    }
+#ifdef _WIN32
+    if (::WSAGetLastError() == WSAEWOULDBLOCK) {
+        return false;
+    }
+#else
+    if (errno == EINPROGRESS) {
+        return false;
+    }
+#endif
+    throw std::runtime_error(std::format("Couldn't connect to the address: {}.", getLastError()));
+}
+
+void glnet::Socket::setBlocking(bool blocking)
+{
+#ifdef _WIN32
+    u_long mode = blocking ? 0 : 1;
+
+    if (::ioctlsocket(fd_, FIONBIO, &mode) == SOCKET_ERROR_CODE) {
+        throw std::runtime_error(std::format("Couldn't set the blocking mode of the socket: {}.", getLastError()));
+    }
+#else
+    std::int32_t flags = ::fcntl(fd_, F_GETFL, 0);
+
+    if (flags == SOCKET_ERROR_CODE) {
+        throw std::runtime_error(std::format("Couldn't get the flags of the socket: {}.", getLastError()));
+    }
+    flags = blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+    if (::fcntl(fd_, F_SETFL, flags) == SOCKET_ERROR_CODE) {
+        throw std::runtime_error(std::format("Couldn't set the blocking mode of the socket: {}.", getLastError()));
+    }
+#endif
+}
+
+std::int32_t glnet::Socket::getPendingError()
+{
+    std::int32_t error = 0;
+    AddressLength length = sizeof(error);
+
+    if (::getsockopt(fd_, SOL_SOCKET, SO_ERROR, (char *) &error, &length) == SOCKET_ERROR_CODE) {
+        throw std::runtime_error(std::format("Couldn't get the pending error of the socket: {}.", getLastError()));
+    }
+    return error;
+}
+
 std::int32_t glnet::Socket::poll(std::vector<PollFd>& fds, NFDS nfds, std::int32_t timeout)
 {
     std::int32_t polled = 0;
@@ -148,6 +253,85 @@ glnet::Socket::BytesSent glnet::Socket::send(const Buffer& buffer, BufferLength
     return bytesSent;
 }
 
+glnet::Socket::BytesSent glnet::Socket::trySend(const Buffer& buffer, BufferLength length)
+{
+#ifdef _WIN32
+    BytesSent bytesSent = ::send(fd_, buffer, length, 0);
+
+    if (bytesSent != SOCKET_ERROR_CODE) {
+        return bytesSent;
+    }
+    if (::WSAGetLastError() == WSAEWOULDBLOCK) {
+        return 0;
+    }
+#else
+    BytesSent bytesSent = ::send(fd_, buffer, length, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+    if (bytesSent != SOCKET_ERROR_CODE) {
+        return bytesSent;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return 0;
+    }
+#endif
+    throw std::runtime_error(std::format("Send error on the socket: {}.", getLastError()));
+}
+
+glnet::Socket::BytesSent glnet::Socket::trySend(const Buffer& buffer, BufferLength length, Fd descriptor)
+{
+#ifdef _WIN32
+    throw std::runtime_error("Passing file descriptors is not supported on this platform");
+#else
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(Fd))] = {};
+    struct iovec vector = {.iov_base = buffer, .iov_len = length};
+    struct msghdr message = {};
+
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message);
+
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(Fd));
+    std::memcpy(CMSG_DATA(cmsg), &descriptor, sizeof(Fd));
+    BytesSent bytesSent = ::sendmsg(fd_, &message, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+    if (bytesSent != SOCKET_ERROR_CODE) {
+        return bytesSent;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return 0;
+    }
+    throw std::runtime_error(std::format("Send error on the socket: {}.", getLastError()));
+#endif
+}
+
+std::optional<glnet::Socket::BytesReceived> glnet::Socket::tryRecv(Buffer buffer, BufferLength length)
+{
+#ifdef _WIN32
+    BytesReceived bytesReceived = ::recv(fd_, buffer, length, 0);
+
+    if (bytesReceived != SOCKET_ERROR_CODE) {
+        return bytesReceived;
+    }
+    if (::WSAGetLastError() == WSAEWOULDBLOCK) {
+        return std::nullopt;
+    }
+#else
+    BytesReceived bytesReceived = ::recv(fd_, buffer, length, MSG_DONTWAIT);
+
+    if (bytesReceived != SOCKET_ERROR_CODE) {
+        return bytesReceived;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return std::nullopt;
+    }
+#endif
+    throw std::runtime_error(std::format("Receive error on the socket: {}.", getLastError()));
+}
+
 glnet::Socket::BytesReceived glnet::Socket::recv(Buffer buffer, BufferLength length, std::int32_t flags)
 {
     BytesReceived bytesReceived = 0;
@@ -159,6 +343,63 @@ glnet::Socket::BytesReceived glnet::Socket::recv(Buffer buffer, BufferLength len
     return bytesReceived;
 }
 
+std::optional<glnet::Socket::BytesReceived> glnet::Socket::tryRecv(Buffer buffer, BufferLength length, Timestamp& kernelTime)
+{
+#ifdef _WIN32
+    kernelTime = {};
+    return tryRecv(buffer, length);
+#else
+    BytesReceived bytesReceived = recvTimestamped(buffer, length, MSG_DONTWAIT, nullptr, nullptr, kernelTime);
+
+    if (bytesReceived != SOCKET_ERROR_CODE) {
+        return bytesReceived;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return std::nullopt;
+    }
+    throw std::runtime_error(std::format("Receive error on the socket: {}.", getLastError()));
+#endif
+}
+
+std::optional<glnet::Socket::BytesReceived> glnet::Socket::tryRecv(Buffer buffer, BufferLength length, Fd& descriptor)
+{
+    descriptor = INVALID_FD;
+#ifdef _WIN32
+    return tryRecv(buffer, length);
+#else
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(Fd))];
+    struct iovec vector = {.iov_base = buffer, .iov_len = length};
+    struct msghdr message = {};
+
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    BytesReceived bytesReceived = ::recvmsg(fd_, &message, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+
+    if (bytesReceived == SOCKET_ERROR_CODE) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return std::nullopt;
+        }
+        throw std::runtime_error(std::format("Receive error on the socket: {}.", getLastError()));
+    }
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message); cmsg; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS && cmsg->cmsg_len >= CMSG_LEN(sizeof(Fd))) {
+            std::memcpy(&descriptor, CMSG_DATA(cmsg), sizeof(Fd));
+        }
+    }
+    // The kernel closes the descriptors that did not fit, so only a truncated record is reported
+    if (message.msg_flags & MSG_TRUNC) {
+        if (descriptor != INVALID_FD) {
+            ::close(descriptor);
+            descriptor = INVALID_FD;
+        }
+        throw std::runtime_error(std::format("Receive error on the socket: a record is larger than the {} bytes buffer.", length));
+    }
+    return bytesReceived;
+#endif
+}
+
 glnet::Socket::BytesReceived glnet::Socket::sendTo(const Buffer& buffer, BufferLength length, std::int32_t flags, const Address& destAddr, AddressLength destAddrLen)
 {
     BytesSent bytesSent = 0;
@@ -185,6 +426,114 @@ glnet::Socket::BytesReceived glnet::Socket::recvFrom(
     return bytesReceived;
 }
 
+glnet::Socket::BytesReceived glnet::Socket::recvFrom(Buffer buffer, BufferLength length, Address& srcAddr, AddressLength& srcAddrLen, Timestamp& kernelTime)
+{
+#ifdef _WIN32
+    kernelTime = {};
+    return recvFrom(buffer, length, 0, srcAddr, srcAddrLen);
+#else
+    BytesReceived bytesReceived = recvTimestamped(buffer, length, 0, &srcAddr, &srcAddrLen, kernelTime);
+
+    if (bytesReceived == SOCKET_ERROR_CODE) {
+        throw std::runtime_error(std::format("Receive error from an endpoint: {}.", getLastError()));
+    }
+    return bytesReceived;
+#endif
+}
+
+bool glnet::Socket::setTimestamping(bool enable)
+{
+#ifdef _WIN32
+    return false;
+#else
+    std::int32_t flags = enable ? SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY : 0;
+
+    if (::setsockopt(fd_, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == SOCKET_ERROR_CODE) {
+        throw std::runtime_error(std::format("Couldn't set the timestamping of the socket: {}.", getLastError()));
+    }
+    return true;
+#endif
+}
+
+bool glnet::Socket::readSendTimestamp(std::uint32_t& key, Timestamp& kernelTime)
+{
+#ifdef _WIN32
+    return false;
+#else
+    while (true) {
+        alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(struct scm_timestamping)) + CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in))];
+        struct msghdr message = {};
+        bool found = false;
+
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        if (::recvmsg(fd_, &message, MSG_ERRQUEUE | MSG_DONTWAIT) == SOCKET_ERROR_CODE) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return false;
+            }
+            throw std::runtime_error(std::format("Couldn't read the error queue of the socket: {}.", getLastError()));
+        }
+        kernelTime = {};
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message); cmsg; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING) {
+                struct scm_timestamping timestamps = {};
+
+                std::memcpy(&timestamps, CMSG_DATA(cmsg), sizeof(timestamps));
+                kernelTime = Timestamp(std::chrono::duration_cast<Timestamp::duration>(std::chrono::seconds(timestamps.ts[0].tv_sec) + std::chrono::nanoseconds(timestamps.ts[0].tv_nsec)));
+            } else if ((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) || (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+                struct sock_extended_err error = {};
+
+                std::memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+                if (error.ee_errno == ENOMSG && error.ee_origin == SO_EE_ORIGIN_TIMESTAMPING) {
+                    key = error.ee_data;
+                    found = true;
+                }
+            }
+        }
+        if (found && kernelTime != Timestamp{}) {
+            return true;
+        }
+    }
+#endif
+}
+
+glnet::Socket::BytesReceived glnet::Socket::recvTimestamped(Buffer buffer, BufferLength length, std::int32_t flags, Address *srcAddr, AddressLength *srcAddrLen, Timestamp& kernelTime)
+{
+#ifdef _WIN32
+    kernelTime = {};
+    return ::recvfrom(fd_, (char *) buffer, length, flags, srcAddr, srcAddrLen);
+#else
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(struct scm_timestamping))];
+    struct iovec vector = {.iov_base = buffer, .iov_len = length};
+    struct msghdr message = {};
+
+    message.msg_name = srcAddr;
+    message.msg_namelen = srcAddrLen ? *srcAddrLen : 0;
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    kernelTime = {};
+    BytesReceived bytesReceived = ::recvmsg(fd_, &message, flags);
+
+    if (bytesReceived == SOCKET_ERROR_CODE) {
+        return bytesReceived;
+    }
+    if (srcAddrLen) {
+        *srcAddrLen = message.msg_namelen;
+    }
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message); cmsg; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING) {
+            struct scm_timestamping timestamps = {};
+
+            std::memcpy(&timestamps, CMSG_DATA(cmsg), sizeof(timestamps));
+            kernelTime = Timestamp(std::chrono::duration_cast<Timestamp::duration>(std::chrono::seconds(timestamps.ts[0].tv_sec) + std::chrono::nanoseconds(timestamps.ts[0].tv_nsec)));
+        }
+    }
+    return bytesReceived;
+#endif
+}
+
 std::int32_t glnet::Socket::getSockName(Address& addr, AddressLength& addrLen)
 {
     if (::getsockname(fd_, &addr, &addrLen) < SOCKET_ERROR_CODE) {
@@ -193,6 +542,14 @@ std::int32_t glnet::Socket::getSockName(Address& addr, AddressLength& addrLen)
     return 0;
 }
 
+std::int32_t glnet::Socket::getPeerName(Address& addr, AddressLength& addrLen)
+{
+    if (::getpeername(fd_, &addr, &addrLen) == SOCKET_ERROR_CODE) {
+        throw std::runtime_error(std::format("Error getting peer name: {}.", getLastError()));
+    }
+    return 0;
+}
+
 glnet::Socket::Fd glnet::Socket::getFd() const
 {
     return fd_;
@@ -224,3 +581,33 @@ glnet::Socket::InAddr glnet::Socket::inetAddr(std::string ip)
 {
     return ::inet_addr(ip.c_str());
 }
+
+glnet::Socket::AddressLength glnet::Socket::localAddress(const std::string& path, Address_un& addr)
+{
+    addr = {};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error(std::format("The local socket path must hold between 1 and {} characters: {}", sizeof(addr.sun_path) - 1, path));
+    }
+    std::memcpy(addr.sun_path, path.data(), path.size());
+    // An abstract socket starts with a null byte and its address ends with its name, it has no file to unlink
+    if (path[0] == '@') {
+        addr.sun_path[0] = '\0';
+        return static_cast<AddressLength>(offsetof(Address_un, sun_path) + path.size());
+    }
+    return static_cast<AddressLength>(sizeof(addr));
+}
+
+glnet::Socket::Fd glnet::Socket::duplicate(Fd fd)
+{
+#ifdef _WIN32
+    throw std::runtime_error("Duplicating file descriptors is not supported on this platform");
+#else
+    Fd copy = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+
+    if (copy == INVALID_FD) {
+        throw std::runtime_error(std::format("Couldn't duplicate the file descriptor {}: {}.", fd, getLastError()));
+    }
+    return copy;
+#endif
+}
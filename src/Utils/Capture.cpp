@@ -0,0 +1,195 @@
+#include "Utils/Capture.hpp"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <stdexcept>
+#include <iostream>
+#include <cstring>
+#include <chrono>
+#include <format>
+#include <thread>
+
+glnet::utils::Capture::Capture() : open_(false), writers_(0), offset_(0), dropped_(0), base_(nullptr), capacity_(0), fd_(-1)
+{
+}
+
+glnet::utils::Capture::~Capture()
+{
+    close();
+}
+
+void glnet::utils::Capture::open(const std::string& path, std::size_t capacity)
+{
+    close();
+#ifdef _WIN32
+    throw std::runtime_error("Traffic capture is not supported on this platform");
+#else
+    if (capacity < sizeof(FileHeader) + sizeof(RecordHeader)) {
+        throw std::runtime_error(std::format("The capture capacity must be at least {} bytes", sizeof(FileHeader) + sizeof(RecordHeader)));
+    }
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+    if (fd == -1) {
+        throw std::runtime_error(std::format("Couldn't open the capture file {}: {}.", path, std::strerror(errno)));
+    }
+    // The file is zero-filled, so a zero timestamp marks the end of the records written so far, even after a crash
+    if (::ftruncate(fd, static_cast<off_t>(capacity)) == -1) {
+        int error = errno;
+
+        ::close(fd);
+        throw std::runtime_error(std::format("Couldn't size the capture file {}: {}.", path, std::strerror(error)));
+    }
+    void *base = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (base == MAP_FAILED) {
+        int error = errno;
+
+        ::close(fd);
+        throw std::runtime_error(std::format("Couldn't map the capture file {}: {}.", path, std::strerror(error)));
+    }
+    FileHeader header = {.magic = {0}, .version = VERSION, .reserved = 0};
+
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    std::memcpy(base, &header, sizeof(header));
+    fd_ = fd;
+    base_ = static_cast<std::uint8_t *>(base);
+    capacity_ = capacity;
+    offset_ = sizeof(FileHeader);
+    dropped_ = 0;
+    open_.store(true, std::memory_order_release);
+#endif
+}
+
+void glnet::utils::Capture::close()
+{
+#ifndef _WIN32
+    if (!open_.exchange(false)) {
+        return;
+    }
+    while (writers_.load() != 0) {
+        std::this_thread::yield();
+    }
+    std::size_t used = std::min(offset_.load(), capacity_);
+
+    ::munmap(base_, capacity_);
+    // On failure the zero-filled tail is still read as the end of the capture
+    if (::ftruncate(fd_, static_cast<off_t>(used)) == -1) {
+        std::cerr << std::format("Couldn't truncate the capture file: {}.", std::strerror(errno)) << std::endl;
+    }
+    ::close(fd_);
+    base_ = nullptr;
+    fd_ = -1;
+#endif
+}
+
+bool glnet::utils::Capture::isOpen() const
+{
+    return open_.load(std::memory_order_relaxed);
+}
+
+bool glnet::utils::Capture::record(Direction direction, connection::Type type, std::uint32_t clientId, const std::uint8_t *data, std::size_t size)
+{
+    // Sequentially consistent with close: either close sees this writer, or this writer sees the capture closed
+    writers_.fetch_add(1);
+    if (!open_.load()) {
+        writers_.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+    std::size_t recordSize = (sizeof(RecordHeader) + size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+    std::size_t offset = offset_.fetch_add(recordSize, std::memory_order_relaxed);
+
+    if (offset + recordSize > capacity_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        writers_.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+    RecordHeader header = {
+        .timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count(),
+        .clientId = clientId,
+        .length = static_cast<std::uint32_t>(size),
+        .direction = static_cast<std::uint8_t>(direction),
+        .transport = static_cast<std::uint8_t>(type),
+        .reserved = 0,
+        .reserved2 = 0,
+    };
+
+    // The payload is written before the header, whose timestamp marks the record as complete
+    if (size != 0) {
+        std::memcpy(base_ + offset + sizeof(RecordHeader), data, size);
+    }
+    std::memcpy(base_ + offset + sizeof(std::int64_t), reinterpret_cast<const std::uint8_t *>(&header) + sizeof(std::int64_t), sizeof(RecordHeader) - sizeof(std::int64_t));
+    std::atomic_ref<std::int64_t>(*reinterpret_cast<std::int64_t *>(base_ + offset)).store(header.timestamp, std::memory_order_release);
+    writers_.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+std::uint64_t glnet::utils::Capture::getDropped() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+glnet::utils::CaptureReader::CaptureReader(const std::string& path) : base_(nullptr), size_(0), offset_(sizeof(Capture::FileHeader))
+{
+#ifdef _WIN32
+    throw std::runtime_error("Traffic capture is not supported on this platform");
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info = {};
+
+    if (fd == -1) {
+        throw std::runtime_error(std::format("Couldn't open the capture file {}: {}.", path, std::strerror(errno)));
+    }
+    if (::fstat(fd, &info) == -1 || static_cast<std::size_t>(info.st_size) < sizeof(Capture::FileHeader)) {
+        ::close(fd);
+        throw std::runtime_error(std::format("The capture file {} is truncated", path));
+    }
+    size_ = static_cast<std::size_t>(info.st_size);
+    void *base = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error(std::format("Couldn't map the capture file {}: {}.", path, std::strerror(errno)));
+    }
+    base_ = static_cast<const std::uint8_t *>(base);
+    Capture::FileHeader header = {};
+
+    std::memcpy(&header, base_, sizeof(header));
+    if (std::memcmp(header.magic, Capture::MAGIC, sizeof(Capture::MAGIC)) != 0 || header.version != Capture::VERSION) {
+        ::munmap(const_cast<std::uint8_t *>(base_), size_);
+        throw std::runtime_error(std::format("{} is not a version {} capture file", path, Capture::VERSION));
+    }
+#endif
+}
+
+glnet::utils::CaptureReader::~CaptureReader()
+{
+#ifndef _WIN32
+    if (base_) {
+        ::munmap(const_cast<std::uint8_t *>(base_), size_);
+    }
+#endif
+}
+
+bool glnet::utils::CaptureReader::next(Capture::RecordHeader& header, const std::uint8_t *& data)
+{
+    if (offset_ + sizeof(Capture::RecordHeader) > size_) {
+        return false;
+    }
+    std::memcpy(&header, base_ + offset_, sizeof(header));
+    if (header.timestamp == 0 || offset_ + sizeof(Capture::RecordHeader) + header.length > size_) {
+        return false;
+    }
+    data = base_ + offset_ + sizeof(Capture::RecordHeader);
+    offset_ += (sizeof(Capture::RecordHeader) + header.length + Capture::RECORD_ALIGNMENT - 1) & ~(Capture::RECORD_ALIGNMENT - 1);
+    return true;
+}
+
+void glnet::utils::CaptureReader::rewind()
+{
+    offset_ = sizeof(Capture::FileHeader);
+}
@@ -0,0 +1,39 @@
+#include "Utils/Counter.hpp"
+
+void glnet::utils::Counter::add(std::uint64_t value)
+{
+    value_.store(value_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void glnet::utils::Counter::set(std::uint64_t value)
+{
+    value_.store(value, std::memory_order_relaxed);
+}
+
+std::uint64_t glnet::utils::Counter::get() const
+{
+    return value_.load(std::memory_order_relaxed);
+}
+
+void glnet::utils::SharedCounter::add(std::uint64_t value)
+{
+    shards_[getShard()].value.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::uint64_t glnet::utils::SharedCounter::get() const
+{
+    std::uint64_t sum = 0;
+
+    for (const Shard& shard : shards_) {
+        sum += shard.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+std::size_t glnet::utils::SharedCounter::getShard()
+{
+    static std::atomic<std::size_t> next{0};
+    thread_local std::size_t shard = next.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+
+    return shard;
+}
@@ -0,0 +1,80 @@
+#include "Utils/FramePool.hpp"
+
+#include <array>
+#include <new>
+
+namespace
+{
+    /**
+     * @struct FreeBlock
+     * @brief A released frame, linked in the free list of its size class
+     */
+    struct FreeBlock {
+            FreeBlock *next; /*!> The next free block of the same size class */
+    };
+
+    /**
+     * @struct FreeLists
+     * @brief The free lists of a thread, one per size class
+     */
+    struct FreeLists {
+            static constexpr std::size_t CLASSES = glnet::utils::FramePool::MAX_POOLED_SIZE / glnet::utils::FramePool::BLOCK_GRANULARITY;
+
+            std::array<FreeBlock *, CLASSES> heads = {};  /*!> The first free block of each size class */
+            std::array<std::size_t, CLASSES> counts = {}; /*!> The number of free blocks of each size class */
+
+            /**
+             * @brief Release every block kept by the thread
+             */
+            ~FreeLists()
+            {
+                for (FreeBlock *head : heads) {
+                    while (head) {
+                        FreeBlock *next = head->next;
+
+                        ::operator delete(head);
+                        head = next;
+                    }
+                }
+            }
+    };
+
+    thread_local FreeLists freeLists;
+
+    std::size_t sizeClass(std::size_t size)
+    {
+        return (size + glnet::utils::FramePool::BLOCK_GRANULARITY - 1) / glnet::utils::FramePool::BLOCK_GRANULARITY - 1;
+    }
+}
+
+void *glnet::utils::FramePool::allocate(std::size_t size)
+{
+    if (size == 0 || size > MAX_POOLED_SIZE) {
+        return ::operator new(size);
+    }
+    std::size_t index = sizeClass(size);
+    FreeBlock *block = freeLists.heads[index];
+
+    if (!block) {
+        return ::operator new((index + 1) * BLOCK_GRANULARITY);
+    }
+    freeLists.heads[index] = block->next;
+    freeLists.counts[index]--;
+    return block;
+}
+
+void glnet::utils::FramePool::deallocate(void *ptr, std::size_t size)
+{
+    if (size == 0 || size > MAX_POOLED_SIZE) {
+        ::operator delete(ptr);
+        return;
+    }
+    std::size_t index = sizeClass(size);
+
+    if (freeLists.counts[index] >= MAX_BLOCKS_PER_CLASS) {
+        ::operator delete(ptr);
+        return;
+    }
+    freeLists.heads[index] = ::new (ptr) FreeBlock{freeLists.heads[index]};
+    freeLists.counts[index]++;
+}
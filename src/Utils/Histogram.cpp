@@ -0,0 +1,82 @@
+#include "Utils/Histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <bit>
+
+void glnet::utils::Histogram::record(std::uint64_t value)
+{
+    std::uint64_t count = count_.get();
+
+    buckets_[getBucket(value)].add();
+    sum_.add(value);
+    if (count == 0 || value < min_.get()) {
+        min_.set(value);
+    }
+    if (value > max_.get()) {
+        max_.set(value);
+    }
+    count_.set(count + 1);
+}
+
+glnet::LatencyStats glnet::utils::Histogram::getStats() const
+{
+    static constexpr std::array<double, 4> QUANTILES = {0.5, 0.9, 0.99, 0.999};
+    std::array<std::uint64_t, QUANTILES.size()> values = {0};
+    std::array<std::uint64_t, BUCKET_COUNT> buckets = {0};
+    LatencyStats stats;
+    std::uint64_t total = 0;
+
+    for (std::size_t i = 0; i < BUCKET_COUNT; i++) {
+        buckets[i] = buckets_[i].get();
+        total += buckets[i];
+    }
+    if (total == 0) {
+        return stats;
+    }
+    std::uint64_t seen = 0;
+    std::size_t quantile = 0;
+
+    for (std::size_t i = 0; i < BUCKET_COUNT && quantile < QUANTILES.size(); i++) {
+        seen += buckets[i];
+        while (quantile < QUANTILES.size() && seen >= std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(QUANTILES[quantile] * static_cast<double>(total))))) {
+            values[quantile++] = getValue(i);
+        }
+    }
+    std::uint64_t min = min_.get();
+    std::uint64_t max = max_.get();
+    auto clamp = [min, max](std::uint64_t value) {
+        return std::chrono::nanoseconds(std::clamp(value, min, std::max(min, max)));
+    };
+
+    stats.count = total;
+    stats.min = std::chrono::nanoseconds(min);
+    stats.max = std::chrono::nanoseconds(max);
+    stats.mean = std::chrono::nanoseconds(sum_.get() / std::max<std::uint64_t>(count_.get(), 1));
+    stats.p50 = clamp(values[0]);
+    stats.p90 = clamp(values[1]);
+    stats.p99 = clamp(values[2]);
+    stats.p999 = clamp(values[3]);
+    return stats;
+}
+
+std::size_t glnet::utils::Histogram::getBucket(std::uint64_t value)
+{
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<std::size_t>(value);
+    }
+    std::size_t shift = static_cast<std::size_t>(std::bit_width(value)) - 1 - SUB_BUCKET_BITS;
+
+    return std::min(BUCKET_COUNT - 1, (shift + 1) * SUB_BUCKET_COUNT + static_cast<std::size_t>((value >> shift) & (SUB_BUCKET_COUNT - 1)));
+}
+
+std::uint64_t glnet::utils::Histogram::getValue(std::size_t bucket)
+{
+    if (bucket < SUB_BUCKET_COUNT) {
+        return bucket;
+    }
+    std::size_t shift = bucket / SUB_BUCKET_COUNT - 1;
+    std::uint64_t lowest = (SUB_BUCKET_COUNT + bucket % SUB_BUCKET_COUNT) << shift;
+
+    return lowest + ((std::uint64_t{1} << shift) >> 1);
+}
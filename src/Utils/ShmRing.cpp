@@ -0,0 +1,122 @@
+#include "Utils/ShmRing.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <format>
+#include <new>
+
+glnet::utils::ShmRing::ShmRing() : control_(nullptr), data_(nullptr), capacity_(0)
+{
+}
+
+std::size_t glnet::utils::ShmRing::getFootprint(std::size_t capacity)
+{
+    return sizeof(Control) + ((capacity + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1));
+}
+
+void glnet::utils::ShmRing::attach(void *base, std::size_t capacity, bool reset)
+{
+    if (capacity < 2 * RECORD_ALIGNMENT || (capacity & (capacity - 1)) != 0) {
+        throw std::runtime_error(std::format("The capacity of a shared ring must be a power of two, not {}", capacity));
+    }
+    control_ = reset ? new (base) Control() : static_cast<Control *>(base);
+    data_ = static_cast<std::uint8_t *>(base) + sizeof(Control);
+    capacity_ = capacity;
+}
+
+std::size_t glnet::utils::ShmRing::getMaxFrameSize() const
+{
+    return capacity_ / 2;
+}
+
+std::size_t glnet::utils::ShmRing::getUsed() const
+{
+    return static_cast<std::size_t>(control_->head.load(std::memory_order_relaxed) - control_->tail.load(std::memory_order_relaxed));
+}
+
+bool glnet::utils::ShmRing::push(const std::uint8_t *frame, std::size_t size)
+{
+    std::size_t recordSize = (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+
+    if (recordSize > getMaxFrameSize()) {
+        return false;
+    }
+    std::uint64_t head = control_->head.load(std::memory_order_relaxed);
+    std::uint64_t tail = control_->tail.load(std::memory_order_acquire);
+    std::size_t offset = static_cast<std::size_t>(head & (capacity_ - 1));
+    std::size_t contiguous = capacity_ - offset;
+    std::size_t needed = recordSize <= contiguous ? recordSize : contiguous + recordSize;
+
+    if (capacity_ - static_cast<std::size_t>(head - tail) < needed) {
+        return false;
+    }
+    // A record never wraps, the end of the ring is skipped instead
+    if (recordSize > contiguous) {
+        std::memcpy(data_ + offset, &WRAP, sizeof(WRAP));
+        head += contiguous;
+        offset = 0;
+    }
+    std::memcpy(data_ + offset, frame, size);
+    // Sequentially consistent with the sleeping flag: either the consumer sees the frame, or the producer sees it sleeping
+    control_->head.store(head + recordSize);
+    return true;
+}
+
+bool glnet::utils::ShmRing::needsWakeup()
+{
+    if (control_->sleeping.load() == 0) {
+        return false;
+    }
+    return control_->sleeping.exchange(0) != 0;
+}
+
+const std::uint8_t *glnet::utils::ShmRing::front(std::size_t& size)
+{
+    std::uint64_t tail = control_->tail.load(std::memory_order_relaxed);
+    std::uint64_t head = control_->head.load(std::memory_order_acquire);
+
+    while (head != tail) {
+        std::size_t offset = static_cast<std::size_t>(tail & (capacity_ - 1));
+        std::uint32_t length = 0;
+
+        // The other process may be faulty, so every position read from the memory is checked
+        if (head - tail > capacity_) {
+            throw std::runtime_error("The shared ring is corrupted: its producer is ahead of its capacity");
+        }
+        std::memcpy(&length, data_ + offset, sizeof(length));
+        if (length == WRAP) {
+            tail += capacity_ - offset;
+            control_->tail.store(tail, std::memory_order_release);
+            continue;
+        }
+        size = sizeof(length) + length;
+        if (((size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1)) > std::min<std::uint64_t>(head - tail, capacity_ - offset)) {
+            throw std::runtime_error(std::format("The shared ring is corrupted: a frame of {} bytes overruns it", size));
+        }
+        return data_ + offset;
+    }
+    return nullptr;
+}
+
+void glnet::utils::ShmRing::pop(std::size_t size)
+{
+    std::size_t recordSize = (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+
+    control_->tail.store(control_->tail.load(std::memory_order_relaxed) + recordSize, std::memory_order_release);
+}
+
+bool glnet::utils::ShmRing::sleep()
+{
+    control_->sleeping.store(1);
+    if (control_->head.load() != control_->tail.load(std::memory_order_relaxed)) {
+        control_->sleeping.store(0, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void glnet::utils::ShmRing::wake()
+{
+    control_->sleeping.store(0, std::memory_order_relaxed);
+}
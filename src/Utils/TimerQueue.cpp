@@ -0,0 +1,147 @@
+#include "Utils/TimerQueue.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+
+glnet::utils::TimerQueue::TimerQueue() : nextId_(1)
+{
+}
+
+glnet::utils::TimerQueue::Id glnet::utils::TimerQueue::add(Clock::duration delay, std::function<void()> callback)
+{
+    return insert(std::make_shared<Entry>(Entry{.kind = Kind::ONE_SHOT, .period = Clock::duration::zero(), .deadline = Clock::now() + delay, .callback = std::move(callback)}));
+}
+
+glnet::utils::TimerQueue::Id glnet::utils::TimerQueue::addPeriodic(Clock::duration interval, std::function<void()> callback)
+{
+    if (interval <= Clock::duration::zero()) {
+        throw std::runtime_error("The interval of a periodic timer must be positive");
+    }
+    return insert(std::make_shared<Entry>(Entry{.kind = Kind::PERIODIC, .period = interval, .deadline = Clock::now() + interval, .callback = std::move(callback)}));
+}
+
+glnet::utils::TimerQueue::Id glnet::utils::TimerQueue::addTick(Clock::duration period, std::function<void(const Tick&)> callback)
+{
+    if (period <= Clock::duration::zero()) {
+        throw std::runtime_error("The period of a tick must be positive");
+    }
+    return insert(std::make_shared<Entry>(Entry{.kind = Kind::TICK, .period = period, .deadline = Clock::now() + period, .onTick = std::move(callback)}));
+}
+
+bool glnet::utils::TimerQueue::cancel(Id id)
+{
+    std::scoped_lock lock(mutex_);
+
+    return entries_.erase(id) != 0;
+}
+
+void glnet::utils::TimerQueue::process()
+{
+    Clock::time_point now = Clock::now();
+
+    wakeup_.clear();
+    {
+        std::scoped_lock lock(mutex_);
+
+        while (!deadlines_.empty() && deadlines_.top().first <= now) {
+            auto [deadline, id] = deadlines_.top();
+            auto entry = entries_.find(id);
+
+            deadlines_.pop();
+            if (entry == entries_.end() || entry->second->deadline != deadline) {
+                continue;
+            }
+            due_.emplace_back(id, entry->second);
+            if (entry->second->kind == Kind::ONE_SHOT) {
+                entries_.erase(entry);
+            }
+        }
+    }
+    for (auto& [id, entry] : due_) {
+        try {
+            switch (entry->kind) {
+                case Kind::ONE_SHOT:
+                    entry->callback();
+                    break;
+                case Kind::PERIODIC:
+                    entry->callback();
+                    rearm(id, Clock::now() + entry->period);
+                    break;
+                case Kind::TICK:
+                    rearm(id, runTick(*entry, now));
+                    break;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+    due_.clear();
+}
+
+std::int32_t glnet::utils::TimerQueue::getTimeout() const
+{
+    std::scoped_lock lock(mutex_);
+
+    if (deadlines_.empty()) {
+        return -1;
+    }
+    std::chrono::milliseconds remaining = std::chrono::ceil<std::chrono::milliseconds>(deadlines_.top().first - Clock::now());
+
+    return static_cast<std::int32_t>(std::clamp<std::int64_t>(remaining.count(), 0, INT32_MAX));
+}
+
+glnet::Socket::Fd glnet::utils::TimerQueue::getFd() const
+{
+    return wakeup_.getFd();
+}
+
+glnet::utils::TimerQueue::Id glnet::utils::TimerQueue::insert(std::shared_ptr<Entry> entry)
+{
+    Clock::time_point deadline = entry->deadline;
+    Id id = 0;
+
+    {
+        std::scoped_lock lock(mutex_);
+
+        id = nextId_++;
+        entries_.emplace(id, std::move(entry));
+    }
+    rearm(id, deadline);
+    return id;
+}
+
+bool glnet::utils::TimerQueue::rearm(Id id, Clock::time_point deadline)
+{
+    bool earliest = false;
+
+    {
+        std::scoped_lock lock(mutex_);
+        auto entry = entries_.find(id);
+
+        if (entry == entries_.end()) {
+            return false;
+        }
+        earliest = deadlines_.empty() || deadline < deadlines_.top().first;
+        entry->second->deadline = deadline;
+        deadlines_.emplace(deadline, id);
+    }
+    if (earliest) {
+        wakeup_.notify();
+    }
+    return true;
+}
+
+glnet::utils::TimerQueue::Clock::time_point glnet::utils::TimerQueue::runTick(Entry& entry, Clock::time_point now)
+{
+    std::uint64_t missed = static_cast<std::uint64_t>((now - entry.deadline) / entry.period);
+    Clock::time_point scheduled = entry.deadline + entry.period * missed;
+
+    entry.tick.index += missed + 1;
+    entry.tick.scheduled = scheduled;
+    entry.tick.lateness = now - scheduled;
+    entry.tick.missed = missed;
+    entry.tick.overruns += missed;
+    entry.onTick(entry.tick);
+    return scheduled + entry.period;
+}
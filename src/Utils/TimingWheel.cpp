@@ -0,0 +1,114 @@
+#include "Utils/TimingWheel.hpp"
+
+#include <algorithm>
+#include <utility>
+
+glnet::utils::TimingWheel::TimingWheel(Clock::duration resolution, Clock::time_point now) : resolution_(resolution), origin_(now)
+{
+}
+
+void glnet::utils::TimingWheel::schedule(Timer& timer, Clock::time_point deadline)
+{
+    std::uint64_t ticks = deadline <= origin_ ? 0 : static_cast<std::uint64_t>((deadline - origin_ + resolution_ - Clock::duration(1)) / resolution_);
+
+    cancel(timer);
+    timer.expiry = std::clamp(ticks, current_ + 1, current_ + MAX_DELTA);
+    link(timer);
+    size_++;
+}
+
+void glnet::utils::TimingWheel::cancel(Timer& timer)
+{
+    if (!timer.pprev) {
+        return;
+    }
+    *timer.pprev = timer.next;
+    if (timer.next) {
+        timer.next->pprev = timer.pprev;
+    }
+    timer.next = nullptr;
+    timer.pprev = nullptr;
+    size_--;
+}
+
+bool glnet::utils::TimingWheel::isArmed(const Timer& timer)
+{
+    return timer.pprev != nullptr;
+}
+
+void glnet::utils::TimingWheel::advance(Clock::time_point now, std::vector<Timer *>& expired)
+{
+    std::uint64_t target = now <= origin_ ? 0 : static_cast<std::uint64_t>((now - origin_) / resolution_);
+
+    if (size_ == 0) {
+        current_ = std::max(current_, target);
+        return;
+    }
+    while (current_ < target && size_ != 0) {
+        current_++;
+        std::size_t level = 1;
+
+        while (level < LEVELS && (current_ & ((1ull << (SLOT_BITS * level)) - 1)) == 0) {
+            level++;
+        }
+        for (; level > 1; level--) {
+            cascade(level - 1);
+        }
+        Timer *&head = slots_[0][current_ & (SLOTS - 1)];
+
+        while (head) {
+            Timer& timer = *head;
+
+            cancel(timer);
+            expired.push_back(&timer);
+        }
+    }
+    current_ = std::max(current_, target);
+}
+
+glnet::utils::TimingWheel::Clock::time_point glnet::utils::TimingWheel::getNextDeadline() const
+{
+    if (size_ == 0) {
+        return Clock::time_point::max();
+    }
+    std::uint64_t tick = current_ + 1;
+
+    for (; (tick & (SLOTS - 1)) != 0; tick++) {
+        if (slots_[0][tick & (SLOTS - 1)]) {
+            break;
+        }
+    }
+    return origin_ + resolution_ * static_cast<Clock::rep>(tick);
+}
+
+void glnet::utils::TimingWheel::link(Timer& timer)
+{
+    std::uint64_t delta = timer.expiry - current_;
+    std::size_t level = 0;
+
+    while (level + 1 < LEVELS && delta >= (1ull << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    Timer *&head = slots_[level][(timer.expiry >> (SLOT_BITS * level)) & (SLOTS - 1)];
+
+    timer.next = head;
+    timer.pprev = &head;
+    if (head) {
+        head->pprev = &timer.next;
+    }
+    head = &timer;
+}
+
+void glnet::utils::TimingWheel::cascade(std::size_t level)
+{
+    Timer *timer = std::exchange(slots_[level][(current_ >> (SLOT_BITS * level)) & (SLOTS - 1)], nullptr);
+
+    while (timer) {
+        Timer *next = timer->next;
+
+        timer->next = nullptr;
+        timer->pprev = nullptr;
+        link(*timer);
+        timer = next;
+    }
+}
@@ -0,0 +1,45 @@
+#include "Utils/TokenBucket.hpp"
+
+#include <algorithm>
+
+glnet::utils::TokenBucket::TokenBucket(RateLimit limit, Clock::time_point now)
+    : rate_(static_cast<double>(limit.bytesPerSecond)), burst_(static_cast<double>(limit.burst != 0 ? limit.burst : limit.bytesPerSecond)), tokens_(burst_), lastRefill_(now)
+{
+}
+
+bool glnet::utils::TokenBucket::canConsume(std::size_t size, Clock::time_point now)
+{
+    refill(now);
+    return tokens_ >= std::min(static_cast<double>(size), burst_);
+}
+
+void glnet::utils::TokenBucket::consume(std::size_t size)
+{
+    tokens_ -= static_cast<double>(size);
+}
+
+glnet::utils::TokenBucket::Clock::duration glnet::utils::TokenBucket::getDelay(std::size_t size) const
+{
+    double missing = std::min(static_cast<double>(size), burst_) - tokens_;
+
+    if (missing <= 0) {
+        return Clock::duration::zero();
+    }
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(missing / rate_));
+}
+
+void glnet::utils::TokenBucket::setLimit(RateLimit limit)
+{
+    rate_ = static_cast<double>(limit.bytesPerSecond);
+    burst_ = static_cast<double>(limit.burst != 0 ? limit.burst : limit.bytesPerSecond);
+    tokens_ = std::min(tokens_, burst_);
+}
+
+void glnet::utils::TokenBucket::refill(Clock::time_point now)
+{
+    if (now <= lastRefill_) {
+        return;
+    }
+    tokens_ = std::min(burst_, tokens_ + rate_ * std::chrono::duration<double>(now - lastRefill_).count());
+    lastRefill_ = now;
+}
@@ -0,0 +1,78 @@
+#include "Utils/Wakeup.hpp"
+
+#ifndef _WIN32
+#include <sys/eventfd.h>
+#endif
+
+#include <cstring>
+#include <format>
+
+glnet::utils::Wakeup::Wakeup() : signaled_(false)
+{
+#ifdef _WIN32
+    Socket::AddressLength addrLen = sizeof(addr_);
+    u_long nonBlocking = 1;
+
+    socket_ = std::make_unique<Socket>(connection::Type::UDP, Endpoint{"127.0.0.1", 0});
+    addr_ = {0};
+    addr_.sin_family = AF_INET;
+    addr_.sin_port = htons(0);
+    addr_.sin_addr.s_addr = Socket::inetAddr("127.0.0.1");
+    socket_->bind((Socket::Address&) addr_, addrLen);
+    socket_->getSockName((Socket::Address&) addr_, addrLen);
+    ::ioctlsocket(socket_->getFd(), FIONBIO, &nonBlocking);
+#else
+    fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd_ == INVALID_FD) {
+        throw std::runtime_error(std::format("Couldn't create the wakeup eventfd: {}.", std::strerror(errno)));
+    }
+#endif
+}
+
+glnet::utils::Wakeup::~Wakeup()
+{
+#ifndef _WIN32
+    ::close(fd_);
+#endif
+}
+
+void glnet::utils::Wakeup::notify()
+{
+    if (signaled_.exchange(true)) {
+        return;
+    }
+#ifdef _WIN32
+    char byte = 0;
+
+    ::sendto(socket_->getFd(), &byte, sizeof(byte), 0, (Socket::Address *) &addr_, sizeof(addr_));
+#else
+    std::uint64_t value = 1;
+
+    [[maybe_unused]] ssize_t written = ::write(fd_, &value, sizeof(value));
+#endif
+}
+
+void glnet::utils::Wakeup::clear()
+{
+    // The signal is drained before the flag is lowered: a notify in between skips its write, but its work is drained next
+#ifdef _WIN32
+    char buffer[64];
+
+    while (::recv(socket_->getFd(), buffer, sizeof(buffer), 0) > 0) {
+    }
+#else
+    std::uint64_t value = 0;
+
+    [[maybe_unused]] ssize_t bytesRead = ::read(fd_, &value, sizeof(value));
+#endif
+    signaled_.store(false);
+}
+
+glnet::Socket::Fd glnet::utils::Wakeup::getFd() const
+{
+#ifdef _WIN32
+    return socket_->getFd();
+#else
+    return fd_;
+#endif
+}
@@ -0,0 +1,79 @@
+
+#pragma once
+
+#include "Manager.hpp"
+
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace test
+{
+    /**
+     * @brief Wait for a condition set by the I/O threads
+     *
+     * @param done The condition
+     * @param timeout The time after which the wait fails
+     * @return true if the condition was met, false on timeout
+     */
+    inline bool waitFor(const std::function<bool()>& done, std::chrono::steady_clock::duration timeout)
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        while (!done()) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Report a failed expectation
+     *
+     * @param condition The expectation
+     * @param message What was expected
+     * @return true if the expectation holds, false otherwise
+     */
+    inline bool check(bool condition, const std::string& message)
+    {
+        if (!condition) {
+            std::cerr << "FAILED: " << message << std::endl;
+        }
+        return condition;
+    }
+
+    /**
+     * @brief Start a threaded server and connect a threaded client to it over tcp and udp, on the local host
+     *
+     * @param server The server, its callbacks already set
+     * @param client The client, its callbacks already set but the connection one
+     * @param port The port the server listens on, for both transports
+     * @return true if the client is connected, false on timeout
+     */
+    inline bool connectPair(glnet::Manager& server, glnet::Manager& client, std::uint16_t port)
+    {
+        std::shared_ptr<std::atomic<bool>> connected = std::make_shared<std::atomic<bool>>(false);
+
+        server.initialize(glnet::connection::Side::SERVER);
+        server.createConnection(glnet::connection::Type::TCP, {LOCALHOST, port});
+        server.createConnection(glnet::connection::Type::UDP, {LOCALHOST, port});
+        client.callbacks().setOnConnection([connected](std::uint32_t) { *connected = true; });
+        client.initialize(glnet::connection::Side::CLIENT);
+        client.setServerEndpoint({LOCALHOST, port});
+        client.createConnection(glnet::connection::Type::TCP);
+        client.createConnection(glnet::connection::Type::UDP);
+        client.connectToServer();
+        if (!waitFor([&connected] { return connected->load(); }, std::chrono::seconds(5))) {
+            return false;
+        }
+        // The server learns the udp endpoint of the client from its first datagram
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return true;
+    }
+}
@@ -0,0 +1,92 @@
+#include "Data/Packet.hpp"
+#include "Manager.hpp"
+#include "Harness.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <optional>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using glnet::connection::Direction;
+using glnet::connection::Delivery;
+using glnet::connection::SendResult;
+using glnet::connection::Type;
+
+static constexpr std::uint16_t PORT = 9901;             // The port of the server, for both transports
+static constexpr std::size_t MESSAGE_SIZE = 1000;       // The payload size of the reliable messages streamed to the server
+static constexpr std::chrono::seconds SETTLE{2};        // The time the rate is given to grow before it is measured
+static constexpr std::chrono::seconds REACTION{10};     // The time the rate is given to react to a change of the path
+static constexpr std::chrono::milliseconds LATENCY{50}; // The delay added to the datagrams of the client by the latency impairment
+static constexpr double LOSS = 0.3;                     // The fraction of the datagrams of the client dropped by the loss impairment
+
+// The target rate of the path to the server, 0 before the first measure
+static std::uint64_t getRate(glnet::Manager& client)
+{
+    std::optional<glnet::PathStats> stats = client.getPathStats(0);
+
+    return stats ? stats->targetRate : 0;
+}
+
+// Impair the path, wait for the rate to fall to half of its value, then heal the path and wait for the rate to double from its lowest
+static bool checkReaction(glnet::Manager& client, const std::string& name, glnet::Impairment impairment)
+{
+    std::uint64_t before = getRate(client);
+    std::uint64_t lowest = before;
+    bool dropped = false;
+    bool recovered = false;
+
+    client.setDefaultImpairment(Type::UDP, Direction::OUTBOUND, impairment);
+    dropped = test::waitFor([&] {
+        lowest = std::min(lowest, getRate(client));
+        return lowest * 2 <= before;
+    }, REACTION);
+    client.clearImpairments(Type::UDP);
+    if (dropped) {
+        recovered = test::waitFor([&] {
+            std::uint64_t rate = getRate(client);
+
+            lowest = std::min(lowest, rate);
+            return rate >= lowest * 2;
+        }, REACTION);
+    }
+    std::cout << name << ": " << before << " B/s before, " << lowest << " B/s at the lowest, " << getRate(client) << " B/s after" << std::endl;
+    return test::check(dropped, "the rate drops under " + name) && test::check(recovered, "the rate recovers once the " + name + " is gone");
+}
+
+int main()
+{
+    glnet::Manager server;
+    glnet::Manager client;
+    std::atomic<bool> streaming = true;
+
+    if (!test::check(test::connectPair(server, client, PORT), "the client connects")) {
+        return EXIT_FAILURE;
+    }
+    client.setAdaptiveRate(true);
+    // The stream uses the whole target rate, the only way for the rate to grow
+    std::thread producer([&client, &streaming] {
+        std::string payload(MESSAGE_SIZE, 'x');
+
+        while (streaming) {
+            glnet::Packet packet;
+
+            packet << payload;
+            if (client.sendToServer(Type::UDP, packet, {.delivery = Delivery::RELIABLE_ORDERED}) == SendResult::FAILED) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    });
+    std::this_thread::sleep_for(SETTLE);
+    bool passed = test::check(getRate(client) != 0, "the path is measured");
+
+    passed = passed && checkReaction(client, "loss", {.loss = LOSS});
+    std::this_thread::sleep_for(SETTLE);
+    passed = passed && checkReaction(client, "latency", {.latency = LATENCY});
+    streaming = false;
+    producer.join();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
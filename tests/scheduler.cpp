@@ -0,0 +1,88 @@
+#include "Protocol/Scheduler.hpp"
+#include "Harness.hpp"
+
+#include <cstdlib>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <array>
+
+using glnet::connection::Priority;
+using glnet::Scheduler;
+
+static constexpr Scheduler::Clock::time_point NOW = Scheduler::Clock::time_point{} + std::chrono::seconds(1); // The time the frames are popped at
+static constexpr std::size_t FRAME_SIZE = 100;                                                                // The size of every frame, a divisor of the quantum so each round is exact
+static constexpr std::size_t ROUNDS = 10;                                                                     // The number of full rounds popped when the classes are measured
+static constexpr std::size_t BACKLOG = 3000;                                                                  // The number of frames queued in each class, more than any class writes in ROUNDS
+
+// A frame of FRAME_SIZE bytes for a client, in a class, with an optional deadline
+static glnet::Outbound makeFrame(std::uint32_t clientId, Priority priority, Scheduler::Clock::time_point deadline = {})
+{
+    return {.clientId = clientId, .frame = std::make_shared<const std::vector<std::uint8_t>>(FRAME_SIZE), .priority = priority, .deadline = deadline};
+}
+
+// Every class of a backlogged connection gets its weight in bytes each round
+static bool checkShares()
+{
+    Scheduler scheduler;
+    glnet::RateLimiter limiter;
+    std::array<std::size_t, Scheduler::CLASS_COUNT> bytes = {0};
+    std::size_t round = 0;
+    glnet::Outbound outbound;
+
+    for (std::size_t i = 0; i < Scheduler::CLASS_COUNT; i++) {
+        round += Scheduler::WEIGHTS[i] * Scheduler::QUANTUM;
+        for (std::size_t frame = 0; frame < BACKLOG; frame++) {
+            scheduler.push(makeFrame(1, static_cast<Priority>(i)));
+        }
+    }
+    for (std::size_t popped = 0; popped < ROUNDS * round / FRAME_SIZE; popped++) {
+        if (!test::check(scheduler.pop(NOW, limiter, outbound), "a backlogged connection always has a frame to pop")) {
+            return false;
+        }
+        bytes[static_cast<std::size_t>(outbound.priority)] += outbound.frame->size();
+    }
+    bool passed = true;
+
+    for (std::size_t i = 0; i < Scheduler::CLASS_COUNT; i++) {
+        std::size_t expected = ROUNDS * Scheduler::WEIGHTS[i] * Scheduler::QUANTUM;
+
+        passed &= test::check(bytes[i] == expected, "class " + std::to_string(i) + " writes " + std::to_string(expected) + " bytes, " + std::to_string(bytes[i]) + " written");
+    }
+    return passed;
+}
+
+// Realtime frames past their deadline are discarded and counted, the others are written in order
+static bool checkExpiry()
+{
+    Scheduler scheduler;
+    glnet::RateLimiter limiter;
+    std::vector<std::uint32_t> discarded;
+    std::vector<std::uint32_t> written;
+    glnet::Outbound outbound;
+
+    scheduler.setOnDiscard([&discarded](const glnet::Outbound& frame) { discarded.push_back(frame.clientId); });
+    scheduler.push(makeFrame(1, Priority::REALTIME, NOW - std::chrono::milliseconds(1)));
+    scheduler.push(makeFrame(2, Priority::REALTIME, NOW + std::chrono::milliseconds(1)));
+    scheduler.push(makeFrame(3, Priority::REALTIME));
+    scheduler.push(makeFrame(4, Priority::REALTIME, NOW - std::chrono::milliseconds(500)));
+    scheduler.push(makeFrame(4, Priority::CONTROL, NOW - std::chrono::milliseconds(500)));
+    scheduler.push(makeFrame(4, Priority::REALTIME, NOW));
+    while (scheduler.pop(NOW, limiter, outbound)) {
+        written.push_back(outbound.clientId);
+    }
+    bool passed = test::check(discarded == std::vector<std::uint32_t>{1, 4, 4}, "the frames past their deadline are discarded");
+
+    passed &= test::check(written == std::vector<std::uint32_t>{2, 3, 4}, "the frames within their deadline or without one are written");
+    passed &= test::check(scheduler.getExpiredCount() == 3 && scheduler.empty(), "the expired frames are counted and none is left");
+    return passed;
+}
+
+int main()
+{
+    bool passed = checkShares();
+
+    passed &= checkExpiry();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
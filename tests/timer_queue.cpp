@@ -0,0 +1,69 @@
+#include "Utils/TimerQueue.hpp"
+#include "Harness.hpp"
+
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using glnet::utils::TimerQueue;
+
+static constexpr std::chrono::milliseconds PERIOD{50}; // The period of the tick under test
+static constexpr std::chrono::milliseconds STALL{175}; // The time the first run blocks the loop, three and a half periods
+static constexpr std::size_t RUNS = 4;                 // The number of runs recorded
+
+// Run the loop the way an I/O thread does, sleeping until the next deadline, until the tick ran enough times
+static void runLoop(TimerQueue& queue, const std::vector<glnet::Tick>& runs)
+{
+    while (runs.size() < RUNS) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(queue.getTimeout()));
+        queue.process();
+    }
+}
+
+// Every run is due a whole number of periods after the previous one, and its index, lateness and overruns account for the periods skipped
+static bool checkRuns(const std::vector<glnet::Tick>& runs)
+{
+    bool passed = true;
+    std::uint64_t overruns = 0;
+
+    for (std::size_t i = 0; i < runs.size(); i++) {
+        const glnet::Tick& run = runs[i];
+        std::string name = "run " + std::to_string(i);
+
+        overruns += run.missed;
+        passed &= test::check(run.lateness >= std::chrono::nanoseconds(0) && run.lateness < PERIOD, name + " starts less than a period after its due time");
+        passed &= test::check(run.overruns == overruns, name + " counts every period skipped so far");
+        if (i == 0) {
+            passed &= test::check(run.index == run.missed + 1, name + " counts the periods since the tick was added");
+            continue;
+        }
+        const glnet::Tick& previous = runs[i - 1];
+
+        passed &= test::check(run.index == previous.index + run.missed + 1, name + " counts the periods skipped in its index");
+        passed &= test::check(run.scheduled - previous.scheduled == PERIOD * static_cast<std::int64_t>(run.index - previous.index), name + " is due a whole number of periods after the previous one");
+    }
+    return passed;
+}
+
+int main()
+{
+    TimerQueue queue;
+    std::vector<glnet::Tick> runs;
+    TimerQueue::Id id = queue.addTick(PERIOD, [&runs](const glnet::Tick& tick) {
+        runs.push_back(tick);
+        if (runs.size() == 1) {
+            std::this_thread::sleep_for(STALL);
+        }
+    });
+
+    runLoop(queue, runs);
+    bool passed = checkRuns(runs);
+
+    // The second run is due a period after the first one, which held the loop for STALL
+    passed &= test::check(runs[1].missed >= static_cast<std::uint64_t>((STALL - PERIOD) / PERIOD), "the periods of the stall are skipped, " + std::to_string(runs[1].missed) + " skipped");
+    passed &= test::check(queue.cancel(id), "a pending tick is cancelled");
+    passed &= test::check(!queue.cancel(id), "a tick is cancelled once");
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,98 @@
+#include "Utils/TimingWheel.hpp"
+#include "Harness.hpp"
+
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+
+using glnet::utils::TimingWheel;
+
+static constexpr TimingWheel::Clock::time_point ORIGIN{}; // The time of tick 0
+static constexpr std::chrono::milliseconds RESOLUTION{1}; // The duration of a tick of the wheels under test
+static constexpr std::uint64_t CASCADED = 300;            // A tick past the first wheel, armed in the second one and cascaded at tick 256
+static constexpr std::uint64_t DEEP = 70000;              // A tick past the second wheel, cascaded twice before it expires
+
+// The time of a tick
+static TimingWheel::Clock::time_point at(std::uint64_t tick)
+{
+    return ORIGIN + RESOLUTION * static_cast<std::int64_t>(tick);
+}
+
+// Advance the wheel to a tick and count the timers it expires
+static std::size_t advanceTo(TimingWheel& wheel, std::uint64_t tick)
+{
+    std::vector<TimingWheel::Timer *> expired;
+
+    wheel.advance(at(tick), expired);
+    return expired.size();
+}
+
+// A timer armed in an upper wheel expires at its own tick, neither when it is cascaded nor one tick late
+static bool checkCascade()
+{
+    TimingWheel wheel(RESOLUTION, ORIGIN);
+    TimingWheel::Timer near;
+    TimingWheel::Timer deep;
+    bool passed = true;
+
+    wheel.schedule(near, at(CASCADED));
+    wheel.schedule(deep, at(DEEP));
+    passed &= test::check(advanceTo(wheel, 256) == 0, "no timer expires when the second wheel cascades");
+    passed &= test::check(advanceTo(wheel, CASCADED - 1) == 0, "a cascaded timer does not expire early");
+    passed &= test::check(advanceTo(wheel, CASCADED) == 1 && !TimingWheel::isArmed(near), "a cascaded timer expires at its tick");
+    passed &= test::check(advanceTo(wheel, 65536) == 0, "no timer expires when the third wheel cascades");
+    passed &= test::check(advanceTo(wheel, DEEP - 1) == 0, "a timer cascaded twice does not expire early");
+    passed &= test::check(advanceTo(wheel, DEEP) == 1 && !TimingWheel::isArmed(deep), "a timer cascaded twice expires at its tick");
+    return passed;
+}
+
+// Arming an armed timer moves it, a cancelled timer never expires
+static bool checkRearmAndCancel()
+{
+    TimingWheel wheel(RESOLUTION, ORIGIN);
+    TimingWheel::Timer moved;
+    TimingWheel::Timer cancelled;
+    bool passed = true;
+
+    wheel.schedule(moved, at(10));
+    wheel.schedule(moved, at(20));
+    wheel.schedule(cancelled, at(15));
+    wheel.cancel(cancelled);
+    wheel.cancel(cancelled);
+    passed &= test::check(!TimingWheel::isArmed(cancelled), "a cancelled timer is disarmed");
+    passed &= test::check(advanceTo(wheel, 19) == 0, "a re-armed timer does not expire at its former tick");
+    passed &= test::check(advanceTo(wheel, 20) == 1, "a re-armed timer expires once, at its new tick");
+    passed &= test::check(wheel.getNextDeadline() == TimingWheel::Clock::time_point::max(), "a wheel without armed timer has no deadline");
+    return passed;
+}
+
+// The next deadline stops at the first armed slot or at the next cascade, and deadlines out of range are clamped
+static bool checkDeadlines()
+{
+    TimingWheel wheel(RESOLUTION, ORIGIN);
+    TimingWheel::Timer timer;
+    TimingWheel::Timer past;
+    TimingWheel::Timer far;
+    bool passed = true;
+
+    wheel.schedule(timer, at(5) - std::chrono::microseconds(1));
+    passed &= test::check(wheel.getNextDeadline() == at(5), "a deadline is rounded up to the next tick");
+    wheel.schedule(timer, at(CASCADED));
+    passed &= test::check(wheel.getNextDeadline() == at(256), "a timer of an upper wheel is due at its cascade");
+    advanceTo(wheel, 100);
+    wheel.schedule(past, at(50));
+    passed &= test::check(past.expiry == 101 && wheel.getNextDeadline() == at(101), "a deadline in the past is clamped to the next tick");
+    wheel.schedule(far, ORIGIN + std::chrono::hours(24 * 365));
+    passed &= test::check(far.expiry == 100 + TimingWheel::MAX_DELTA, "a deadline out of range is clamped to the farthest tick");
+    passed &= test::check(advanceTo(wheel, 101) == 1, "a clamped timer still expires");
+    return passed;
+}
+
+int main()
+{
+    bool passed = checkCascade();
+
+    passed &= checkRearmAndCancel();
+    passed &= checkDeadlines();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,83 @@
+#include "Data/Packet.hpp"
+#include "Manager.hpp"
+#include "Harness.hpp"
+
+#include <iostream>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using glnet::connection::Delivery;
+using glnet::connection::SendResult;
+using glnet::connection::Type;
+
+static constexpr std::uint16_t PORT = 9900;    // The port of the server, for both transports
+static constexpr std::uint32_t MESSAGES = 400; // The number of reliable messages sent to the server
+static constexpr double CLIENT_LOSS = 0.2;     // The fraction of the datagrams of the client dropped
+static constexpr double SERVER_LOSS = 0.1;     // The fraction of the datagrams of the server dropped, its acknowledgements included
+
+// Most messages fit in a datagram, every twentieth one is split into 17 or 50 fragments
+static std::string makePayload(std::uint32_t index)
+{
+    std::size_t size = index % 40 == 10 ? 20000 : index % 40 == 30 ? 60000 : 32;
+    std::string payload(size, '\0');
+
+    for (std::size_t i = 0; i < size; i++) {
+        payload[i] = static_cast<char>((index * 31 + i) & 0xFF);
+    }
+    return payload;
+}
+
+int main()
+{
+    glnet::Manager server;
+    glnet::Manager client;
+    std::atomic<std::uint32_t> received = 0;
+    std::atomic<std::uint32_t> misordered = 0;
+    std::atomic<std::uint32_t> corrupted = 0;
+
+    server.callbacks().setOnMessageReception([&](Type type, std::uint32_t, glnet::Packet& packet) {
+        std::uint32_t index = 0;
+        std::string payload;
+
+        if (type != Type::UDP) {
+            return;
+        }
+        packet >> index >> payload;
+        if (index != received) {
+            ++misordered;
+        }
+        if (payload != makePayload(index)) {
+            ++corrupted;
+        }
+        ++received;
+    });
+    if (!test::check(test::connectPair(server, client, PORT), "the client connects")) {
+        return EXIT_FAILURE;
+    }
+    client.setSimulatedLoss(CLIENT_LOSS);
+    server.setSimulatedLoss(SERVER_LOSS);
+    for (std::uint32_t index = 0; index < MESSAGES; index++) {
+        glnet::Packet packet;
+
+        packet << index << makePayload(index);
+        if (!test::check(client.sendToServer(Type::UDP, packet, {.delivery = Delivery::RELIABLE_ORDERED}) == SendResult::QUEUED, "every message is queued")) {
+            return EXIT_FAILURE;
+        }
+    }
+    bool delivered = test::waitFor([&received] { return received.load() >= MESSAGES; }, std::chrono::seconds(60));
+
+    // A retransmission delivered twice would show up after the last message
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    bool passed = test::check(client.getImpairmentCounters(Type::UDP).dropped != 0, "the client drops datagrams");
+
+    passed &= test::check(delivered, "every message is delivered, " + std::to_string(received) + " of " + std::to_string(MESSAGES));
+    passed &= test::check(received == MESSAGES, "no message is delivered twice");
+    passed &= test::check(misordered == 0, "the messages are delivered in order");
+    passed &= test::check(corrupted == 0, "the fragmented messages are reassembled intact");
+    client.clearImpairments(Type::UDP);
+    server.clearImpairments(Type::UDP);
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}